@@ -0,0 +1,122 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_ARRAY_H_
+#define SRC_ARRAY_H_
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "./mapped-file.h"
+
+namespace base {
+
+// Contiguous array of plain data elements, which either owns its storage or
+// references a region of a shared memory-mapped file. Referenced regions are
+// used in place and are read-only.
+template<typename T>
+class Array {
+ public:
+  Array()
+      : data_(NULL),
+        size_(0) {}
+
+  Array(const size_t size, const T& value)
+      : owned_(size, value) {
+    Sync();
+  }
+
+  // Takes over the elements of given vector by swapping them.
+  explicit Array(std::vector<T>* elements) {
+    assert(elements);
+    owned_.swap(*elements);
+    Sync();
+  }
+
+  // References size elements at given byte offset within the mapped file.
+  Array(const std::shared_ptr<const MappedFile>& file, const size_t offset,
+        const size_t size)
+      : file_(file),
+        data_(reinterpret_cast<const T*>(file->data() + offset)),
+        size_(size) {
+    assert(offset % sizeof(T) == 0);
+    assert(offset + size * sizeof(T) <= file->size());
+  }
+
+  Array(const Array& other)
+      : owned_(other.owned_),
+        file_(other.file_),
+        data_(other.data_),
+        size_(other.size_) {
+    if (!file_) {
+      Sync();
+    }
+  }
+
+  Array(Array&& other)
+      : file_(std::move(other.file_)),
+        data_(other.data_),
+        size_(other.size_) {
+    owned_.swap(other.owned_);
+    other.Sync();
+  }
+
+  Array& operator=(Array other) {
+    owned_.swap(other.owned_);
+    file_.swap(other.file_);
+    data_ = other.data_;
+    size_ = other.size_;
+    if (!file_) {
+      Sync();
+    }
+    return *this;
+  }
+
+  const T& operator[](const size_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  T& operator[](const size_t index) {
+    assert(!file_ && index < size_);
+    return owned_[index];
+  }
+
+  // Resizes the owned storage, referenced regions can not be resized.
+  void resize(const size_t size, const T& value) {
+    assert(!file_);
+    owned_.resize(size, value);
+    Sync();
+  }
+
+  const T* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  // Returns true if the elements reside in a memory-mapped file.
+  bool mapped() const {
+    return static_cast<bool>(file_);
+  }
+
+ private:
+  // Points the data to the owned storage.
+  void Sync() {
+    data_ = owned_.empty() ? NULL : &owned_[0];
+    size_ = owned_.size();
+  }
+
+  std::vector<T> owned_;
+  std::shared_ptr<const MappedFile> file_;
+  const T* data_;
+  size_t size_;
+};
+
+}  // namespace base
+#endif  // SRC_ARRAY_H_
@@ -1,17 +1,23 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include <gflags/gflags.h>
 #include <cassert>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <limits>
 #include "./clock.h"
 #include "./profiler.h"
+#include "./mapped-file.h"
 #include "./parser.h"
 #include "./game.h"
 #include "./game-factory.h"
+#include "./binary-game.h"
 #include "./lcp.h"
 #include "./lcp-factory.h"
 #include "./equilibria-finder.h"
+#include "./game-reducer.h"
+#include "./polymatrix-game.h"
+#include "./polymatrix-reader.h"
 
 using std::cout;
 using std::string;
@@ -21,13 +27,17 @@ using base::Clock;
 using base::Profiler;
 using ash::parse::Parser;
 using ash::parse::StrategicGame;
+using ash::parse::PolymatrixReader;
 using ash::Game;
 using ash::GameFactory;
+using ash::BinaryGame;
 using ash::Lcp;
 using ash::LcpFactory;
 using ash::EquilibriaFinder;
+using ash::GameReducer;
 using ash::StrategyProfile;
 using ash::MixedStrategyProfile;
+using ash::PolymatrixGame;
 
 // Command-line flag for verbose output.
 DEFINE_bool(verbose, false, "Verbose output");
@@ -38,73 +48,290 @@ DEFINE_bool(mixed, true, "Find mixed (and pure) strategies Nash equilibria");
 // Command-line flag for max number of equilibira to be searched for.
 DEFINE_int32(maxequilibria, numeric_limits<int>::max(),
              "Maximum number of equilibira to be found (min 1)");
+// Command-line flag for memory-mapped input parsing.
+DEFINE_bool(mmap, true, "Parse the input file memory-mapped in a single pass");
+// Command-line flag for the flattened payoff layout.
+DEFINE_bool(tensor, true,
+            "Flatten outcome payoffs into a dense payoff array per player");
+// Command-line flag for the bit-packed payoff layout.
+DEFINE_bool(packed, false,
+            "Store bit-packed outcome ids instead of the flattened payoffs,"
+            " for many-player games with few distinct outcomes");
+// Command-line flag for the number of threads.
+DEFINE_int32(threads, 1,
+             "Number of threads for the pure equilibria search and the"
+             " support enumeration of the two-player mixed equilibria search");
+// Command-line flag for the dominance reduction.
+DEFINE_bool(reduce, false,
+            "Eliminate iterated strictly dominated strategies before the"
+            " search, dominance by mixed strategies is checked via LP");
+// Command-line flags for the support enumeration of the mixed search.
+DEFINE_bool(pns, false,
+            "Enumerate the supports by increasing size and balance and skip"
+            " conditionally dominated supports (Porter, Nudelman, Shoham),"
+            " finds the first equilibrium early, always on for three or more"
+            " players");
+DEFINE_int32(min_support, 1, "Minimum support size per player (min 1)");
+DEFINE_int32(max_support, 32, "Maximum support size per player");
+// Command-line flag for the Lemke-Howson mixed search.
+DEFINE_bool(lemke_howson, false,
+            "Find the mixed equilibria of two-player games on the"
+            " Lemke-Howson paths of all missing labels, a subset of all"
+            " equilibria in few exact pivots");
+// Command-line flag for the vertex enumeration mixed search.
+DEFINE_bool(vertex_enumeration, false,
+            "Find all extreme mixed equilibria of two-player games on the"
+            " vertices of the best response polytopes in exact arithmetic"
+            " and group them into maximal cliques");
+// Command-line flag for the symmetric mixed search.
+DEFINE_bool(symmetric_mixed, false,
+            "Find only the symmetric mixed equilibria of symmetric games of"
+            " three or more players, with the count vector solver");
+// Command-line flag for the out-of-core payoff storage.
+DEFINE_string(payoff_file, "",
+              "Scratch file to hold the flattened payoffs instead of memory,"
+              " for games larger than memory");
+
+// The converter subcommand.
+const string kConvert = "convert";  // NOLINT
 
 // The command-line usage text.
 const string kUsage =  // NOLINT
   string("Usage:\n") +
          "  $ ash input.nfg\n" +
          "  input.nfg is a strategic game instance" +
-         " in the Gambit outcome format";
+         " in the Gambit outcome or payoff format\n" +
+         "  or in the binary game format or a polymatrix game instance\n" +
+         "  in the polymatrix format (see README),\n" +
+         "  use - as input to read it from standard input.\n" +
+         "  $ ash " + kConvert + " input.nfg output.ash\n" +
+         "  converts the strategic game instance into the binary game format";
 
-void FindPureEquilibria(EquilibriaFinder* finder);
-void FindMixedEquilibria(EquilibriaFinder* finder);
+bool LoadGame(const string& input_path, Game* game);
+bool LayoutPayoffs(Game* game);
+int ConvertGame(const string& input_path, const string& output_path);
+int SolvePolymatrixGame(const base::MappedFile& file,
+                        const string& input_path);
+void FindPureEquilibria(const GameReducer& reducer, EquilibriaFinder* finder);
+void FindMixedEquilibria(const GameReducer& reducer,
+                         EquilibriaFinder* finder);
 
 int main(int argc, char* argv[]) {
   google::SetUsageMessage(kUsage);
   // Parse command line flags and remove them from the argc and argv.
   google::ParseCommandLineFlags(&argc, &argv, true);
-  if (argc != 2) {
+  if (argc == 4 && argv[1] == kConvert) {
+    return ConvertGame(argv[2], argv[3]);
+  } else if (argc != 2) {
     cout << "Wrong argument number provided, use -help for help.\n"
          << kUsage << "\n";
     return 1;
-  } else if (!Parser::FileSize(argv[1])) {
-    cout << "File " << argv[1] << " is empty or does not exist.\n";
-    return 1;
   } else if (FLAGS_verbose && FLAGS_brief) {
     cout << "Mutually exclusive flags selected (brief and verbose).\n";
     return 1;
+  } else if (FLAGS_threads < 1) {
+    cout << "Number of threads must be positive.\n";
+    return 1;
+  } else if (FLAGS_min_support < 1 || FLAGS_max_support < FLAGS_min_support) {
+    cout << "Support sizes must be positive and ordered.\n";
+    return 1;
   }
 
   const string input_path = argv[1];
-  Parser parser(input_path);
+  if (input_path != Parser::kStdin) {
+    base::MappedFile file(input_path);
+    if (file.good() && PolymatrixReader::Detect(file.data(), file.end())) {
+      return SolvePolymatrixGame(file, input_path);
+    }
+  }
+  Game game("");
+  if (!LoadGame(input_path, &game)) {
+    return 1;
+  }
+  GameReducer reducer(game);
+  Game reduced("");
+  if (FLAGS_reduce) {
+    reducer.mixed(true);
+    const int num_eliminated = reducer.Reduce();
+    reduced = reducer.ReducedGame();
+    cout << "Eliminated " << num_eliminated
+         << " strictly dominated strategies.";
+    cout << "\nDuration: " << Clock::DiffStr(reducer.duration()) << "\n";
+  }
+  EquilibriaFinder finder(FLAGS_reduce ? reduced : game);
+  finder.num_threads(FLAGS_threads);
+  finder.pns(FLAGS_pns);
+  finder.lemke_howson(FLAGS_lemke_howson);
+  finder.vertex_enumeration(FLAGS_vertex_enumeration);
+  finder.symmetric_mixed(FLAGS_symmetric_mixed);
+  finder.support_sizes(FLAGS_min_support, FLAGS_max_support);
+  FindPureEquilibria(reducer, &finder);
+  if (FLAGS_mixed) {
+    FindMixedEquilibria(reducer, &finder);
+  } else {
+  }
+  return 0;
+}
+
+bool LoadGame(const string& input_path, Game* game) {
+  if (input_path != Parser::kStdin && !Parser::FileSize(input_path)) {
+    cout << "File " << input_path << " is empty or does not exist.\n";
+    return false;
+  }
+  if (input_path != Parser::kStdin && BinaryGame::Detect(input_path)) {
+    BinaryGame binary_game(input_path);
+    *game = binary_game.Load();
+    if (binary_game.error().size()) {
+      cout << "File " << input_path << " is malformed: "
+           << binary_game.error() << ".\n";
+      return false;
+    }
+    cout << "File: " << input_path << "\n";
+    return LayoutPayoffs(game);
+  }
+  Parser::Mode mode = FLAGS_mmap ? Parser::kMapped : Parser::kBuffered;
+  if (input_path == Parser::kStdin) {
+    mode = Parser::kStream;
+  }
+  Parser parser(input_path, mode);
   StrategicGame parsed_game = parser.ParseStrategicGame();
+  if (parser.error().size()) {
+    cout << "File " << input_path << " is malformed: " << parser.error()
+         << ".\n";
+    return false;
+  }
   cout << "File: " << input_path << "\n";
   if (FLAGS_verbose) {
     cout << parsed_game.Str();
   }
-  Game game = GameFactory::Create(parsed_game);
-  EquilibriaFinder finder(game);
-  FindPureEquilibria(&finder);
-  if (FLAGS_mixed) {
-    FindMixedEquilibria(&finder);
-  } else {
+  GameFactory::Layout layout = GameFactory::kOutcomes;
+  if (FLAGS_packed) {
+    layout = GameFactory::kPacked;
+  } else if (FLAGS_tensor && FLAGS_payoff_file.empty()) {
+    layout = GameFactory::kTensor;
+  }
+  *game = GameFactory::Create(&parsed_game, layout);
+  return LayoutPayoffs(game);
+}
+
+bool LayoutPayoffs(Game* game) {
+  if (game->dense() || game->packed()) {
+    return true;
+  }
+  if (FLAGS_packed) {
+    game->PackPayoffs();
+    return true;
+  }
+  if (!FLAGS_tensor) {
+    return true;
   }
+  if (FLAGS_payoff_file.empty()) {
+    game->FlattenPayoffs();
+  } else if (!game->FlattenPayoffs(FLAGS_payoff_file)) {
+    cout << "File " << FLAGS_payoff_file << " could not be mapped.\n";
+    return false;
+  }
+  return true;
+}
+
+int ConvertGame(const string& input_path, const string& output_path) {
+  // The binary format stores the outcome ids, flattening is not needed.
+  FLAGS_tensor = false;
+  FLAGS_packed = false;
+  Game game("");
+  if (!LoadGame(input_path, &game)) {
+    return 1;
+  }
+  if (!BinaryGame::Write(game, output_path)) {
+    cout << "File " << output_path << " could not be written.\n";
+    return 1;
+  }
+  cout << "Converted to binary game " << output_path << ".\n";
   return 0;
 }
 
-void FindPureEquilibria(EquilibriaFinder* finder) {
-  finder->max_num_equilibria(FLAGS_maxequilibria);
-  const int num_eq = finder->FindPure();
-  const vector<StrategyProfile>& eqs = finder->equilibria();
+int SolvePolymatrixGame(const base::MappedFile& file,
+                        const string& input_path) {
+  PolymatrixGame game("");
+  PolymatrixReader reader(&game);
+  if (!reader.Read(file.data(), file.end())) {
+    cout << "File " << input_path << " is malformed: " << reader.error()
+         << ".\n";
+    return 1;
+  }
+  cout << "File: " << input_path << "\n";
+  Clock beg;
+  vector<StrategyProfile> eqs;
+  const int num_eq = game.FindPure(FLAGS_maxequilibria, &eqs);
   cout << "Found " << num_eq << " pure strategy Nash equilibria.";
   if (!FLAGS_brief) {
     for (auto it = eqs.begin(); it != eqs.end(); ++it) {
-      const StrategyProfile& profile = *it;
-      cout << "\n" << profile.str(finder->game());
+      cout << "\n" << game.str(*it);
+    }
+  }
+  cout << "\nDuration: " << Clock::DiffStr(Clock() - beg) << "\n";
+  if (FLAGS_mixed) {
+    beg = Clock();
+    MixedStrategyProfile eq(0);
+    const bool found = game.FindMixed(&eq);
+    cout << "Found " << found << " mixed strategies Nash equilibria.";
+    if (found && !FLAGS_brief) {
+      cout << "\n" << game.str(eq);
     }
+    cout << "\nDuration: " << Clock::DiffStr(Clock() - beg) << "\n";
+  }
+  return 0;
+}
+
+void FindPureEquilibria(const GameReducer& reducer, EquilibriaFinder* finder) {
+  finder->max_num_equilibria(FLAGS_maxequilibria);
+  // The equilibria are printed as they are found, brief output only counts
+  // them without keeping any profiles.
+  int64_t num_eq = 0;
+  if (FLAGS_brief) {
+    num_eq = finder->CountPure();
+  } else {
+    num_eq = finder->FindPure([&reducer](const StrategyProfile& profile) {
+      cout << reducer.Expand(profile).str(reducer.game()) << "\n";
+      return true;
+    });
   }
+  cout << "Found " << num_eq << " pure strategy Nash equilibria.";
   cout << "\nDuration: " << Clock::DiffStr(finder->duration()) << "\n";
 }
 
-void FindMixedEquilibria(EquilibriaFinder* finder) {
+void FindMixedEquilibria(const GameReducer& reducer,
+                         EquilibriaFinder* finder) {
   finder->max_num_equilibria(FLAGS_maxequilibria);
-  const int num_eq = finder->FindMixed();
-  const vector<MixedStrategyProfile>& eqs = finder->mixed_equilibria();
+  int64_t num_eq = 0;
+  if (FLAGS_brief) {
+    num_eq = finder->FindMixed(ash::MixedVisitor());
+  } else {
+    num_eq = finder->FindMixed([&reducer](const MixedStrategyProfile& p) {
+      cout << reducer.Expand(p).str(reducer.game()) << "\n";
+      return true;
+    });
+  }
   cout << "Found " << num_eq << " mixed strategies Nash equilibria.";
-  if (!FLAGS_brief) {
-    for (auto it = eqs.begin(); it != eqs.end(); ++it) {
-      const MixedStrategyProfile& profile = *it;
-      cout << "\n" << profile.str(finder->game());
+  const vector<ash::VertexEnumerator::Clique>& cliques = finder->cliques();
+  if (cliques.size()) {
+    int num_components = 0;
+    for (auto it = cliques.begin(); it != cliques.end(); ++it) {
+      num_components = std::max(num_components, it->component + 1);
+    }
+    cout << "\nFound " << cliques.size() << " maximal cliques in "
+         << num_components << " components.";
+    if (!FLAGS_brief) {
+      // The equilibria are numbered from 1 in the printed order.
+      for (auto it = cliques.begin(); it != cliques.end(); ++it) {
+        cout << "\n(clique " << it - cliques.begin() + 1 << " (component "
+             << it->component + 1 << ")";
+        for (auto jt = it->equilibria.begin(); jt != it->equilibria.end();
+             ++jt) {
+          cout << " " << *jt + 1;
+        }
+        cout << ")";
+      }
     }
   }
   cout << "\nLCP-creation duration: " << Clock::DiffStr(finder->lcp_duration());
@@ -0,0 +1,84 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../best-response-table.h"
+#include "../clock.h"
+#include "../game.h"
+#include "../simd-kernels.h"
+
+using std::cout;
+using std::vector;
+using base::Clock;
+using ash::BestResponseTable;
+using ash::Game;
+using ash::Player;
+using ash::StrategyProfile;
+
+namespace simd = ash::simd;
+
+DEFINE_bool(verbose, false, "Verbose output");
+DEFINE_int32(runs, 100, "Number of runs per game and instruction set");
+DEFINE_int32(range, 100, "Range of the random payoffs");
+
+// Returns a random game with given number of players and strategies each.
+Game CreateGame(const int num_players, const int num_strategies) {
+  Game game("random");
+  for (int p = 0; p < num_players; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(num_players,
+                               vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = rand() % FLAGS_range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Builds the table and searches all pure equilibria with the kernels of given
+// level, returns the average durations of both in µs.
+void Run(const Game& game, const simd::Level level, double* build,
+         double* search, size_t* num_equilibria) {
+  simd::SetLevel(level);
+  *build = 0.0;
+  *search = 0.0;
+  for (int r = 0; r < FLAGS_runs; ++r) {
+    Clock beg(Clock::kRealMonotonic);
+    const BestResponseTable table(game, 1);
+    Clock mid(Clock::kRealMonotonic);
+    vector<StrategyProfile> equilibria;
+    *num_equilibria = table.FindPure(game.num_strategy_profiles(), 1,
+                                     &equilibria);
+    *build += double(mid - beg) / FLAGS_runs;
+    *search += double(Clock(Clock::kRealMonotonic) - mid) / FLAGS_runs;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  srand(42);
+  // About 64K profiles per game, which keeps the payoffs in the L2 cache.
+  const int dims[][2] = {{2, 256}, {3, 40}, {6, 6}};
+  const simd::Level levels[] = {simd::kScalar, simd::SupportedLevel()};
+  for (int d = 0; d < 3; ++d) {
+    const Game game = CreateGame(dims[d][0], dims[d][1]);
+    for (int l = 0; l < 2; ++l) {
+      double build = 0.0;
+      double search = 0.0;
+      size_t num_eq = 0;
+      Run(game, levels[l], &build, &search, &num_eq);
+      cout << dims[d][0] << " players x " << dims[d][1] << " strategies "
+           << simd::LevelName(levels[l]) << ": build " << build
+           << "µs, search " << search << "µs (" << num_eq << " equilibria)\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../clock.h"
+#include "../equilibria-finder.h"
+#include "../game.h"
+
+using std::cout;
+using std::string;
+using std::vector;
+using base::Clock;
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::Player;
+
+DEFINE_bool(verbose, false, "Verbose output");
+DEFINE_int32(games, 1000, "Number of random games per dimension");
+DEFINE_int32(generic_games, 5,
+             "Number of random games per dimension for the generic solvers");
+DEFINE_int32(generic_size, 4, "Maximum dimension for the generic solvers");
+DEFINE_int32(threads, 1, "Number of threads for the generic solvers");
+
+// Returns a random n x m game without outcomes.
+Game CreateGame(const int n, const int m) {
+  Game game("random");
+  const int dims[] = {n, m};
+  for (int p = 0; p < 2; ++p) {
+    Player player("p");
+    for (int s = 0; s < dims[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(2, vector<int>(n * m));
+  for (int p = 0; p < 2; ++p) {
+    for (int sp = 0; sp < n * m; ++sp) {
+      payoffs[p][sp] = rand() % 100;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Solves the games and returns the average duration per game.
+double Solve(const vector<Game>& games, const bool specialized,
+             size_t* num_equilibria) {
+  Clock beg(Clock::kRealMonotonic);
+  for (auto it = games.begin(), end = games.end(); it != end; ++it) {
+    EquilibriaFinder finder(*it);
+    finder.specialized(specialized);
+    finder.num_threads(FLAGS_threads);
+    *num_equilibria += finder.FindPure();
+    *num_equilibria += finder.FindMixed();
+  }
+  return double(Clock(Clock::kRealMonotonic) - beg) / games.size();
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  srand(42);
+  for (int n = 2; n <= 8; n += 2) {
+    vector<Game> games;
+    for (int i = 0; i < FLAGS_games; ++i) {
+      games.push_back(CreateGame(n, n));
+    }
+    size_t num_eq = 0;
+    const double specialized = Solve(games, true, &num_eq);
+    cout << n << "x" << n << " specialized: " << specialized << "µs/game ("
+         << num_eq << " equilibria)\n";
+    if (n > FLAGS_generic_size) {
+      continue;
+    }
+    games.resize(FLAGS_generic_games, Game(""));
+    num_eq = 0;
+    const double generic = Solve(games, false, &num_eq);
+    cout << n << "x" << n << " generic: " << generic << "µs/game ("
+         << num_eq << " equilibria)\n";
+  }
+  return 0;
+}
@@ -0,0 +1,90 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../clock.h"
+#include "../numeral-tokenizer.h"
+#include "../nfg-reader.h"
+#include "../parser.h"
+
+using std::cout;
+using std::string;
+using std::vector;
+using base::Clock;
+using ash::parse::NumeralTokenizer;
+using ash::parse::NfgReader;
+using ash::parse::Parser;
+using ash::parse::StrategicGame;
+
+DEFINE_bool(verbose, false, "Verbose output");
+DEFINE_int32(size, 256, "Size of the payoff section in MiB");
+DEFINE_int32(legacy_size, 8, "Size of the section for the legacy parser in MiB");
+
+// Returns a payoff section of given size with random outcome ids.
+string CreateSection(const size_t size) {
+  string section;
+  section.reserve(size + 16);
+  srand(42);
+  while (section.size() < size) {
+    section += std::to_string(rand() % 1000);
+    section.push_back(rand() % 8 ? ' ' : '\n');
+  }
+  return section;
+}
+
+void Report(const string& name, const size_t size, const Clock::Diff diff,
+            const size_t num_numerals) {
+  const double gb_per_sec = size / (diff * 1000.0);
+  cout << name << ": " << gb_per_sec << " GB/s (" << num_numerals
+       << " numerals in " << Clock::DiffStr(diff) << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  const string section = CreateSection(size_t(FLAGS_size) << 20);
+  const char* beg = section.data();
+  const char* end = beg + section.size();
+  cout << "Payoff section size: " << section.size() / (1 << 20) << "MiB\n";
+  {
+    const string legacy = section.substr(0, size_t(FLAGS_legacy_size) << 20);
+    vector<int> numerals;
+    Clock clock_beg(Clock::kRealMonotonic);
+    Parser::CollectNumerals(legacy, &numerals);
+    Report("legacy CollectNumerals", legacy.size(),
+           Clock(Clock::kRealMonotonic) - clock_beg, numerals.size());
+  }
+  {
+    // Sequential scan through the reader, wrapping the section into a game
+    // with a single player.
+    const string header = "NFG 1 R \"\" { \"p\" } { { \"s\" } } { } ";
+    const string game_str = header + section;
+    StrategicGame game;
+    NfgReader reader(&game);
+    reader.num_threads(1);
+    Clock clock_beg(Clock::kRealMonotonic);
+    reader.Feed(game_str.data(), game_str.data() + game_str.size(), false);
+    Report("sequential NfgReader", section.size(),
+           Clock(Clock::kRealMonotonic) - clock_beg,
+           game.payoff_indices.size());
+  }
+  {
+    size_t count = 0;
+    Clock clock_beg(Clock::kRealMonotonic);
+    NumeralTokenizer::Count(beg, end, &count);
+    Report("classifier count", section.size(),
+           Clock(Clock::kRealMonotonic) - clock_beg, count);
+  }
+  const int max_threads = std::thread::hardware_concurrency();
+  for (int t = 1; t <= max_threads; t *= 2) {
+    vector<int> numerals;
+    Clock clock_beg(Clock::kRealMonotonic);
+    NumeralTokenizer::ConvertParallel(beg, end, t, &numerals);
+    Report("parallel tokenizer (" + std::to_string(t) + " threads)",
+           section.size(), Clock(Clock::kRealMonotonic) - clock_beg,
+           numerals.size());
+  }
+  return 0;
+}
@@ -0,0 +1,317 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./best-response-table.h"
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "./parallel-for.h"
+#include "./simd-kernels.h"
+
+using std::vector;
+using std::max;
+using std::min;
+
+namespace ash {
+
+// Minimum number of profiles or sub-profiles per parallel task.
+static const int64_t kMinChunkSize = 1 << 14;
+// Number of profiles per block of the dense search, the block's mask stays in
+// the L1 cache.
+static const int64_t kBlockSize = 1 << 12;
+
+BestResponseTable::BestResponseTable(const Game& game, const int num_threads)
+    : game_(game),
+      sub_strides_(game.num_players()) {
+  assert(num_threads > 0);
+  const int num_players = game.num_players();
+  // Mapped and packed payoffs are kept out of memory, the table would pull
+  // them back in.
+  if (!game.mapped() && !game.packed()) {
+    best_payoffs_.resize(num_players);
+  }
+  for (int p = 0; p < num_players; ++p) {
+    const int num_strategies = game.num_strategies(p);
+    // The profiles of the players after p span whole blocks, their strides
+    // shrink by the number of strategies of p in the sub-profile ids.
+    sub_strides_[p].resize(num_players, 0);
+    for (int q = 0; q < num_players; ++q) {
+      sub_strides_[p][q] = q < p ? game.stride(q) :
+                           q > p ? game.stride(q) / num_strategies : 0;
+    }
+    if (best_payoffs_.empty()) {
+      continue;
+    }
+    const int64_t num_sub_profiles =
+        game.num_strategy_profiles() / num_strategies;
+    best_payoffs_[p].resize(num_sub_profiles);
+    const int64_t chunk = base::ChunkSize(num_sub_profiles, num_threads,
+                                          kMinChunkSize);
+    const int64_t num_chunks = (num_sub_profiles + chunk - 1) / chunk;
+    base::ParallelFor(num_chunks, num_threads, [&](const int64_t c) {
+      Build(p, c * chunk, min(num_sub_profiles, (c + 1) * chunk));
+    });
+  }
+}
+
+void BestResponseTable::Build(const int player_id, const int64_t beg,
+                              const int64_t end) {
+  const int64_t stride = game_.stride(player_id);
+  const int num_strategies = game_.num_strategies(player_id);
+  const int* dense = game_.dense() ? game_.payoffs(player_id) : NULL;
+  int* best = &best_payoffs_[player_id][0];
+  // Only the first block of the range may start with an offset.
+  int64_t offset = beg % stride;
+  for (int64_t sub = beg; sub < end;) {
+    // The sub-profiles of a block of p's stride axis, each strategy of p is a
+    // contiguous run of stride profiles in the block, the best responses are
+    // the element-wise maximum of the runs.
+    const int64_t size = min(stride - offset, end - sub);
+    const int64_t first = (sub - offset) * num_strategies + offset;
+    int* out = best + sub;
+    if (dense && stride == 1) {
+      // The strategies of p are contiguous, a maximum per sub-profile.
+      for (int64_t i = 0; i < size; ++i) {
+        out[i] = simd::Max(dense + (sub + i) * num_strategies, num_strategies);
+      }
+    } else if (dense) {
+      std::copy(dense + first, dense + first + size, out);
+      for (int s = 1; s < num_strategies; ++s) {
+        simd::MaxInto(dense + first + s * stride, size, out);
+      }
+    } else {
+      for (int64_t i = 0; i < size; ++i) {
+        out[i] = game_.payoff(first + i, player_id);
+      }
+      for (int s = 1; s < num_strategies; ++s) {
+        for (int64_t i = 0; i < size; ++i) {
+          out[i] = max(out[i], game_.payoff(first + s * stride + i,
+                                            player_id));
+        }
+      }
+    }
+    sub += size;
+    offset = 0;
+  }
+}
+
+int BestResponseTable::FindPure(const size_t max_num, const int num_threads,
+                                vector<StrategyProfile>* equilibria) const {
+  assert(equilibria);
+  return FindPure(max_num, num_threads,
+                  [equilibria](const StrategyProfile& profile) {
+                    equilibria->push_back(profile);
+                    return true;
+                  });
+}
+
+int64_t BestResponseTable::FindPure(const size_t max_num,
+                                    const int num_threads,
+                                    const PureVisitor& visitor) const {
+  assert(num_threads > 0);
+  const int64_t num_profiles = game_.num_strategy_profiles();
+  if (num_threads == 1) {
+    return FindPure(0, num_profiles, max_num, visitor);
+  }
+  const int64_t chunk = base::ChunkSize(num_profiles, num_threads,
+                                        kMinChunkSize);
+  const int64_t num_chunks = (num_profiles + chunk - 1) / chunk;
+  // The number of equilibria of a chunk and its equilibria with visitor.
+  typedef std::pair<int64_t, vector<StrategyProfile> > Result;
+  // The chunks are merged in order, once the merged ones hold enough
+  // equilibria no further chunks are searched. A chunk is never skipped for
+  // equilibria found in later chunks, which keeps the visited equilibria
+  // identical to the serial ones.
+  int64_t num_visited = 0;
+  auto search = [&](const int64_t c, Result* result) {
+    vector<StrategyProfile>* equilibria = &result->second;
+    result->first = FindPure(c * chunk, min(num_profiles, (c + 1) * chunk),
+                             max_num, !visitor ? PureVisitor() :
+                             [equilibria](const StrategyProfile& profile) {
+                               equilibria->push_back(profile);
+                               return true;
+                             });
+  };
+  auto merge = [&](Result* result) {
+    const int64_t num_visits = min<int64_t>(result->first,
+                                            max_num - num_visited);
+    if (!visitor) {
+      num_visited += num_visits;
+    }
+    for (int64_t e = 0; visitor && e < num_visits; ++e) {
+      ++num_visited;
+      if (!visitor(result->second[e])) {
+        return false;
+      }
+    }
+    return num_visited < static_cast<int64_t>(max_num);
+  };
+  base::OrderedParallelFor<Result>(num_chunks, num_threads, search, merge);
+  return num_visited;
+}
+
+int64_t BestResponseTable::FindPure(const int64_t beg, const int64_t end,
+                                    const size_t max_num,
+                                    const PureVisitor& visitor) const {
+  if (beg >= end || !max_num) {
+    return 0;
+  }
+  if (best_payoffs_.empty()) {
+    return FindPureScan(beg, end, max_num, visitor);
+  }
+  if (game_.dense()) {
+    return FindPureDense(beg, end, max_num, visitor);
+  }
+  const int num_players = game_.num_players();
+  int64_t num_found = 0;
+  StrategyProfile profile = game_.CreateProfile(beg);
+  // The sub-profile id of each player, updated along with the profile.
+  vector<int64_t> sub_ids(num_players);
+  for (int p = 0; p < num_players; ++p) {
+    sub_ids[p] = SubProfileId(profile, p);
+  }
+  for (int64_t sp = beg; sp < end; ++sp) {
+    bool equilibrium = true;
+    for (int p = 0; p < num_players && equilibrium; ++p) {
+      equilibrium = game_.payoff(sp, p) == best_payoffs_[p][sub_ids[p]];
+    }
+    if (equilibrium) {
+      ++num_found;
+      if ((visitor && !visitor(profile)) ||
+          num_found >= static_cast<int64_t>(max_num)) {
+        break;
+      }
+    }
+    // Odometer step, the sub-profile ids follow the change of each player's
+    // strategy.
+    for (int c = 0; c < num_players; ++c) {
+      const int s = profile[c];
+      const int delta = s + 1 < game_.num_strategies(c) ? 1 : -s;
+      profile.strategy(c, s + delta);
+      for (int p = 0; p < num_players; ++p) {
+        sub_ids[p] += delta * sub_strides_[p][c];
+      }
+      if (delta == 1) {
+        break;
+      }
+    }
+  }
+  return num_found;
+}
+
+int64_t BestResponseTable::FindPureScan(const int64_t beg, const int64_t end,
+                                        const size_t max_num,
+                                        const PureVisitor& visitor) const {
+  const int num_players = game_.num_players();
+  int64_t num_found = 0;
+  StrategyProfile profile = game_.CreateProfile(beg);
+  for (int64_t sp = beg; sp < end; ++sp) {
+    bool equilibrium = true;
+    for (int p = 0; p < num_players && equilibrium; ++p) {
+      const int payoff = game_.payoff(sp, p);
+      const int64_t stride = game_.stride(p);
+      const int num_strategies = game_.num_strategies(p);
+      // Step along the strategy axis of player p, starting at strategy 0.
+      int64_t deviation = sp - profile[p] * stride;
+      for (int s = 0; s < num_strategies && equilibrium;
+           ++s, deviation += stride) {
+        // Player p increases payoff by switching to strategy s, therefore
+        // the strategy profile is not a Nash equilibrium.
+        equilibrium = game_.payoff(deviation, p) <= payoff;
+      }
+    }
+    if (equilibrium) {
+      ++num_found;
+      if ((visitor && !visitor(profile)) ||
+          num_found >= static_cast<int64_t>(max_num)) {
+        break;
+      }
+    }
+    for (int c = 0; c < num_players; ++c) {
+      const int s = profile[c];
+      const bool carry = s + 1 == game_.num_strategies(c);
+      profile.strategy(c, carry ? 0 : s + 1);
+      if (!carry) {
+        break;
+      }
+    }
+  }
+  return num_found;
+}
+
+int64_t BestResponseTable::FindPureDense(const int64_t beg,
+                                         const int64_t end,
+                                         const size_t max_num,
+                                         const PureVisitor& visitor) const {
+  const int num_players = game_.num_players();
+  int64_t num_found = 0;
+  vector<int32_t> mask(kBlockSize);
+  for (int64_t block = beg; block < end; block += kBlockSize) {
+    const int64_t block_end = min(end, block + kBlockSize);
+    std::fill(mask.begin(), mask.end(), -1);
+    for (int p = 0; p < num_players; ++p) {
+      const int64_t stride = game_.stride(p);
+      const int num_strategies = game_.num_strategies(p);
+      const int* payoffs = game_.payoffs(p);
+      const int* best = &best_payoffs_[p][0];
+      if (stride == 1) {
+        // The strategies of p are contiguous, each run shares the best
+        // response of its sub-profile.
+        int64_t sub = block / num_strategies;
+        for (int64_t sp = block; sp < block_end; ++sub) {
+          const int64_t size = min(num_strategies * (sub + 1), block_end) - sp;
+          simd::ClearUnequal(payoffs + sp, best[sub], size, &mask[sp - block]);
+          sp += size;
+        }
+        continue;
+      }
+      // Each run of stride profiles of one strategy of p has contiguous
+      // payoffs and contiguous best responses. The offset in the run, the
+      // strategy and the first sub-profile of the block of p's axis follow
+      // the runs without divisions.
+      int64_t offset = block % stride;
+      int s = block / stride % num_strategies;
+      int64_t first_sub = block / (stride * num_strategies) * stride;
+      for (int64_t sp = block; sp < block_end;) {
+        const int64_t size = min(stride - offset, block_end - sp);
+        simd::ClearUnequal(payoffs + sp, best + first_sub + offset, size,
+                           &mask[sp - block]);
+        sp += size;
+        offset = 0;
+        if (++s == num_strategies) {
+          s = 0;
+          first_sub += stride;
+        }
+      }
+    }
+    const int32_t* block_mask = &mask[0];
+    const int64_t size = block_end - block;
+    for (int64_t i = simd::NextSet(block_mask, size); i < size;
+         i += 1 + simd::NextSet(block_mask + i + 1, size - i - 1)) {
+      ++num_found;
+      if ((visitor && !visitor(game_.CreateProfile(block + i))) ||
+          num_found >= static_cast<int64_t>(max_num)) {
+        return num_found;
+      }
+    }
+  }
+  return num_found;
+}
+
+int64_t BestResponseTable::SubProfileId(const StrategyProfile& profile,
+                                        const int player_id) const {
+  assert(profile.size() == game_.num_players());
+  int64_t id = 0;
+  for (int q = 0; q < profile.size(); ++q) {
+    id += profile[q] * sub_strides_[player_id][q];
+  }
+  return id;
+}
+
+int BestResponseTable::best_payoff(const int64_t sub_profile_id,
+                                   const int player_id) const {
+  assert(player_id >= 0 && player_id < game_.num_players());
+  assert(!best_payoffs_.empty());
+  return best_payoffs_[player_id][sub_profile_id];
+}
+
+}  // namespace ash
@@ -0,0 +1,74 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BEST_RESPONSE_TABLE_H_
+#define SRC_BEST_RESPONSE_TABLE_H_
+
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Best response payoffs of each player against each sub-profile of the other
+// players. The table is computed in one pass per player along its stride
+// axis, afterwards a profile is stable for a player iff its payoff equals the
+// best response payoff, which is a single comparison instead of one payoff
+// lookup per strategy. The table holds num_strategy_profiles / num_strategies
+// payoffs per player. Building and searching split the ranges into chunks,
+// which run on given number of threads. For dense games both passes use the
+// vectorized kernels of simd-kernels.h on whole blocks of profiles. Games with
+// memory-mapped or packed payoffs get no table, their profiles are checked by
+// scanning the deviations along each player's stride axis instead.
+class BestResponseTable {
+ public:
+  BestResponseTable(const Game& game, const int num_threads);
+  // Appends the pure strategy equilibria in ascending profile id order, until
+  // given number of equilibria is reached. With multiple threads each chunk
+  // of profiles is searched separately and the results are merged in chunk
+  // order, which gives the same equilibria as the serial search. Returns the
+  // number of equilibria found.
+  int FindPure(const size_t max_num, const int num_threads,
+               std::vector<StrategyProfile>* equilibria) const;
+  // Same as above, but streams the equilibria to given visitor instead, in
+  // the same order. With multiple threads the visitor is called from the
+  // worker threads, one call at a time, as soon as all chunks before are
+  // complete. Without visitor the equilibria are only counted, no profiles
+  // are kept. Returns the number of equilibria found.
+  int64_t FindPure(const size_t max_num, const int num_threads,
+                   const PureVisitor& visitor) const;
+  // Returns the id of the sub-profile of the other players of given profile.
+  int64_t SubProfileId(const StrategyProfile& profile,
+                       const int player_id) const;
+  // Returns the best response payoff of given player against given
+  // sub-profile, requires a table.
+  int best_payoff(const int64_t sub_profile_id, const int player_id) const;
+
+ private:
+  // Computes the best response payoffs of given player for the sub-profiles
+  // in the range [beg, end).
+  void Build(const int player_id, const int64_t beg, const int64_t end);
+  // Visits the pure strategy equilibria in the profile range [beg, end)
+  // until given number of equilibria is reached or the visitor stops, only
+  // counts them without visitor.
+  int64_t FindPure(const int64_t beg, const int64_t end, const size_t max_num,
+                   const PureVisitor& visitor) const;
+  // Same as above without table, compares the payoff of each profile with
+  // those of its deviations.
+  int64_t FindPureScan(const int64_t beg, const int64_t end,
+                       const size_t max_num,
+                       const PureVisitor& visitor) const;
+  // Same as above for dense games, masks the profiles of a block which are
+  // stable for each player and collects the remaining ones afterwards.
+  int64_t FindPureDense(const int64_t beg, const int64_t end,
+                        const size_t max_num,
+                        const PureVisitor& visitor) const;
+
+  const Game& game_;
+  // Best response payoffs per player indexed by sub-profile id, empty
+  // without table.
+  std::vector<std::vector<int> > best_payoffs_;
+  // Sub-profile strides per player, the stride of each other player in the
+  // sub-profile ids of the player.
+  std::vector<std::vector<int64_t> > sub_strides_;
+};
+
+}  // namespace ash
+#endif  // SRC_BEST_RESPONSE_TABLE_H_
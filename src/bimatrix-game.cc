@@ -0,0 +1,109 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./bimatrix-game.h"
+#include <cassert>
+#include <vector>
+#include "./game.h"
+
+using std::vector;
+
+namespace ash {
+
+// Runs the pure solver of the BimatrixGame instance.
+struct FindPureVisitor {
+  template<int N, int M>
+  int Run(const Game& game) const {
+    return BimatrixGame<N, M>(game).FindPure(max_num, visitor);
+  }
+
+  size_t max_num;
+  const PureVisitor& visitor;
+};
+
+// Runs the mixed solver of the BimatrixGame instance.
+struct FindMixedVisitor {
+  template<int N, int M>
+  int Run(const Game& game) const {
+    return BimatrixGame<N, M>(game).FindMixed(max_num, equilibria);
+  }
+
+  size_t max_num;
+  vector<MixedStrategyProfile>* equilibria;
+};
+
+// Runs the degeneracy check of the BimatrixGame instance.
+struct NondegenerateVisitor {
+  template<int N, int M>
+  int Run(const Game& game) const {
+    return BimatrixGame<N, M>(game).Nondegenerate();
+  }
+};
+
+// Compares the game dimensions against N x M and counts down to the minimum
+// dimensions, M first. The instances are generated at compile time.
+template<int N, int M>
+struct Dispatch {
+  template<typename Visitor>
+  static int Run(const Game& game, const Visitor& visitor) {
+    if (game.num_strategies(0) == N && game.num_strategies(1) == M) {
+      return visitor.template Run<N, M>(game);
+    }
+    return Dispatch<N, M - 1>::Run(game, visitor);
+  }
+};
+
+template<int N>
+struct Dispatch<N, BimatrixSolver::kMinNumStrategies - 1> {
+  template<typename Visitor>
+  static int Run(const Game& game, const Visitor& visitor) {
+    return Dispatch<N - 1, BimatrixSolver::kMaxNumStrategies>::Run(game,
+                                                                   visitor);
+  }
+};
+
+template<>
+struct Dispatch<BimatrixSolver::kMinNumStrategies - 1,
+                BimatrixSolver::kMaxNumStrategies> {
+  template<typename Visitor>
+  static int Run(const Game& game, const Visitor& visitor) {
+    assert(false && "Unsupported bimatrix game dimensions");
+    return 0;
+  }
+};
+
+typedef Dispatch<BimatrixSolver::kMaxNumStrategies,
+                 BimatrixSolver::kMaxNumStrategies> BimatrixDispatch;
+
+bool BimatrixSolver::Supports(const Game& game) {
+  if (game.num_players() != 2) {
+    return false;
+  }
+  for (int p = 0; p < 2; ++p) {
+    const int num_strategies = game.num_strategies(p);
+    if (num_strategies < kMinNumStrategies ||
+        num_strategies > kMaxNumStrategies) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int BimatrixSolver::FindPure(const Game& game, const size_t max_num,
+                             const PureVisitor& visitor) {
+  assert(Supports(game));
+  const FindPureVisitor pure_visitor = {max_num, visitor};
+  return BimatrixDispatch::Run(game, pure_visitor);
+}
+
+bool BimatrixSolver::Nondegenerate(const Game& game) {
+  assert(Supports(game));
+  return BimatrixDispatch::Run(game, NondegenerateVisitor());
+}
+
+int BimatrixSolver::FindMixed(const Game& game, const size_t max_num,
+                              vector<MixedStrategyProfile>* equilibria) {
+  assert(Supports(game));
+  const FindMixedVisitor visitor = {max_num, equilibria};
+  return BimatrixDispatch::Run(game, visitor);
+}
+
+}  // namespace ash
@@ -0,0 +1,363 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BIMATRIX_GAME_H_
+#define SRC_BIMATRIX_GAME_H_
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Two-player game with N strategies for the first and M strategies for the
+// second player, held in fixed-size payoff matrices. Its solvers run without
+// heap allocations or an LP solver, the loops over the matrix dimensions are
+// unrolled by the compiler.
+template<int N, int M>
+class BimatrixGame {
+ public:
+  // Copies the payoffs of given two-player game with matching dimensions.
+  explicit BimatrixGame(const Game& game) {
+    assert(game.num_players() == 2);
+    assert(game.num_strategies(0) == N && game.num_strategies(1) == M);
+    for (int j = 0; j < M; ++j) {
+      for (int i = 0; i < N; ++i) {
+        const int64_t sp_id = i + j * game.stride(1);
+        a_[i][j] = game.payoff(sp_id, 0);
+        bt_[j][i] = game.payoff(sp_id, 1);
+      }
+    }
+  }
+
+  // Appends the pure strategy equilibria in profile id order, until given
+  // number of equilibria is reached. Returns the number of equilibria found.
+  int FindPure(const size_t max_num,
+               std::vector<StrategyProfile>* equilibria) const {
+    assert(equilibria);
+    return FindPure(max_num, [equilibria](const StrategyProfile& profile) {
+      equilibria->push_back(profile);
+      return true;
+    });
+  }
+
+  // Same as above, but streams the equilibria to given visitor instead, until
+  // the visitor stops. Without visitor the equilibria are only counted.
+  // Returns the number of equilibria found.
+  int FindPure(const size_t max_num, const PureVisitor& visitor) const {
+    // The best response payoffs of each player to the opponent's strategies.
+    int col_max[M];
+    int row_max[N];
+    for (int j = 0; j < M; ++j) {
+      col_max[j] = a_[0][j];
+      for (int i = 1; i < N; ++i) {
+        col_max[j] = a_[i][j] > col_max[j] ? a_[i][j] : col_max[j];
+      }
+    }
+    for (int i = 0; i < N; ++i) {
+      row_max[i] = bt_[0][i];
+      for (int j = 1; j < M; ++j) {
+        row_max[i] = bt_[j][i] > row_max[i] ? bt_[j][i] : row_max[i];
+      }
+    }
+    size_t num_found = 0;
+    for (int j = 0; j < M; ++j) {
+      for (int i = 0; i < N; ++i) {
+        if (a_[i][j] == col_max[j] && bt_[j][i] == row_max[i]) {
+          if (num_found >= max_num) {
+            return num_found;
+          }
+          ++num_found;
+          if (visitor && !visitor(StrategyProfile({i, j}))) {
+            return num_found;
+          }
+        }
+      }
+    }
+    return num_found;
+  }
+
+  // Returns true if no mixed strategy of either player with k supported
+  // strategies has more than k pure best responses.
+  bool Nondegenerate() const {
+    return Nondegenerate<N, M>(a_) && Nondegenerate<M, N>(bt_);
+  }
+
+  // Appends the mixed strategy equilibria found by enumerating all pairs of
+  // equally-sized supports, until given number of equilibria is reached.
+  // For nondegenerate games these are all equilibria. 2x2 games are solved
+  // in closed form. Returns the number of equilibria found.
+  int FindMixed(const size_t max_num,
+                std::vector<MixedStrategyProfile>* equilibria) const {
+    assert(equilibria);
+    int num_found = 0;
+    double x[N];
+    double y[M];
+    for (int k = 1; k <= (N < M ? N : M); ++k) {
+      for (unsigned row_support = (1u << k) - 1u; row_support < (1u << N);
+           row_support = NextSupport(row_support)) {
+        for (unsigned col_support = (1u << k) - 1u; col_support < (1u << M);
+             col_support = NextSupport(col_support)) {
+          const bool solved = N == 2 && M == 2 && k == 2 ?
+                              Solve2x2(x, y) :
+                              Solve(row_support, col_support, k, x, y);
+          if (!solved) {
+            continue;
+          }
+          if (equilibria->size() >= max_num) {
+            return num_found;
+          }
+          equilibria->push_back(CreateProfile(x, y));
+          ++num_found;
+        }
+      }
+    }
+    return num_found;
+  }
+
+ private:
+  // Tolerance for the indifference and best response conditions.
+  static constexpr double kEpsilon = 1e-9;
+  // Maximum size of the indifference systems.
+  static const int kMaxDim = (N > M ? N : M) + 1;
+
+  // Returns the next larger support mask with the same number of strategies.
+  static unsigned NextSupport(const unsigned mask) {
+    const unsigned lowest = mask & -mask;
+    const unsigned ripple = mask + lowest;
+    return ripple | (((mask ^ ripple) >> 2) / lowest);
+  }
+
+  // Computes the strategies on given supports, which make each player
+  // indifferent between the strategies of the own support. Returns true if
+  // the strategies form an equilibrium with exactly the given supports.
+  bool Solve(const unsigned row_support, const unsigned col_support,
+             const int k, double* x, double* y) const {
+    double row_value = 0.0;
+    double col_value = 0.0;
+    return Equalize<N, M>(a_, row_support, col_support, k, y, &row_value) &&
+           BestResponse<N, M>(a_, y, row_value) &&
+           Equalize<M, N>(bt_, col_support, row_support, k, x, &col_value) &&
+           BestResponse<M, N>(bt_, x, col_value);
+  }
+
+  // Solves 2x2 games with fully mixed supports in closed form.
+  bool Solve2x2(double* x, double* y) const {
+    return Solve2x2(a_, y) && Solve2x2(bt_, x);
+  }
+
+  // Computes the opponent strategy, which makes the owner of the 2x2 payoff
+  // matrix indifferent between its strategies. A zero denominator means
+  // constant payoff differences: either one strategy is strictly dominated or
+  // the owner is indifferent against every strategy, then the uniform one is
+  // taken. Returns true if the strategy is fully mixed.
+  template<int R, int C>
+  static bool Solve2x2(const int (&payoffs)[R][C], double* probs) {
+    const double num = static_cast<double>(payoffs[1][1]) - payoffs[0][1];
+    const double den = static_cast<double>(payoffs[0][0]) - payoffs[0][1] -
+                       payoffs[1][0] + payoffs[1][1];
+    if (den == 0.0) {
+      probs[0] = 0.5;
+      probs[1] = 0.5;
+      return num == 0.0;
+    }
+    probs[0] = num / den;
+    probs[1] = 1.0 - probs[0];
+    return probs[0] > kEpsilon && probs[1] > kEpsilon;
+  }
+
+  // Checks for every opponent support of each size k and every k strategies
+  // of the matrix owner, whether the opponent strategy making these
+  // strategies indifferent has more than k best responses. These strategies
+  // are the vertices of the opponent's best response polytope, a degenerate
+  // strategy implies a degenerate vertex. Singular systems yield no vertex.
+  template<int R, int C>
+  static bool Nondegenerate(const int (&payoffs)[R][C]) {
+    double solution[kMaxDim] = {0.0};
+    int cols[kMaxDim] = {0};
+    for (int k = 1; k < R && k <= C; ++k) {
+      for (unsigned support = (1u << k) - 1u; support < (1u << C);
+           support = NextSupport(support)) {
+        for (unsigned own_support = (1u << k) - 1u; own_support < (1u << R);
+             own_support = NextSupport(own_support)) {
+          if (!SolveIndifference(payoffs, own_support, support, k, cols,
+                                 solution)) {
+            continue;
+          }
+          bool positive = true;
+          for (int i = 0; i < k && positive; ++i) {
+            positive = solution[i] > kEpsilon;
+          }
+          if (!positive) {
+            continue;
+          }
+          const double value = solution[k];
+          int num_best = 0;
+          bool best = true;
+          for (int r = 0; r < R && best; ++r) {
+            double payoff = 0.0;
+            for (int i = 0; i < k; ++i) {
+              payoff += payoffs[r][cols[i]] * solution[i];
+            }
+            best = payoff <= value + kEpsilon;
+            num_best += payoff >= value - kEpsilon;
+          }
+          if (best && num_best > k) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  // Solves for the opponent strategy over its support, which makes the owner
+  // of the payoff matrix indifferent between the strategies of its support:
+  // sum_c payoffs[r][c] * probs[c] = value for all supported r and
+  // sum_c probs[c] = 1. Requires strictly positive supported probabilities.
+  template<int R, int C>
+  static bool Equalize(const int (&payoffs)[R][C], const unsigned own_support,
+                       const unsigned support, const int k, double* probs,
+                       double* value) {
+    for (int c = 0; c < C; ++c) {
+      probs[c] = 0.0;
+    }
+    double solution[kMaxDim] = {0.0};
+    int cols[kMaxDim] = {0};
+    if (!SolveIndifference(payoffs, own_support, support, k, cols,
+                           solution)) {
+      return false;
+    }
+    for (int i = 0; i < k; ++i) {
+      if (solution[i] <= kEpsilon) {
+        return false;
+      }
+      probs[cols[i]] = solution[i];
+    }
+    *value = solution[k];
+    return true;
+  }
+
+  // Solves the indifference system of Equalize without requiring positive
+  // probabilities. Stores the supported strategies of the opponent in cols
+  // and the supported probabilities followed by the value in solution.
+  // Returns false if the system is singular.
+  template<int R, int C>
+  static bool SolveIndifference(const int (&payoffs)[R][C],
+                                const unsigned own_support,
+                                const unsigned support, const int k,
+                                int* cols, double* solution) {
+    // The k + 1 unknowns are the supported probabilities and the value.
+    double system[kMaxDim][kMaxDim + 1];
+    int num_cols = 0;
+    for (int c = 0; c < C; ++c) {
+      if (support & (1u << c)) {
+        cols[num_cols++] = c;
+      }
+    }
+    int row = 0;
+    for (int r = 0; r < R; ++r) {
+      if (own_support & (1u << r)) {
+        for (int i = 0; i < k; ++i) {
+          system[row][i] = payoffs[r][cols[i]];
+        }
+        system[row][k] = -1.0;
+        system[row][k + 1] = 0.0;
+        ++row;
+      }
+    }
+    for (int i = 0; i < k; ++i) {
+      system[k][i] = 1.0;
+    }
+    system[k][k] = 0.0;
+    system[k][k + 1] = 1.0;
+    const int dim = k + 1;
+    // Gaussian elimination with partial pivoting.
+    for (int i = 0; i < dim; ++i) {
+      int pivot = i;
+      for (int r = i + 1; r < dim; ++r) {
+        if (std::fabs(system[r][i]) > std::fabs(system[pivot][i])) {
+          pivot = r;
+        }
+      }
+      if (std::fabs(system[pivot][i]) < kEpsilon) {
+        return false;
+      }
+      if (pivot != i) {
+        for (int c = i; c <= dim; ++c) {
+          const double tmp = system[i][c];
+          system[i][c] = system[pivot][c];
+          system[pivot][c] = tmp;
+        }
+      }
+      for (int r = i + 1; r < dim; ++r) {
+        const double factor = system[r][i] / system[i][i];
+        for (int c = i; c <= dim; ++c) {
+          system[r][c] -= factor * system[i][c];
+        }
+      }
+    }
+    for (int i = dim - 1; i >= 0; --i) {
+      double sum = system[i][dim];
+      for (int c = i + 1; c < dim; ++c) {
+        sum -= system[i][c] * solution[c];
+      }
+      solution[i] = sum / system[i][i];
+    }
+    return true;
+  }
+
+  // Returns true if no strategy of the matrix owner yields more than given
+  // value against given opponent strategy.
+  template<int R, int C>
+  static bool BestResponse(const int (&payoffs)[R][C], const double* probs,
+                           const double value) {
+    for (int r = 0; r < R; ++r) {
+      double payoff = 0.0;
+      for (int c = 0; c < C; ++c) {
+        payoff += payoffs[r][c] * probs[c];
+      }
+      if (payoff > value + kEpsilon) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static MixedStrategyProfile CreateProfile(const double* x, const double* y) {
+    MixedStrategyProfile profile(2);
+    profile.SetNumStrategies(0, N);
+    profile.SetNumStrategies(1, M);
+    for (int i = 0; i < N; ++i) {
+      profile.AddProbability(0, i, x[i]);
+    }
+    for (int j = 0; j < M; ++j) {
+      profile.AddProbability(1, j, y[j]);
+    }
+    return profile;
+  }
+
+  // Payoffs of the first player indexed by [own][opponent] strategy.
+  int a_[N][M];
+  // Payoffs of the second player indexed by [own][opponent] strategy.
+  int bt_[M][N];
+};
+
+// Dispatches two-player games to the BimatrixGame of their dimensions.
+struct BimatrixSolver {
+  static const int kMinNumStrategies = 2;
+  static const int kMaxNumStrategies = 8;
+
+  // Returns true if a BimatrixGame instance exists for given game.
+  static bool Supports(const Game& game);
+  // Same as BimatrixGame::FindPure for given game.
+  static int FindPure(const Game& game, const size_t max_num,
+                      const PureVisitor& visitor);
+  // Same as BimatrixGame::Nondegenerate for given game.
+  static bool Nondegenerate(const Game& game);
+  // Same as BimatrixGame::FindMixed for given game.
+  static int FindMixed(const Game& game, const size_t max_num,
+                       std::vector<MixedStrategyProfile>* equilibria);
+};
+
+}  // namespace ash
+#endif  // SRC_BIMATRIX_GAME_H_
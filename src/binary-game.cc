@@ -0,0 +1,294 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./binary-game.h"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "./array.h"
+#include "./game.h"
+#include "./mapped-file.h"
+
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::ofstream;
+using std::shared_ptr;
+using std::numeric_limits;
+using base::Array;
+using base::MappedFile;
+
+namespace ash {
+
+// Fixed-size file header, all offsets are in bytes from the file begin.
+struct Header {
+  // Header flags.
+  static const uint32_t kDense = 1u;
+  static const uint32_t kZeroSum = 2u;
+  // Used to detect files written in foreign byte order.
+  static const uint32_t kByteOrder = 0x01020304u;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t flags;
+  uint32_t num_players;
+  uint32_t num_outcomes;
+  uint32_t reserved;
+  uint64_t num_profiles;
+  uint64_t strings_offset;
+  uint64_t outcomes_offset;
+  uint64_t payoffs_offset;
+};
+
+// Alignment of the payoff section, which allows using it in place.
+static const uint64_t kPageSize = 4096;
+// Number of payoff entries written at once.
+static const int kWriteBlockSize = 1 << 16;
+
+static uint64_t Align(const uint64_t offset, const uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+static void WriteString(const string& str, vector<char>* buffer) {
+  const uint32_t size = str.size();
+  const char* size_beg = reinterpret_cast<const char*>(&size);
+  buffer->insert(buffer->end(), size_beg, size_beg + sizeof(size));
+  buffer->insert(buffer->end(), str.begin(), str.end());
+}
+
+// Reads a string at given position, returns false if it exceeds end.
+static bool ReadString(const char** pos, const char* end, string* str) {
+  uint32_t size = 0;
+  if (end - *pos < static_cast<int64_t>(sizeof(size))) {
+    return false;
+  }
+  memcpy(&size, *pos, sizeof(size));
+  *pos += sizeof(size);
+  if (end - *pos < static_cast<int64_t>(size)) {
+    return false;
+  }
+  str->assign(*pos, size);
+  *pos += size;
+  return true;
+}
+
+// Reads an unsigned integer at given position, returns false if it exceeds
+// end.
+static bool ReadUint(const char** pos, const char* end, uint32_t* value) {
+  if (end - *pos < static_cast<int64_t>(sizeof(*value))) {
+    return false;
+  }
+  memcpy(value, *pos, sizeof(*value));
+  *pos += sizeof(*value);
+  return true;
+}
+
+const char BinaryGame::kMagic[8] = {'A', 'S', 'H', 'G', 'A', 'M', 'E', '\n'};
+const uint32_t BinaryGame::kVersion = 1;
+
+bool BinaryGame::Detect(const string& path) {
+  ifstream stream(path.c_str(), std::ios::binary);
+  char magic[sizeof(kMagic)];
+  stream.read(magic, sizeof(magic));
+  return stream.gcount() == sizeof(magic) &&
+         memcmp(magic, kMagic, sizeof(magic)) == 0;
+}
+
+bool BinaryGame::Write(const Game& game, const string& path) {
+  const int num_players = game.num_players();
+  const int64_t num_profiles = game.num_strategy_profiles();
+  // Games with outcomes store the compact outcome ids, even if flattened.
+  const bool dense = !game.num_outcomes();
+  vector<char> strings;
+  WriteString(game.name(), &strings);
+  for (int p = 0; p < num_players; ++p) {
+    const Player& player = game.player(p);
+    WriteString(player.name(), &strings);
+    const uint32_t num_strategies = player.num_strategies();
+    const char* num_beg = reinterpret_cast<const char*>(&num_strategies);
+    strings.insert(strings.end(), num_beg, num_beg + sizeof(num_strategies));
+    for (int s = 0; s < player.num_strategies(); ++s) {
+      WriteString(game.strategy(player.strategy(s)), &strings);
+    }
+  }
+  const int num_outcomes = game.num_outcomes();
+  vector<int32_t> outcome_payoffs;
+  for (int o = 0; o < num_outcomes; ++o) {
+    const Outcome& outcome = game.outcome(o);
+    WriteString(outcome.name(), &strings);
+    outcome_payoffs.insert(outcome_payoffs.end(), outcome.payoffs().begin(),
+                           outcome.payoffs().end());
+  }
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order = Header::kByteOrder;
+  header.flags = (dense ? Header::kDense : 0u) |
+                 (game.zero_sum() ? Header::kZeroSum : 0u);
+  header.num_players = num_players;
+  header.num_outcomes = num_outcomes;
+  header.num_profiles = num_profiles;
+  header.strings_offset = sizeof(header);
+  header.outcomes_offset = Align(header.strings_offset + strings.size(),
+                                 sizeof(int32_t));
+  header.payoffs_offset = Align(header.outcomes_offset +
+                                outcome_payoffs.size() * sizeof(int32_t),
+                                kPageSize);
+  ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(strings.data(), strings.size());
+  vector<char> padding(header.outcomes_offset - header.strings_offset -
+                       strings.size(), 0);
+  stream.write(padding.data(), padding.size());
+  stream.write(reinterpret_cast<const char*>(outcome_payoffs.data()),
+               outcome_payoffs.size() * sizeof(int32_t));
+  padding.assign(header.payoffs_offset - header.outcomes_offset -
+                 outcome_payoffs.size() * sizeof(int32_t), 0);
+  stream.write(padding.data(), padding.size());
+  // The payoff section is written blockwise, dense games player by player.
+  vector<int32_t> block;
+  block.reserve(kWriteBlockSize);
+  const int num_arrays = dense ? num_players : 1;
+  for (int p = 0; p < num_arrays; ++p) {
+    for (int64_t sp = 0; sp < num_profiles; ++sp) {
+      block.push_back(dense ? game.payoff(sp, p) : game.payoff_index(sp));
+      if (static_cast<int>(block.size()) == kWriteBlockSize ||
+          sp + 1 == num_profiles) {
+        stream.write(reinterpret_cast<const char*>(&block[0]),
+                     block.size() * sizeof(int32_t));
+        block.clear();
+      }
+    }
+  }
+  stream.close();
+  return !stream.fail();
+}
+
+BinaryGame::BinaryGame(const string& path)
+    : path_(path) {}
+
+Game BinaryGame::Load() {
+  error_.clear();
+  shared_ptr<const MappedFile> file(new MappedFile(path_));
+  if (!file->good() || file->size() < sizeof(Header)) {
+    error_ = "Could not map binary game " + path_;
+    return Game("");
+  }
+  Header header;
+  memcpy(&header, file->data(), sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    error_ = "Not a binary game";
+    return Game("");
+  } else if (header.version != kVersion) {
+    error_ = "Unsupported binary game version";
+    return Game("");
+  } else if (header.byte_order != Header::kByteOrder) {
+    error_ = "Binary game was written in foreign byte order";
+    return Game("");
+  }
+  const bool dense = header.flags & Header::kDense;
+  // Bounding the dimensions by the file size also keeps the section sizes
+  // below from overflowing.
+  const uint64_t max_entries = file->size() / sizeof(int32_t);
+  if (header.num_players == 0 ||
+      header.num_players >
+      static_cast<uint32_t>(numeric_limits<int>::max()) ||
+      header.num_outcomes > max_entries / header.num_players ||
+      header.num_profiles > max_entries / (dense ? header.num_players : 1)) {
+    error_ = "Corrupt binary game dimensions";
+    return Game("");
+  }
+  const int num_players = header.num_players;
+  const uint64_t outcomes_size = static_cast<uint64_t>(header.num_outcomes) *
+                                 num_players * sizeof(int32_t);
+  const uint64_t payoffs_size = header.num_profiles * sizeof(int32_t) *
+                                (dense ? num_players : 1);
+  if (header.strings_offset > header.outcomes_offset ||
+      header.outcomes_offset + outcomes_size > header.payoffs_offset ||
+      header.payoffs_offset % sizeof(int32_t) != 0 ||
+      header.payoffs_offset + payoffs_size > file->size()) {
+    error_ = "Corrupt binary game section offsets";
+    return Game("");
+  }
+  const char* pos = file->data() + header.strings_offset;
+  const char* strings_end = file->data() + header.outcomes_offset;
+  string name;
+  if (!ReadString(&pos, strings_end, &name)) {
+    error_ = "Corrupt binary game names";
+    return Game("");
+  }
+  Game game(name);
+  uint64_t num_profiles = 1;
+  for (int p = 0; p < num_players; ++p) {
+    string player_name;
+    uint32_t num_strategies = 0;
+    if (!ReadString(&pos, strings_end, &player_name) ||
+        !ReadUint(&pos, strings_end, &num_strategies) || !num_strategies) {
+      error_ = "Corrupt binary game names";
+      return Game("");
+    }
+    Player player(player_name);
+    for (uint32_t s = 0; s < num_strategies; ++s) {
+      string strategy_name;
+      if (!ReadString(&pos, strings_end, &strategy_name)) {
+        error_ = "Corrupt binary game names";
+        return Game("");
+      }
+      player.AddStrategy(game.AddStrategy(strategy_name));
+    }
+    if (num_profiles > static_cast<uint64_t>(numeric_limits<int64_t>::max()) /
+                       num_strategies) {
+      error_ = "Corrupt binary game dimensions";
+      return Game("");
+    }
+    game.AddPlayer(player);
+    num_profiles *= num_strategies;
+  }
+  if (num_profiles != header.num_profiles) {
+    error_ = "Corrupt binary game dimensions";
+    return Game("");
+  }
+  const int32_t* outcome_payoffs = reinterpret_cast<const int32_t*>(
+      file->data() + header.outcomes_offset);
+  for (uint32_t o = 0; o < header.num_outcomes; ++o) {
+    string outcome_name;
+    if (!ReadString(&pos, strings_end, &outcome_name)) {
+      error_ = "Corrupt binary game names";
+      return Game("");
+    }
+    const int32_t* payoffs_beg = outcome_payoffs + o * num_players;
+    game.AddOutcome(Outcome(outcome_name, vector<int>(payoffs_beg,
+                                                      payoffs_beg +
+                                                      num_players)));
+  }
+  if (dense) {
+    vector<Array<int> > payoffs;
+    for (int p = 0; p < num_players; ++p) {
+      const uint64_t offset = header.payoffs_offset +
+                              p * header.num_profiles * sizeof(int32_t);
+      payoffs.push_back(Array<int>(file, offset, header.num_profiles));
+    }
+    game.SetDensePayoffs(payoffs, header.flags & Header::kZeroSum);
+  } else {
+    const Array<int> payoff_indices(file, header.payoffs_offset,
+                                    header.num_profiles);
+    // Outcome ids are used unchecked by Game::payoff.
+    for (uint64_t sp = 0; sp < header.num_profiles; ++sp) {
+      if (static_cast<uint32_t>(payoff_indices[sp]) >= header.num_outcomes) {
+        error_ = "Corrupt binary game outcome ids";
+        return Game("");
+      }
+    }
+    game.SetPayoffs(payoff_indices);
+  }
+  return game;
+}
+
+const string& BinaryGame::error() const {
+  return error_;
+}
+
+}  // namespace ash
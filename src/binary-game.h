@@ -0,0 +1,48 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_BINARY_GAME_H_
+#define SRC_BINARY_GAME_H_
+
+#include <cstdint>
+#include <string>
+
+namespace ash {
+
+class Game;
+
+// Compact binary container for strategic games in host byte order. It holds
+// a fixed-size header, the names of the game, players, strategies and
+// outcomes, the outcome payoff table and a page-aligned payoff section, which
+// contains either the outcome id of each strategy profile or, for games
+// without outcomes, one payoff array per player. Loading maps the file and
+// uses the payoff section in place.
+class BinaryGame {
+ public:
+  static const char kMagic[8];
+  static const uint32_t kVersion;
+
+  // Returns true if the file at given path starts with the binary game magic.
+  static bool Detect(const std::string& path);
+
+  // Writes the game in binary format to the file at given path.
+  // Returns false if the file could not be written.
+  static bool Write(const Game& game, const std::string& path);
+
+  // Initialised the binary game reader with given path.
+  explicit BinaryGame(const std::string& path);
+
+  // Loads the game, its payoff section stays in the memory-mapped file.
+  // On failure the game is empty and error() returns the reason.
+  // Remark: Payoff indices are not validated, since that would require
+  // touching every page of the payoff section.
+  Game Load();
+
+  // Returns the reason of the last loading failure, empty if there was none.
+  const std::string& error() const;
+
+ private:
+  std::string path_;
+  std::string error_;
+};
+
+}  // namespace ash
+#endif  // SRC_BINARY_GAME_H_
@@ -0,0 +1,573 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./dense-solver.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include "./equation.h"
+#include "./lcp.h"
+
+using std::vector;
+using std::numeric_limits;
+using std::max;
+using base::Clock;
+
+namespace ash {
+
+// Magnitudes in the equilibrated system below which a value counts as zero or
+// as nearly zero, and above which it counts as non-zero.
+static const double kZeroEpsilon = 1e-13;
+static const double kPivotEpsilon = 1e-10;
+static const double kNonZeroEpsilon = 1e-9;
+// Tolerance of the feasibility checks, relative to the magnitude of the
+// summands of each equation.
+static const double kFeasibilityEpsilon = 1e-9;
+// Number of switched rows after which the inverse is rebuilt, which bounds
+// the accumulated round-off.
+static const int kMaxNumUpdates = 64;
+// Maximum number of rows switched by a single update.
+static const int kMaxNumSwitches = 8;
+
+// Adds the coefficients of given equation times given factor to given dense
+// row over all variables.
+static void AddCoefficients(const Equation& eq, const double factor,
+                            double* row) {
+  for (int su = 0; su < eq.size(); ++su) {
+    row[eq.variable(su)] += factor * eq.coefficient(su);
+  }
+}
+
+DenseSolver::DenseSolver(const Lcp& lcp)
+    : lcp_(lcp),
+      inverted_(false),
+      num_updates_(0),
+      exact_(true),
+      num_rows_(0),
+      size_(0),
+      duration_(0),
+      lp_solver_(lcp),
+      num_fallbacks_(0),
+      num_rebuilds_(0) {}
+
+bool DenseSolver::Solve() {
+  Clock beg;
+  bool solved = false;
+  if (lcp_.has_objective()) {
+    solved = SolveLp();
+  } else {
+    Elimination result = Update() ? SolveInverse() : kUndecided;
+    if (result == kUndecided) {
+      ++num_rebuilds_;
+      BuildSystem();
+      if (!inverted_) {
+        Invert();
+      }
+      result = SolveFloat();
+      if (result == kUndecided && exact_) {
+        result = SolveExact();
+      }
+    }
+    if (result == kUnique) {
+      solved = Feasible();
+    } else if (result == kUndecided) {
+      solved = SolveLp();
+    }
+  }
+  duration_ = Clock() - beg;
+  return solved;
+}
+
+void DenseSolver::BuildSystem() {
+  const int num_vars = lcp_.num_variables();
+  equalities_.clear();
+  for (int e = 0; e < lcp_.num_linear(); ++e) {
+    if (lcp_.equation(e).type() == Equation::kEqual) {
+      equalities_.push_back(&lcp_.equation(e));
+    }
+  }
+  for (int e = 0; e < lcp_.num_complementary(); ++e) {
+    if (lcp_.selected_equation(e).type() == Equation::kEqual) {
+      equalities_.push_back(&lcp_.selected_equation(e));
+    }
+  }
+  solution_.assign(num_vars, 0.0);
+  columns_.assign(num_vars, 0);
+  exact_ = true;
+  // Fixes the variables of the single-variable equalities, -1 marks them.
+  int num_rows = 0;
+  for (size_t e = 0; e < equalities_.size(); ++e) {
+    const Equation& eq = *equalities_[e];
+    int num_summands = 0;
+    int summand = 0;
+    for (int su = 0; su < eq.size(); ++su) {
+      if (eq.coefficient(su) != 0) {
+        ++num_summands;
+        summand = su;
+      }
+    }
+    const int var = num_summands == 1 ? eq.variable(summand) : -1;
+    if (var != -1 && columns_[var] != -1) {
+      columns_[var] = -1;
+      solution_[var] = double(eq.constant()) / eq.coefficient(summand);
+      exact_ = exact_ && eq.constant() % eq.coefficient(summand) == 0;
+    } else {
+      equalities_[num_rows++] = &eq;
+    }
+  }
+  equalities_.resize(num_rows);
+  variables_.clear();
+  for (int v = 0; v < num_vars; ++v) {
+    if (columns_[v] != -1) {
+      columns_[v] = variables_.size();
+      variables_.push_back(v);
+    }
+  }
+  num_rows_ = num_rows;
+  size_ = variables_.size();
+  const int num_cols = size_ + 1;
+  matrix_.assign(num_rows_ * num_cols, 0.0);
+  exact_matrix_.assign(num_rows_ * num_cols, 0);
+  for (int r = 0; r < num_rows_; ++r) {
+    const Equation& eq = *equalities_[r];
+    double* row = &matrix_[r * num_cols];
+    int64_t* exact_row = &exact_matrix_[r * num_cols];
+    row[size_] = eq.constant();
+    exact_row[size_] = eq.constant();
+    for (int su = 0; su < eq.size(); ++su) {
+      const int coeff = eq.coefficient(su);
+      const int var = eq.variable(su);
+      if (columns_[var] == -1) {
+        row[size_] -= coeff * solution_[var];
+        exact_row[size_] -= coeff * int64_t(solution_[var]);
+      } else {
+        row[columns_[var]] += coeff;
+        exact_row[columns_[var]] += coeff;
+      }
+    }
+    // Equilibrates the row for the pivot and residual thresholds.
+    const double row_scale = std::fabs(*std::max_element(
+        row, row + size_, [](const double a, const double b) {
+          return std::fabs(a) < std::fabs(b);
+        }));
+    if (row_scale > 0.0) {
+      for (int j = 0; j < num_cols; ++j) {
+        row[j] /= row_scale;
+      }
+    }
+  }
+}
+
+void DenseSolver::Invert() {
+  inverted_ = false;
+  num_updates_ = 0;
+  const int n = lcp_.num_variables();
+  vector<const Equation*> rows;
+  for (int e = 0; e < lcp_.num_linear(); ++e) {
+    if (lcp_.equation(e).type() == Equation::kEqual) {
+      rows.push_back(&lcp_.equation(e));
+    }
+  }
+  for (int e = 0; e < lcp_.num_complementary(); ++e) {
+    if (lcp_.selected_equation(e).type() != Equation::kEqual) {
+      return;
+    }
+    rows.push_back(&lcp_.selected_equation(e));
+  }
+  if (static_cast<int>(rows.size()) != n) {
+    return;
+  }
+  // Gauss-Jordan elimination of [D M | D] with partial pivoting, in which the
+  // diagonal D equilibrates the rows of M, leaves M^-1 on the right.
+  const int num_cols = 2 * n;
+  vector<double> m(n * num_cols, 0.0);
+  for (int r = 0; r < n; ++r) {
+    double* row = &m[r * num_cols];
+    AddCoefficients(*rows[r], 1.0, row);
+    double row_scale = 0.0;
+    for (int j = 0; j < n; ++j) {
+      row_scale = max(row_scale, std::fabs(row[j]));
+    }
+    if (row_scale == 0.0) {
+      return;
+    }
+    for (int j = 0; j < n; ++j) {
+      row[j] /= row_scale;
+    }
+    row[n + r] = 1.0 / row_scale;
+  }
+  for (int k = 0; k < n; ++k) {
+    int pivot_row = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (std::fabs(m[i * num_cols + k]) >
+          std::fabs(m[pivot_row * num_cols + k])) {
+        pivot_row = i;
+      }
+    }
+    if (std::fabs(m[pivot_row * num_cols + k]) <= kPivotEpsilon) {
+      return;
+    }
+    if (pivot_row != k) {
+      std::swap_ranges(m.begin() + k * num_cols, m.begin() + (k + 1) * num_cols,
+                       m.begin() + pivot_row * num_cols);
+    }
+    double* pivot = &m[k * num_cols];
+    const double pivot_value = pivot[k];
+    for (int j = k; j < num_cols; ++j) {
+      pivot[j] /= pivot_value;
+    }
+    for (int i = 0; i < n; ++i) {
+      double* row = &m[i * num_cols];
+      const double factor = row[k];
+      if (i == k || factor == 0.0) {
+        continue;
+      }
+      for (int j = k; j < num_cols; ++j) {
+        row[j] -= factor * pivot[j];
+      }
+    }
+  }
+  inverse_.resize(n * n);
+  for (int j = 0; j < n; ++j) {
+    std::copy(m.begin() + j * num_cols + n, m.begin() + (j + 1) * num_cols,
+              inverse_.begin() + j * n);
+  }
+  inverse_rows_.swap(rows);
+  inverted_ = true;
+}
+
+bool DenseSolver::Update() {
+  if (!inverted_) {
+    return false;
+  }
+  const int n = inverse_rows_.size();
+  const int num_linear_rows = n - lcp_.num_complementary();
+  vector<int> switched;
+  for (int e = 0; e < lcp_.num_complementary(); ++e) {
+    const Equation& eq = lcp_.selected_equation(e);
+    if (inverse_rows_[num_linear_rows + e] != &eq) {
+      if (eq.type() != Equation::kEqual) {
+        inverted_ = false;
+        return false;
+      }
+      switched.push_back(num_linear_rows + e);
+    }
+  }
+  const int k = switched.size();
+  if (k == 0) {
+    return true;
+  }
+  if (k > kMaxNumSwitches || num_updates_ + k > kMaxNumUpdates) {
+    inverted_ = false;
+    return false;
+  }
+  // Switching the rows changes M to M + E D, with the unit columns of the
+  // switched rows in E and the differences of their equations in the rows of
+  // D. By the Woodbury identity the inverse changes by -Z C^-1 D M^-1 with the
+  // switched columns Z = M^-1 E of the inverse and C = I + D Z.
+  vector<double> d(k * n, 0.0);
+  vector<double> z(n * k);
+  for (int a = 0; a < k; ++a) {
+    const int r = switched[a];
+    AddCoefficients(lcp_.selected_equation(r - num_linear_rows), 1.0,
+                    &d[a * n]);
+    AddCoefficients(*inverse_rows_[r], -1.0, &d[a * n]);
+    for (int j = 0; j < n; ++j) {
+      z[j * k + a] = inverse_[j * n + r];
+    }
+  }
+  // The augmented system [C | D M^-1], solved for C^-1 D M^-1 by Gauss-Jordan
+  // elimination with partial pivoting.
+  const int num_cols = k + n;
+  vector<double> m(k * num_cols, 0.0);
+  double scale = 1.0;
+  for (int a = 0; a < k; ++a) {
+    double* row = &m[a * num_cols];
+    row[a] = 1.0;
+    for (int j = 0; j < n; ++j) {
+      const double coeff = d[a * n + j];
+      if (coeff == 0.0) {
+        continue;
+      }
+      for (int b = 0; b < k; ++b) {
+        row[b] += coeff * z[j * k + b];
+      }
+      const double* inverse_row = &inverse_[j * n];
+      for (int i = 0; i < n; ++i) {
+        row[k + i] += coeff * inverse_row[i];
+      }
+    }
+    for (int b = 0; b < k; ++b) {
+      scale = max(scale, std::fabs(row[b]));
+    }
+  }
+  for (int c = 0; c < k; ++c) {
+    int pivot_row = c;
+    for (int a = c + 1; a < k; ++a) {
+      if (std::fabs(m[a * num_cols + c]) >
+          std::fabs(m[pivot_row * num_cols + c])) {
+        pivot_row = a;
+      }
+    }
+    // The switched system is nearly singular, the inverse stays valid for
+    // the previous one.
+    if (std::fabs(m[pivot_row * num_cols + c]) <= kPivotEpsilon * scale) {
+      return false;
+    }
+    if (pivot_row != c) {
+      std::swap_ranges(m.begin() + c * num_cols, m.begin() + (c + 1) * num_cols,
+                       m.begin() + pivot_row * num_cols);
+    }
+    double* pivot = &m[c * num_cols];
+    const double pivot_value = pivot[c];
+    for (int j = c; j < num_cols; ++j) {
+      pivot[j] /= pivot_value;
+    }
+    for (int a = 0; a < k; ++a) {
+      double* row = &m[a * num_cols];
+      const double factor = row[c];
+      if (a == c || factor == 0.0) {
+        continue;
+      }
+      for (int j = c; j < num_cols; ++j) {
+        row[j] -= factor * pivot[j];
+      }
+    }
+  }
+  for (int j = 0; j < n; ++j) {
+    double* inverse_row = &inverse_[j * n];
+    for (int a = 0; a < k; ++a) {
+      const double factor = z[j * k + a];
+      if (factor == 0.0) {
+        continue;
+      }
+      const double* row = &m[a * num_cols + k];
+      for (int i = 0; i < n; ++i) {
+        inverse_row[i] -= factor * row[i];
+      }
+    }
+  }
+  for (int a = 0; a < k; ++a) {
+    const int r = switched[a];
+    inverse_rows_[r] = &lcp_.selected_equation(r - num_linear_rows);
+  }
+  num_updates_ += k;
+  return true;
+}
+
+DenseSolver::Elimination DenseSolver::SolveInverse() {
+  const int n = inverse_rows_.size();
+  solution_.assign(n, 0.0);
+  vector<double> residuals(n);
+  vector<double> magnitudes(n);
+  // The second step refines the solution with its residuals, which removes
+  // most of the round-off accumulated by the updates.
+  for (int step = 0; step <= 2; ++step) {
+    for (int r = 0; r < n; ++r) {
+      const Equation& eq = *inverse_rows_[r];
+      residuals[r] = eq.constant();
+      magnitudes[r] = std::abs(eq.constant());
+      for (int su = 0; su < eq.size(); ++su) {
+        const double summand = eq.coefficient(su) * solution_[eq.variable(su)];
+        residuals[r] -= summand;
+        magnitudes[r] += std::fabs(summand);
+      }
+    }
+    if (step == 2) {
+      break;
+    }
+    for (int j = 0; j < n; ++j) {
+      const double* inverse_row = &inverse_[j * n];
+      double value = 0.0;
+      for (int i = 0; i < n; ++i) {
+        value += inverse_row[i] * residuals[i];
+      }
+      solution_[j] += value;
+    }
+  }
+  // Larger residuals left by the round-off invalidate the inverse.
+  for (int r = 0; r < n; ++r) {
+    if (std::fabs(residuals[r]) >
+        kFeasibilityEpsilon * max(1.0, magnitudes[r])) {
+      inverted_ = false;
+      return kUndecided;
+    }
+  }
+  return kUnique;
+}
+
+DenseSolver::Elimination DenseSolver::SolveFloat() {
+  const int num_cols = size_ + 1;
+  double* m = num_rows_ ? &matrix_[0] : NULL;
+  // Nearly zero columns are skipped, unless they are not clearly zero.
+  bool ambiguous = false;
+  int rank = 0;
+  for (int k = 0; k < size_; ++k) {
+    int pivot_row = rank;
+    for (int i = rank + 1; i < num_rows_; ++i) {
+      if (std::fabs(m[i * num_cols + k]) >
+          std::fabs(m[pivot_row * num_cols + k])) {
+        pivot_row = i;
+      }
+    }
+    const double pivot_value = pivot_row < num_rows_ ?
+                               std::fabs(m[pivot_row * num_cols + k]) : 0.0;
+    if (pivot_value <= kPivotEpsilon) {
+      ambiguous = ambiguous || pivot_value > kZeroEpsilon;
+      continue;
+    }
+    if (pivot_row != rank) {
+      std::swap_ranges(m + rank * num_cols + k, m + (rank + 1) * num_cols,
+                       m + pivot_row * num_cols + k);
+    }
+    const double* pivot = m + rank * num_cols;
+    for (int i = rank + 1; i < num_rows_; ++i) {
+      double* row = m + i * num_cols;
+      const double factor = row[k] / pivot[k];
+      if (factor == 0.0) {
+        continue;
+      }
+      for (int j = k; j < num_cols; ++j) {
+        row[j] -= factor * pivot[j];
+      }
+    }
+    ++rank;
+  }
+  // The rows below the pivot rows are zero, a clearly non-zero right-hand
+  // side proves the system inconsistent.
+  for (int i = rank; i < num_rows_; ++i) {
+    const double rhs = std::fabs(m[i * num_cols + size_]);
+    if (rhs > kNonZeroEpsilon) {
+      return kInconsistent;
+    }
+    ambiguous = ambiguous || rhs > kZeroEpsilon;
+  }
+  if (ambiguous || rank < size_) {
+    return kUndecided;
+  }
+  // Without skipped columns the pivot of row k is in column k.
+  for (int k = size_ - 1; k >= 0; --k) {
+    const double* row = m + k * num_cols;
+    double value = row[size_];
+    for (int j = k + 1; j < size_; ++j) {
+      value -= row[j] * solution_[variables_[j]];
+    }
+    solution_[variables_[k]] = value / row[k];
+  }
+  return kUnique;
+}
+
+DenseSolver::Elimination DenseSolver::SolveExact() {
+  const int num_cols = size_ + 1;
+  int64_t* m = num_rows_ ? &exact_matrix_[0] : NULL;
+  int64_t denominator = 1;
+  // The pivot rows form the top of the matrix, free columns are skipped.
+  int rank = 0;
+  for (int k = 0; k < size_; ++k) {
+    int pivot_row = rank;
+    while (pivot_row < num_rows_ && m[pivot_row * num_cols + k] == 0) {
+      ++pivot_row;
+    }
+    if (pivot_row == num_rows_) {
+      continue;
+    }
+    if (pivot_row != rank) {
+      std::swap_ranges(m + rank * num_cols, m + (rank + 1) * num_cols,
+                       m + pivot_row * num_cols);
+    }
+    const int64_t* pivot_row_values = m + rank * num_cols;
+    const int64_t pivot = pivot_row_values[k];
+    for (int i = 0; i < num_rows_; ++i) {
+      if (i == rank) {
+        continue;
+      }
+      int64_t* row = m + i * num_cols;
+      const int64_t factor = row[k];
+      for (int j = 0; j < num_cols; ++j) {
+        // Exact division by the previous pivot.
+        const __int128 value = (__int128(row[j]) * pivot -
+                                __int128(factor) * pivot_row_values[j]) /
+                               denominator;
+        if (value > numeric_limits<int64_t>::max() ||
+            value < numeric_limits<int64_t>::min()) {
+          return kUndecided;
+        }
+        row[j] = value;
+      }
+    }
+    denominator = pivot;
+    ++rank;
+  }
+  // The rows below the pivot rows are zero, but not necessarily their
+  // right-hand sides.
+  for (int i = rank; i < num_rows_; ++i) {
+    if (m[i * num_cols + size_] != 0) {
+      return kInconsistent;
+    }
+  }
+  if (rank < size_) {
+    return kUndecided;
+  }
+  // The pivot of row k is in column k and equals the determinant now.
+  for (int k = 0; k < size_; ++k) {
+    solution_[variables_[k]] = double(m[k * num_cols + size_]) / denominator;
+  }
+  return kUnique;
+}
+
+bool DenseSolver::Feasible() {
+  for (auto it = solution_.begin(); it != solution_.end(); ++it) {
+    if (*it < -kFeasibilityEpsilon) {
+      return false;
+    } else if (*it < kFeasibilityEpsilon) {
+      *it = 0.0;
+    }
+  }
+  const int num_linear = lcp_.num_linear();
+  const int num_equations = num_linear + lcp_.num_complementary();
+  for (int e = 0; e < num_equations; ++e) {
+    const Equation& eq = e < num_linear ? lcp_.equation(e) :
+                         lcp_.selected_equation(e - num_linear);
+    double lhs = 0.0;
+    double magnitude = std::abs(eq.constant());
+    for (int su = 0; su < eq.size(); ++su) {
+      const double summand = eq.coefficient(su) * solution_[eq.variable(su)];
+      lhs += summand;
+      magnitude += std::fabs(summand);
+    }
+    const double slack = lhs - eq.constant();
+    const double epsilon = kFeasibilityEpsilon * max(1.0, magnitude);
+    const Equation::Type type = eq.type();
+    if ((type == Equation::kEqual && std::fabs(slack) > epsilon) ||
+        (type == Equation::kGreaterEqual && slack < -epsilon) ||
+        (type == Equation::kLessEqual && slack > epsilon)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DenseSolver::SolveLp() {
+  ++num_fallbacks_;
+  const bool solved = lp_solver_.Solve();
+  solution_ = lp_solver_.solution();
+  return solved;
+}
+
+const vector<double>& DenseSolver::solution() const {
+  return solution_;
+}
+
+Clock::Diff DenseSolver::duration() const {
+  return duration_;
+}
+
+int DenseSolver::num_fallbacks() const {
+  return num_fallbacks_;
+}
+
+int DenseSolver::num_rebuilds() const {
+  return num_rebuilds_;
+}
+
+}  // namespace ash
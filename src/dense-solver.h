@@ -0,0 +1,109 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_DENSE_SOLVER_H_
+#define SRC_DENSE_SOLVER_H_
+
+#include <cstdint>
+#include <vector>
+#include "./clock.h"
+#include "./lp-solver.h"
+
+namespace ash {
+
+class Lcp;
+class Equation;
+
+// Native feasibility solver for the LCPs of the support enumeration, a drop-in
+// replacement of the LpSolver. With the complementary equations of a support
+// selected, the single-variable equalities fix the unsupported strategies and
+// the other equalities form a linear system in the remaining variables. It is
+// solved on a dense matrix by Gaussian elimination with partial pivoting and
+// the solution is feasible, if it satisfies all inequalities and is
+// non-negative. Systems with nearly zero pivots or residuals are eliminated
+// again exactly on the integer coefficients (Bareiss), which proves them
+// inconsistent or finds their unique solution. Underdetermined systems and
+// LCPs with objective are passed on to the LpSolver.
+// The inverse of the square system of all selected equalities over all
+// variables is kept between solves. Switching complementary pairs replaces
+// their rows, which updates the inverse in quadratic time by the Woodbury
+// identity, so consecutive supports differing in few strategies are solved
+// without rebuilding the system.
+class DenseSolver {
+ public:
+  explicit DenseSolver(const Lcp& lcp);
+  // Solves the LCP with its currently selected equations, the matrices are
+  // reused between calls and updated for the complementary pairs switched
+  // since the last call.
+  bool Solve();
+  const std::vector<double>& solution() const;
+  base::Clock::Diff duration() const;
+  // Returns the number of solves passed on to the LpSolver.
+  int num_fallbacks() const;
+  // Returns the number of solves which rebuilt the system from the LCP.
+  int num_rebuilds() const;
+
+ private:
+  // Results of the exact elimination.
+  enum Elimination { kUnique, kInconsistent, kUndecided };
+
+  // Fixes the variables of the single-variable equalities and builds the
+  // matrices of the remaining equalities.
+  void BuildSystem();
+  // Inverts the system of all selected equalities over all variables, if it
+  // is square and clearly nonsingular.
+  void Invert();
+  // Updates the inverse for the complementary pairs switched since it was
+  // built or updated. Returns false if there is no inverse or the switched
+  // system is nearly singular, in which case the inverse is kept for the
+  // previous one.
+  bool Update();
+  // Solves the system with its inverse. Returns kUndecided and invalidates
+  // the inverse if the residual is too large.
+  Elimination SolveInverse();
+  // Solves the floating point system by Gaussian elimination with partial
+  // pivoting. Returns kUndecided if it has free variables or if a pivot or
+  // residual is too close to zero to decide.
+  Elimination SolveFloat();
+  // Solves the integer system by fraction-free Gauss-Jordan elimination.
+  // Returns kUndecided if it has free variables or an entry exceeds 64 bits.
+  Elimination SolveExact();
+  // Returns true if the solution satisfies all equations and bounds, clamps
+  // the round-off of zero variables.
+  bool Feasible();
+  bool SolveLp();
+
+  const Lcp& lcp_;
+  // The selected equalities.
+  std::vector<const Equation*> equalities_;
+  // The column of each variable in the system or -1 for fixed variables.
+  std::vector<int> columns_;
+  // The variable of each column.
+  std::vector<int> variables_;
+  // The augmented system in row-major order, num_rows_ x (size_ + 1), with
+  // the largest coefficient of each row scaled to 1.
+  std::vector<double> matrix_;
+  std::vector<int64_t> exact_matrix_;
+  // The inverse of the system of all selected equalities in row-major order,
+  // the row of a variable times the right-hand sides gives its value.
+  std::vector<double> inverse_;
+  // The equation of each row of the inverted system, the linear equalities
+  // followed by the selected equation of each complementary pair.
+  std::vector<const Equation*> inverse_rows_;
+  // True if the inverse is valid.
+  bool inverted_;
+  // The number of rows switched since the inverse was built.
+  int num_updates_;
+  // False if a fixed variable is not integral.
+  bool exact_;
+  int num_rows_;
+  // The number of variables in the system.
+  int size_;
+  std::vector<double> solution_;
+  base::Clock::Diff duration_;
+  // The solver of the undecided systems, its model is built on first use.
+  LpSolver lp_solver_;
+  int num_fallbacks_;
+  int num_rebuilds_;
+};
+
+}  // namespace ash
+#endif  // SRC_DENSE_SOLVER_H_
@@ -2,12 +2,22 @@
 #include "./equilibria-finder.h"
 #include <gflags/gflags.h>
 #include <cassert>
+#include <cmath>
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include "./best-response-table.h"
+#include "./bimatrix-game.h"
+#include "./dense-solver.h"
 #include "./game.h"
 #include "./lcp.h"
 #include "./lcp-factory.h"
+#include "./lemke-howson.h"
 #include "./lp-solver.h"
+#include "./parallel-for.h"
+#include "./polynomial-solver.h"
+#include "./support-enumerator.h"
+#include "./vertex-enumerator.h"
 
 using std::string;
 using std::vector;
@@ -19,123 +29,379 @@ DECLARE_bool(verbose);
 
 namespace ash {
 
+// Minimum number of support combinations per parallel task.
+static const int64_t kMinSupportsChunkSize = 16;
+// Maximum support size of the bit mask supports.
+static const int kMaxSupportSize = 32;
+
 EquilibriaFinder::EquilibriaFinder(const Game& game)
     : game_(game),
-      max_num_equilibria_(numeric_limits<int>::max()) {
+      max_num_equilibria_(numeric_limits<int>::max()),
+      specialized_(true),
+      num_threads_(1),
+      pns_(false),
+      lemke_howson_(false),
+      vertex_enumeration_(false),
+      symmetric_mixed_(false),
+      min_support_(1),
+      max_support_(kMaxSupportSize),
+      symmetric_(-1),
+      symmetric_game_(0, 0) {
   Reset();
 }
 
+// Passes given equilibria to the visitor until it stops, returns the number
+// of visited equilibria. Without visitor all equilibria count as visited.
+template<typename Profile, typename Visitor>
+static int64_t Visit(const vector<Profile>& equilibria,
+                     const Visitor& visitor) {
+  if (!visitor) {
+    return equilibria.size();
+  }
+  int64_t num_visited = 0;
+  for (auto it = equilibria.begin(); it != equilibria.end(); ++it) {
+    ++num_visited;
+    if (!visitor(*it)) {
+      break;
+    }
+  }
+  return num_visited;
+}
+
 int EquilibriaFinder::FindPure() {
+  return FindPure([this](const StrategyProfile& profile) {
+    equilibria_.push_back(profile);
+    return true;
+  });
+}
+
+int64_t EquilibriaFinder::FindPure(const PureVisitor& visitor) {
   Reset();
-  Clock beg;
-  const int num_players = game_.num_players();
-  const int num_profiles = game_.num_strategy_profiles();
-  for (int sp = 0; sp < num_profiles; ++sp) {
-    StrategyProfile profile = game_.CreateProfile(sp);
-    const vector<int>& payoff = game_.payoff(profile);
-    bool equilibrium = true;
-    for (int p = 0; p < num_players && equilibrium; ++p) {
-      // Remember the original strategy played.
-      const int org_s = profile.strategy(p);
-      const Player& player = game_.player(p);
-      const int num_strategies = player.num_strategies();
-      for (int s = 0; s < num_strategies && equilibrium; ++s) {
-        // Switch the strategy for player p to strategy s.
-        profile.strategy(p, s);
-        const vector<int>& payoff2 = game_.payoff(profile);
-        if (payoff2[p] > payoff[p]) {
-          // Player p increases payoff by switching to strategy s, therefore the
-          // strategy profile is not a Nash equilibrium.
-          equilibrium = false;
-        }
-      }
-      // Revert the tested strategy back for player p.
-      profile.strategy(p, org_s);
-    }
-    if (equilibrium) {
-      equilibria_.push_back(profile);
-      if (equilibria_.size() >= max_num_equilibria_) {
-        break;
-      }
-    }
+  // Process time would add up the time of all threads.
+  const Clock::Type clock_type = num_threads_ > 1 ? Clock::kRealMonotonic :
+                                                    Clock::kDefType;
+  Clock beg(clock_type);
+  int64_t num_found = 0;
+  if (specialized_ && BimatrixSolver::Supports(game_)) {
+    num_found = BimatrixSolver::FindPure(game_, max_num_equilibria_, visitor);
+  } else if (specialized_ && Symmetric()) {
+    num_found = symmetric_game_.FindPure(max_num_equilibria_, visitor);
+  } else {
+    const BestResponseTable table(game_, num_threads_);
+    num_found = table.FindPure(max_num_equilibria_, num_threads_, visitor);
   }
-  duration_ = Clock() - beg;
-  return equilibria_.size();
+  duration_ = Clock(clock_type) - beg;
+  return num_found;
+}
+
+int64_t EquilibriaFinder::CountPure() {
+  return FindPure(PureVisitor());
 }
 
 int EquilibriaFinder::FindMixed() {
+  return FindMixed([this](const MixedStrategyProfile& profile) {
+    mixed_equilibria_.push_back(profile);
+    return true;
+  });
+}
+
+int64_t EquilibriaFinder::FindMixed(const MixedVisitor& visitor) {
   Reset();
-  Clock beg;
+  const Clock::Type clock_type = num_threads_ > 1 ? Clock::kRealMonotonic :
+                                                    Clock::kDefType;
+  Clock beg(clock_type);
+  if (lemke_howson_ && game_.num_players() == 2) {
+    LemkeHowson solver(game_);
+    const int64_t num_found = solver.FindMixed(max_num_equilibria_, visitor);
+    duration_ = Clock(clock_type) - beg;
+    return num_found;
+  }
+  if (vertex_enumeration_ && game_.num_players() == 2) {
+    VertexEnumerator enumerator(game_);
+    const int64_t num_found = enumerator.FindMixed(max_num_equilibria_,
+                                                   visitor);
+    cliques_ = enumerator.cliques();
+    duration_ = Clock(clock_type) - beg;
+    return num_found;
+  }
+  // The specialized solvers neither order nor bound the supports.
+  const bool specialized = specialized_ && !pns_ && min_support_ == 1 &&
+                           max_support_ == kMaxSupportSize;
+  // The equal-size supports of the bimatrix solver are complete for
+  // nondegenerate games only.
+  if (specialized && BimatrixSolver::Supports(game_) &&
+      BimatrixSolver::Nondegenerate(game_)) {
+    vector<MixedStrategyProfile> equilibria;
+    BimatrixSolver::FindMixed(game_, max_num_equilibria_, &equilibria);
+    duration_ = Clock(clock_type) - beg;
+    return Visit(equilibria, visitor);
+  }
+  if (specialized && symmetric_mixed_ && Symmetric()) {
+    vector<MixedStrategyProfile> equilibria;
+    symmetric_game_.FindMixed(max_num_equilibria_, &equilibria);
+    duration_ = Clock(clock_type) - beg;
+    return Visit(equilibria, visitor);
+  }
+  if (game_.num_players() > 2) {
+    // The support masks hold 32 strategies per player, larger games are
+    // rejected before enumerating any support.
+    for (int p = 0; p < game_.num_players(); ++p) {
+      if (game_.num_strategies(p) > kMaxSupportSize) {
+        duration_ = Clock(clock_type) - beg;
+        return 0;
+      }
+    }
+    // The expected payoffs are multilinear in the opponents' strategies, the
+    // LCP is exact for two players only.
+    const int64_t num_found = SolvePolynomialSupports(visitor);
+    duration_ = Clock(clock_type) - beg;
+    return num_found;
+  }
   vector<vector<int> > compl_map;
   vector<vector<int> > player_vars;
   Lcp lcp = LcpFactory::Create(game_, &compl_map, &player_vars);
-  lcp_duration_ = Clock() - beg;
+  lcp_duration_ = Clock(clock_type) - beg;
   const int num_players = game_.num_players();
   assert(static_cast<int>(compl_map.size()) == num_players);
+  size_t num_found = 0;
   if (game_.zero_sum()) {
     // Zero-sum game.
+    LpSolver lp_solver(lcp);
     for (int p = 0; p < num_players; ++p) {
       lcp.SelectObjective(p);
-      LpSolver lp_solver(lcp);
       const bool solved = lp_solver.Solve();
       lp_duration_ += lp_solver.duration();
       if (solved) {
-        AddMixedEquilibrium(lp_solver.solution(), player_vars);
-        if (equilibria_.size() >= max_num_equilibria_) {
+        ++num_found;
+        if ((visitor && !visitor(CreateMixedProfile(lp_solver.solution(),
+                                                    player_vars))) ||
+            num_found >= max_num_equilibria_) {
           break;
         }
       }
     }
+  } else if (pns_) {
+    // Non-zero-sum game, supports in the order of Porter, Nudelman and Shoham.
+    num_found = SolvePnsSupports(compl_map, player_vars, visitor, &lcp);
   } else {
     // Non-zero-sum game.
-    vector<uint32_t> supports(num_players, 1u);
-    supports[0] = 0u;  // We use this only to kick off the permutations.
-    while (NextSupports(&supports)) {
-      for (int p = 0; p < num_players; ++p) {
-        const int num_strategies = game_.num_strategies(p);
-        assert(static_cast<int>(compl_map[p].size()) == num_strategies);
-        for (int s = 0; s < num_strategies; ++s) {
-          const int compl_fun_id = compl_map[p][s];
-          if (compl_fun_id != Lcp::kInvalidId) {
-            const uint32_t mask = s + 1u;
-            const int supported = (supports[p] & mask) != 0u;
-            lcp.SelectEquation(compl_fun_id, !supported, supported);
-          }
-        }
+    num_found = SolveSupports(lcp, compl_map, player_vars, visitor);
+  }
+  duration_ = Clock(clock_type) - beg;
+  return num_found;
+}
+
+int64_t EquilibriaFinder::SolveSupports(const Lcp& lcp,
+                                        const vector<vector<int> >& compl_map,
+                                        const vector<vector<int> >& player_vars,
+                                        const MixedVisitor& visitor) {
+  const int64_t num_supports = NumSupports();
+  if (num_threads_ == 1) {
+    Lcp lcp_copy = lcp;
+    return SolveSupports(0, num_supports, max_num_equilibria_, compl_map,
+                         player_vars, visitor, &lcp_copy, &lp_duration_);
+  }
+  const int64_t chunk = base::ChunkSize(num_supports, num_threads_,
+                                        kMinSupportsChunkSize);
+  const int64_t num_chunks = (num_supports + chunk - 1) / chunk;
+  typedef vector<MixedStrategyProfile> Result;
+  std::atomic<Clock::Diff> lp_duration(0);
+  size_t num_visited = 0;
+  // The ranges are merged in order, once the merged ones hold enough
+  // equilibria no further ranges are solved, which keeps the equilibria
+  // identical to the serial ones.
+  auto solve = [&](const int64_t c, Result* equilibria) {
+    Lcp lcp_copy = lcp;
+    Clock::Diff duration = 0;
+    SolveSupports(c * chunk, std::min(num_supports, (c + 1) * chunk),
+                  max_num_equilibria_, compl_map, player_vars,
+                  [equilibria](const MixedStrategyProfile& p) {
+                    equilibria->push_back(p);
+                    return true;
+                  }, &lcp_copy, &duration);
+    lp_duration += duration;
+  };
+  auto merge = [&](Result* equilibria) {
+    for (auto it = equilibria->begin(); it != equilibria->end(); ++it) {
+      ++num_visited;
+      if ((visitor && !visitor(*it)) || num_visited >= max_num_equilibria_) {
+        return false;
       }
-      Clock lp_beg;
-      LpSolver lp_solver(lcp);
-      const bool solved = lp_solver.Solve();
-      lp_duration_ += Clock() - lp_beg;
-      if (solved) {
-        AddMixedEquilibrium(lp_solver.solution(), player_vars);
-        if (equilibria_.size() >= max_num_equilibria_) {
-          break;
-        }
+    }
+    return true;
+  };
+  base::OrderedParallelFor<Result>(num_chunks, num_threads_, solve, merge);
+  lp_duration_ += lp_duration;
+  return num_visited;
+}
+
+int64_t EquilibriaFinder::SolveSupports(const int64_t beg, const int64_t end,
+                                        const size_t max_num,
+                                        const vector<vector<int> >& compl_map,
+                                        const vector<vector<int> >& player_vars,
+                                        const MixedVisitor& visitor, Lcp* lcp,
+                                        Clock::Diff* lp_duration) const {
+  size_t num_found = 0;
+  DenseSolver solver(*lcp);
+  vector<uint32_t> supports(game_.num_players());
+  Supports(beg, &supports);
+  SelectSupports(supports, compl_map, lcp);
+  for (int64_t index = beg; index < end; ++index) {
+    if (index > beg) {
+      // Only the complementary pair of the flipped strategy changes.
+      int s = 0;
+      const int p = NextSupports(index - 1, &supports, &s);
+      const int compl_fun_id = compl_map[p][s];
+      if (compl_fun_id != Lcp::kInvalidId) {
+        const bool supported = supports[p] & (1u << s);
+        lcp->SelectEquation(compl_fun_id, !supported, supported);
+      }
+    }
+    // Skips the combinations with empty supports, too.
+    if (!SupportSizesBounded(supports)) {
+      continue;
+    }
+    // Thread time, the LPs of the threads add up.
+    Clock lp_beg(Clock::kThreadCpuTime);
+    const bool solved = solver.Solve();
+    *lp_duration += Clock(Clock::kThreadCpuTime) - lp_beg;
+    if (solved) {
+      ++num_found;
+      if ((visitor && !visitor(CreateMixedProfile(solver.solution(),
+                                                  player_vars))) ||
+          num_found >= max_num) {
+        break;
       }
     }
   }
-  duration_ = Clock() - beg;
-  return mixed_equilibria_.size();
+  return num_found;
 }
 
-bool EquilibriaFinder::NextSupports(vector<uint32_t>* supports) const {
+bool EquilibriaFinder::Symmetric() {
+  if (symmetric_ == -1) {
+    symmetric_ = game_.num_players() > 2 &&
+                 SymmetricGame::Create(game_, &symmetric_game_);
+  }
+  return symmetric_;
+}
+
+int EquilibriaFinder::NextSupports(const int64_t index,
+                                   vector<uint32_t>* supports,
+                                   int* strategy_id) const {
   assert(supports && static_cast<int>(supports->size()) == game_.num_players());
+  // From index to index + 1 the reflected Gray code flips the bit of the
+  // lowest set bit of index + 1.
+  int bit = __builtin_ctzll(index + 1);
+  int p = 0;
+  while (bit >= game_.num_strategies(p)) {
+    bit -= game_.num_strategies(p++);
+    assert(p < game_.num_players());
+  }
+  (*supports)[p] ^= 1u << bit;
+  *strategy_id = bit;
+  return p;
+}
+
+int64_t EquilibriaFinder::SolvePnsSupports(
+    const vector<vector<int> >& compl_map,
+    const vector<vector<int> >& player_vars, const MixedVisitor& visitor,
+    Lcp* lcp) {
+  size_t num_found = 0;
+  DenseSolver solver(*lcp);
+  for (SupportEnumerator it(game_, min_support_, max_support_); it.Next();) {
+    if (it.ConditionallyDominated()) {
+      continue;
+    }
+    SelectSupports(it.supports(), compl_map, lcp);
+    const bool solved = solver.Solve();
+    lp_duration_ += solver.duration();
+    if (solved) {
+      ++num_found;
+      if ((visitor && !visitor(CreateMixedProfile(solver.solution(),
+                                                  player_vars))) ||
+          num_found >= max_num_equilibria_) {
+        break;
+      }
+    }
+  }
+  return num_found;
+}
+
+int64_t EquilibriaFinder::SolvePolynomialSupports(const MixedVisitor& visitor) {
+  size_t num_found = 0;
+  PolynomialSolver solver(game_);
+  vector<MixedStrategyProfile> equilibria;
+  for (SupportEnumerator it(game_, min_support_, max_support_); it.Next();) {
+    if (it.ConditionallyDominated()) {
+      continue;
+    }
+    equilibria.clear();
+    Clock solve_beg;
+    solver.Solve(it.supports(), &equilibria);
+    lp_duration_ += Clock() - solve_beg;
+    for (auto jt = equilibria.begin(); jt != equilibria.end(); ++jt) {
+      ++num_found;
+      if ((visitor && !visitor(*jt)) || num_found >= max_num_equilibria_) {
+        return num_found;
+      }
+    }
+  }
+  return num_found;
+}
+
+bool EquilibriaFinder::SupportSizesBounded(
+    const vector<uint32_t>& supports) const {
+  for (auto it = supports.begin(); it != supports.end(); ++it) {
+    const int size = __builtin_popcount(*it);
+    if (size < min_support_ || size > max_support_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void EquilibriaFinder::SelectSupports(const vector<uint32_t>& supports,
+                                      const vector<vector<int> >& compl_map,
+                                      Lcp* lcp) const {
   const int num_players = game_.num_players();
-  int i = 0u;
-  while (i < num_players &&
-         (*supports)[i] == pow(2, game_.num_strategies(i)) - 1) {
-    (*supports)[i++] = 1u;
+  assert(static_cast<int>(compl_map.size()) == num_players);
+  for (int p = 0; p < num_players; ++p) {
+    const int num_strategies = game_.num_strategies(p);
+    assert(static_cast<int>(compl_map[p].size()) == num_strategies);
+    for (int s = 0; s < num_strategies; ++s) {
+      const int compl_fun_id = compl_map[p][s];
+      if (compl_fun_id != Lcp::kInvalidId) {
+        const int supported = (supports[p] & (1u << s)) != 0u;
+        lcp->SelectEquation(compl_fun_id, !supported, supported);
+      }
+    }
   }
-  if (i < num_players) {
-    ++(*supports)[i];
-    return true;
+}
+
+int64_t EquilibriaFinder::NumSupports() const {
+  int num_bits = 0;
+  for (int p = 0; p < game_.num_players(); ++p) {
+    num_bits += game_.num_strategies(p);
+  }
+  assert(num_bits < 63);
+  return int64_t(1) << num_bits;
+}
+
+void EquilibriaFinder::Supports(int64_t index,
+                                vector<uint32_t>* supports) const {
+  assert(supports && static_cast<int>(supports->size()) == game_.num_players());
+  // Reflected Gray code over the concatenated supports, player 0 lowest.
+  uint64_t bits = index ^ (index >> 1);
+  for (int p = 0; p < game_.num_players(); ++p) {
+    const int num_strategies = game_.num_strategies(p);
+    (*supports)[p] = bits & ((uint64_t(1) << num_strategies) - 1);
+    bits >>= num_strategies;
   }
-  return false;
 }
 
-void EquilibriaFinder::AddMixedEquilibrium(const vector<double>& probs,
-                                     const vector<vector<int> >& player_vars) {
+MixedStrategyProfile EquilibriaFinder::CreateMixedProfile(
+    const vector<double>& probs,
+    const vector<vector<int> >& player_vars) const {
   const int num_players = player_vars.size();
   MixedStrategyProfile profile(num_players);
   for (int p = 0; p < num_players; ++p) {
@@ -146,12 +412,13 @@ void EquilibriaFinder::AddMixedEquilibrium(const vector<double>& probs,
       profile.AddProbability(p, s, probs[player_vars[p][s]]);
     }
   }
-  mixed_equilibria_.push_back(profile);
+  return profile;
 }
 
 void EquilibriaFinder::Reset() {
   equilibria_.clear();
   mixed_equilibria_.clear();
+  cliques_.clear();
   duration_ = 0;
   lcp_duration_ = 0;
   lp_duration_ = 0;
@@ -165,6 +432,69 @@ int EquilibriaFinder::max_num_equilibria() const {
   return max_num_equilibria_;
 }
 
+void EquilibriaFinder::specialized(const bool enabled) {
+  specialized_ = enabled;
+}
+
+bool EquilibriaFinder::specialized() const {
+  return specialized_;
+}
+
+void EquilibriaFinder::pns(const bool enabled) {
+  pns_ = enabled;
+}
+
+bool EquilibriaFinder::pns() const {
+  return pns_;
+}
+
+void EquilibriaFinder::lemke_howson(const bool enabled) {
+  lemke_howson_ = enabled;
+}
+
+bool EquilibriaFinder::lemke_howson() const {
+  return lemke_howson_;
+}
+
+void EquilibriaFinder::vertex_enumeration(const bool enabled) {
+  vertex_enumeration_ = enabled;
+}
+
+bool EquilibriaFinder::vertex_enumeration() const {
+  return vertex_enumeration_;
+}
+
+void EquilibriaFinder::symmetric_mixed(const bool enabled) {
+  symmetric_mixed_ = enabled;
+}
+
+bool EquilibriaFinder::symmetric_mixed() const {
+  return symmetric_mixed_;
+}
+
+void EquilibriaFinder::support_sizes(const int min_size, const int max_size) {
+  assert(min_size > 0 && min_size <= max_size);
+  min_support_ = min_size;
+  max_support_ = std::min(max_size, kMaxSupportSize);
+}
+
+int EquilibriaFinder::min_support() const {
+  return min_support_;
+}
+
+int EquilibriaFinder::max_support() const {
+  return max_support_;
+}
+
+void EquilibriaFinder::num_threads(const int num_threads) {
+  assert(num_threads > 0);
+  num_threads_ = num_threads;
+}
+
+int EquilibriaFinder::num_threads() const {
+  return num_threads_;
+}
+
 const Game& EquilibriaFinder::game() const {
   return game_;
 }
@@ -177,6 +507,10 @@ const vector<MixedStrategyProfile>& EquilibriaFinder::mixed_equilibria() const {
   return mixed_equilibria_;
 }
 
+const vector<VertexEnumerator::Clique>& EquilibriaFinder::cliques() const {
+  return cliques_;
+}
+
 Clock::Diff EquilibriaFinder::duration() const {
   return duration_;
 }
@@ -5,33 +5,150 @@
 #include <vector>
 #include "./clock.h"
 #include "./game.h"
+#include "./lcp.h"
+#include "./symmetric-game.h"
+#include "./vertex-enumerator.h"
 
 namespace ash {
 
 class EquilibriaFinder {
  public:
   explicit EquilibriaFinder(const Game& game);
+  // Finds the pure or mixed equilibria and keeps them in equilibria() or
+  // mixed_equilibria().
   int FindPure();
   int FindMixed();
+  // Same as above, but passes each equilibrium to given visitor as soon as it
+  // is found instead of keeping it, the visitor may stop the search. The
+  // two-player and symmetric solvers pass their equilibria after their search.
+  // Returns the number of visited equilibria. The mixed search of games of
+  // three or more players visits none if a player has more than 32
+  // strategies.
+  int64_t FindPure(const PureVisitor& visitor);
+  int64_t FindMixed(const MixedVisitor& visitor);
+  // Counts the pure equilibria without keeping any profiles.
+  int64_t CountPure();
   void Reset();
   void max_num_equilibria(const int max_num);
   int max_num_equilibria() const;
+  // Enables the fixed-size kernels for small two-player games and the count
+  // vector solvers for symmetric games of three or more players, on by
+  // default. The mixed count vector solver requires symmetric_mixed().
+  void specialized(const bool enabled);
+  bool specialized() const;
+  // Sets the number of threads of the generic pure equilibria search and of
+  // the support enumeration of the generic two-player mixed equilibria
+  // search. The durations are measured in wall time for more than one thread,
+  // the LP durations add up the time of all threads.
+  void num_threads(const int num_threads);
+  int num_threads() const;
+  // Enumerates the supports of the generic mixed equilibria search in the
+  // order of Porter, Nudelman and Shoham and skips conditionally dominated
+  // supports before solving their LPs, off by default. The search is serial
+  // and finds the first equilibrium early. Games of three or more players are
+  // always searched in this order.
+  void pns(const bool enabled);
+  bool pns() const;
+  // Finds the mixed equilibria of two-player games on the Lemke-Howson paths
+  // of all missing labels instead of enumerating the supports, off by
+  // default. The paths reach a subset of the equilibria, at most one per
+  // label, but each in few exact pivots.
+  void lemke_howson(const bool enabled);
+  bool lemke_howson() const;
+  // Finds all extreme mixed equilibria of two-player games by enumerating the
+  // vertices of the best response polytopes in exact arithmetic, off by
+  // default. Degenerate games are solved completely and each equilibrium is
+  // found once, the maximal cliques of the equilibria are kept in cliques().
+  void vertex_enumeration(const bool enabled);
+  bool vertex_enumeration() const;
+  // Searches symmetric games of three or more players for their symmetric
+  // mixed equilibria only, with the count vector solver, off by default. The
+  // pure and asymmetric mixed equilibria are not reported then.
+  void symmetric_mixed(const bool enabled);
+  bool symmetric_mixed() const;
+  // Bounds the support size of each player in the generic mixed equilibria
+  // search, 1 to 32 by default.
+  void support_sizes(const int min_size, const int max_size);
+  int min_support() const;
+  int max_support() const;
   const Game& game() const;
   const std::vector<StrategyProfile>& equilibria() const;
   const std::vector<MixedStrategyProfile>& mixed_equilibria() const;
+  // Returns the maximal cliques of the last vertex enumeration.
+  const std::vector<VertexEnumerator::Clique>& cliques() const;
   base::Clock::Diff duration() const;
   base::Clock::Diff lcp_duration() const;
   base::Clock::Diff lp_duration() const;
 
  private:
-  bool NextSupports(std::vector<uint32_t>* supports) const;
-  void AddMixedEquilibrium(const std::vector<double>& probs,
-                           const std::vector<std::vector<int> >& player_vars);
+  // Returns true if the game has three or more players and is symmetric, the
+  // symmetric game is detected once on first use.
+  bool Symmetric();
+  // Advances the supports of given combination index to the next combination
+  // by flipping one strategy in or out. Returns the player of the flipped
+  // strategy and sets the strategy.
+  int NextSupports(const int64_t index, std::vector<uint32_t>* supports,
+                   int* strategy_id) const;
+  // Returns true if the size of each support is within the bounds.
+  bool SupportSizesBounded(const std::vector<uint32_t>& supports) const;
+  // Selects the complementary equations of given supports in the LCP.
+  void SelectSupports(const std::vector<uint32_t>& supports,
+                      const std::vector<std::vector<int> >& compl_map,
+                      Lcp* lcp) const;
+  // Solves the LPs of the supports in the SupportEnumerator order, skipping
+  // the conditionally dominated ones. Returns the number of visited
+  // equilibria.
+  int64_t SolvePnsSupports(const std::vector<std::vector<int> >& compl_map,
+                           const std::vector<std::vector<int> >& player_vars,
+                           const MixedVisitor& visitor, Lcp* lcp);
+  // Solves the polynomial systems of the supports of games with three or more
+  // players in the SupportEnumerator order, skipping the conditionally
+  // dominated ones. Returns the number of visited equilibria.
+  int64_t SolvePolynomialSupports(const MixedVisitor& visitor);
+  // Returns the number of support combinations, including those with empty
+  // supports.
+  int64_t NumSupports() const;
+  // Sets the supports of given combination index, which enumerates the
+  // combinations in reflected Gray code order over the concatenated support
+  // bits of all players, player 0 lowest.
+  void Supports(int64_t index, std::vector<uint32_t>* supports) const;
+  // Solves the LP of each support combination, split into ranges of
+  // consecutive combinations, which the threads take in ascending order. Each
+  // task solves its range on its own copy of the LCP and the equilibria are
+  // visited in combination order. Returns the number of visited equilibria.
+  int64_t SolveSupports(const Lcp& lcp,
+                        const std::vector<std::vector<int> >& compl_map,
+                        const std::vector<std::vector<int> >& player_vars,
+                        const MixedVisitor& visitor);
+  // Solves the LPs of the support combinations in the range [beg, end) on
+  // given LCP until given number of equilibria is reached or the visitor
+  // stops, adds up the LP durations in thread time.
+  int64_t SolveSupports(const int64_t beg, const int64_t end,
+                        const size_t max_num,
+                        const std::vector<std::vector<int> >& compl_map,
+                        const std::vector<std::vector<int> >& player_vars,
+                        const MixedVisitor& visitor, Lcp* lcp,
+                        base::Clock::Diff* lp_duration) const;
+  MixedStrategyProfile CreateMixedProfile(
+      const std::vector<double>& probs,
+      const std::vector<std::vector<int> >& player_vars) const;
 
   const Game& game_;
   std::vector<StrategyProfile> equilibria_;
   std::vector<MixedStrategyProfile> mixed_equilibria_;
+  std::vector<VertexEnumerator::Clique> cliques_;
   size_t max_num_equilibria_;
+  bool specialized_;
+  int num_threads_;
+  bool pns_;
+  bool lemke_howson_;
+  bool vertex_enumeration_;
+  bool symmetric_mixed_;
+  int min_support_;
+  int max_support_;
+  // Detection state of the symmetric game: -1 unknown, 0 no, 1 yes.
+  int symmetric_;
+  SymmetricGame symmetric_game_;
   base::Clock::Diff duration_;
   base::Clock::Diff lcp_duration_;
   base::Clock::Diff lp_duration_;
@@ -1,5 +1,7 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./game-factory.h"
+#include <cassert>
+#include <map>
 #include <string>
 #include <vector>
 #include "./parser.h"
@@ -7,11 +9,17 @@
 
 using std::string;
 using std::vector;
+using std::map;
+using std::make_pair;
 
 namespace ash {
 
-Game GameFactory::Create(const parse::StrategicGame& parsed_game) {
-  Game game(parsed_game.name);
+// Adds the players, their strategies and the outcomes of the parsed game.
+// Outcomes with equal payoffs are added once, outcome_ids maps the parsed
+// outcome ids to the game outcome ids.
+static void AddStructure(const parse::StrategicGame& parsed_game,
+                         vector<int>* outcome_ids, Game* _game) {
+  Game& game = *_game;
   // Adding players and their strategies.
   const int num_parsed_players = parsed_game.players.size();
   for (int i = 0; i < num_parsed_players; ++i) {
@@ -28,24 +36,85 @@ Game GameFactory::Create(const parse::StrategicGame& parsed_game) {
     assert(p_id == game.num_players() - 1);
   }
   assert(game.num_players() == num_parsed_players);
-  // Adding outcomes.
-  Outcome null_outcome("null", vector<int>(game.num_players(), 0));
-  game.AddOutcome(null_outcome);
+  if (parsed_game.payoffs.size()) {
+    // The payoff version has no outcomes.
+    return;
+  }
+  // Adding outcomes, interned by their payoffs. The implicit null outcome is
+  // kept apart, so parsed outcomes with zero payoffs keep their names.
+  map<vector<int>, int> interned;
+  game.AddOutcome(Outcome("null", vector<int>(game.num_players(), 0)));
   const int num_parsed_outcomes = parsed_game.outcomes.size();
+  outcome_ids->assign(1, 0);
   for (int i = 0; i < num_parsed_outcomes; ++i) {
     const parse::Outcome& o = parsed_game.outcomes[i];
-    Outcome outcome(o.name, o.payoffs);
-    int o_id = game.AddOutcome(outcome);
-    assert(o_id == game.num_outcomes() - 1);
+    auto it = interned.find(o.payoffs);
+    if (it == interned.end()) {
+      const int o_id = game.AddOutcome(Outcome(o.name, o.payoffs));
+      assert(o_id == game.num_outcomes() - 1);
+      it = interned.insert(make_pair(o.payoffs, o_id)).first;
+    }
+    outcome_ids->push_back(it->second);
+  }
+  assert(game.num_outcomes() <= num_parsed_outcomes + 1);
+}
+
+// Applies the layout to the game with outcomes.
+static void ApplyLayout(const GameFactory::Layout layout, Game* game) {
+  if (layout == GameFactory::kTensor) {
+    game->FlattenPayoffs();
+  } else if (layout == GameFactory::kPacked) {
+    game->PackPayoffs();
+  }
+}
+
+Game GameFactory::Create(const parse::StrategicGame& parsed_game,
+                         const Layout layout) {
+  Game game(parsed_game.name);
+  vector<int> outcome_ids;
+  AddStructure(parsed_game, &outcome_ids, &game);
+  if (parsed_game.payoffs.size()) {
+    vector<vector<int> > payoffs(parsed_game.payoffs);
+    game.SwapDensePayoffs(&payoffs);
+    return game;
   }
-  assert(game.num_outcomes() == num_parsed_outcomes + 1);
   // Adding strategies and their payoffs.
-  const int num_profiles = game.num_strategy_profiles();
-  assert(num_profiles == static_cast<int>(parsed_game.payoff_indices.size()));
-  for (int i = 0; i < num_profiles; ++i) {
-    const int outcome_id = parsed_game.payoff_indices[i];
+  const int64_t num_profiles = game.num_strategy_profiles();
+  assert(num_profiles ==
+         static_cast<int64_t>(parsed_game.payoff_indices.size()));
+  for (int64_t i = 0; i < num_profiles; ++i) {
+    const int outcome_id = outcome_ids[parsed_game.payoff_indices[i]];
     game.SetPayoff(i, outcome_id);
   }
+  ApplyLayout(layout, &game);
+  return game;
+}
+
+Game GameFactory::Create(parse::StrategicGame* parsed_game,
+                         const Layout layout) {
+  assert(parsed_game);
+  Game game(parsed_game->name);
+  vector<int> outcome_ids;
+  AddStructure(*parsed_game, &outcome_ids, &game);
+  if (parsed_game->payoffs.size()) {
+    // The parsed payoffs are already laid out per player.
+    game.SwapDensePayoffs(&parsed_game->payoffs);
+    parsed_game->payoffs.clear();
+    return game;
+  }
+  assert(game.num_strategy_profiles() ==
+         static_cast<int64_t>(parsed_game->payoff_indices.size()));
+  vector<int> payoff_indices;
+  payoff_indices.swap(parsed_game->payoff_indices);
+  if (game.num_outcomes() < static_cast<int>(outcome_ids.size())) {
+    // Some outcomes were interned, their ids need to be remapped.
+    for (auto it = payoff_indices.begin(), end = payoff_indices.end();
+         it != end; ++it) {
+      *it = outcome_ids[*it];
+    }
+  }
+  game.SwapPayoffs(&payoff_indices);
+  ApplyLayout(layout, &game);
   return game;
 }
 
@@ -9,7 +9,21 @@ namespace parse { class StrategicGame; }
 class Game;
 
 struct GameFactory {
-  static Game Create(const parse::StrategicGame& parsed_game);
+  // Payoff layout of created games with outcomes. With kTensor the outcome
+  // payoffs are flattened once into one contiguous payoff array per player,
+  // which trades memory for direct payoff lookups in the solvers. With
+  // kPacked the outcome ids are bit-packed, which is the most compact layout
+  // for games with few distinct outcomes. Games without outcomes always use
+  // the tensor layout.
+  enum Layout { kOutcomes, kTensor, kPacked };
+
+  // Creates the game of the parsed game. Outcomes with equal payoff vectors
+  // are interned, named by their first occurrence.
+  static Game Create(const parse::StrategicGame& parsed_game,
+                     const Layout layout);
+  // Same as above, but takes over the payoff indices or payoffs of the parsed
+  // game instead of copying them, leaving the parsed game without them.
+  static Game Create(parse::StrategicGame* parsed_game, const Layout layout);
 };
 
 }  // namespace ash
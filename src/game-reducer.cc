@@ -0,0 +1,268 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./game-reducer.h"
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "./equation.h"
+#include "./lcp.h"
+#include "./lp-solver.h"
+
+using std::vector;
+using base::Clock;
+
+namespace ash {
+
+// Tolerance for the LP objective.
+static const double kEpsilon = 1e-9;
+
+GameReducer::GameReducer(const Game& game)
+    : game_(game),
+      strategies_(game.num_players()),
+      mixed_(false),
+      num_eliminated_(0),
+      duration_(0) {
+  for (int p = 0; p < game.num_players(); ++p) {
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      strategies_[p].push_back(s);
+    }
+  }
+}
+
+int GameReducer::Reduce() {
+  Clock beg;
+  const int num_before = num_eliminated_;
+  const int num_players = game_.num_players();
+  vector<vector<int> > rows;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    // Pure dominance is cheap, it runs until no player has a dominated
+    // strategy left, before any LP is solved.
+    for (int p = 0; p < num_players; ++p) {
+      PayoffRows(p, &rows);
+      int dominated = FindPureDominated(rows);
+      while (dominated != -1) {
+        Eliminate(p, dominated);
+        rows.erase(rows.begin() + dominated);
+        dominated = FindPureDominated(rows);
+        changed = true;
+      }
+    }
+    for (int p = 0; p < num_players && mixed_ && !changed; ++p) {
+      PayoffRows(p, &rows);
+      const int dominated = FindMixedDominated(rows);
+      if (dominated != -1) {
+        Eliminate(p, dominated);
+        changed = true;
+      }
+    }
+  }
+  duration_ += Clock() - beg;
+  return num_eliminated_ - num_before;
+}
+
+void GameReducer::PayoffRows(const int player_id,
+                             vector<vector<int> >* rows) const {
+  assert(rows);
+  const int num_players = game_.num_players();
+  const vector<int>& own = strategies_[player_id];
+  rows->assign(own.size(), vector<int>());
+  // Odometer over the remaining strategies of the other players.
+  vector<size_t> indices(num_players, 0);
+  int64_t base_id = 0;
+  for (int p = 0; p < num_players; ++p) {
+    if (p != player_id) {
+      base_id += strategies_[p][0] * game_.stride(p);
+    }
+  }
+  const int64_t stride = game_.stride(player_id);
+  while (true) {
+    for (size_t i = 0; i < own.size(); ++i) {
+      (*rows)[i].push_back(game_.payoff(base_id + own[i] * stride, player_id));
+    }
+    int p = 0;
+    for (; p < num_players; ++p) {
+      if (p == player_id) {
+        continue;
+      }
+      const vector<int>& strategies = strategies_[p];
+      base_id -= strategies[indices[p]] * game_.stride(p);
+      if (++indices[p] < strategies.size()) {
+        base_id += strategies[indices[p]] * game_.stride(p);
+        break;
+      }
+      indices[p] = 0;
+      base_id += strategies[0] * game_.stride(p);
+    }
+    if (p == num_players) {
+      break;
+    }
+  }
+}
+
+int GameReducer::FindPureDominated(const vector<vector<int> >& rows) const {
+  const int num_rows = rows.size();
+  for (int s = 0; s < num_rows; ++s) {
+    const int* row = &rows[s][0];
+    const size_t size = rows[s].size();
+    for (int t = 0; t < num_rows; ++t) {
+      if (t == s) {
+        continue;
+      }
+      // Counting instead of breaking keeps the loop free of branches.
+      const int* other = &rows[t][0];
+      size_t num_greater = 0;
+      for (size_t i = 0; i < size; ++i) {
+        num_greater += other[i] > row[i];
+      }
+      if (num_greater == size) {
+        return s;
+      }
+    }
+  }
+  return -1;
+}
+
+int GameReducer::FindMixedDominated(const vector<vector<int> >& rows) const {
+  const int num_rows = rows.size();
+  if (num_rows < 3) {
+    // With two strategies mixed dominance is pure dominance.
+    return -1;
+  }
+  const size_t size = rows[0].size();
+  double magnitude = 1.0;
+  for (int s = 0; s < num_rows; ++s) {
+    for (size_t o = 0; o < size; ++o) {
+      magnitude = std::max(magnitude, std::fabs(double(rows[s][o])));
+    }
+  }
+  for (int s = 0; s < num_rows; ++s) {
+    // Strategy s is strictly dominated iff the margin e of
+    // max e subject to sum_t x_t a(t, o) - e >= a(s, o) for all profiles o
+    // of the other players, sum_t x_t = 1 and x, e >= 0 is positive. Unlike
+    // a shift of the payoffs, the margin keeps the coefficients in range.
+    Lcp lp;
+    vector<int> vars(num_rows, Lcp::kInvalidId);
+    Equation sum(Equation::kEqual, 1);
+    for (int t = 0; t < num_rows; ++t) {
+      if (t != s) {
+        vars[t] = lp.AddVariable("x");
+        sum.AddSummand(1, vars[t]);
+      }
+    }
+    const int margin = lp.AddVariable("e");
+    Objective objective(Objective::kMax);
+    objective.AddSummand(1, margin);
+    for (size_t o = 0; o < size; ++o) {
+      Equation e(Equation::kGreaterEqual, rows[s][o]);
+      for (int t = 0; t < num_rows; ++t) {
+        if (t != s) {
+          e.AddSummand(rows[t][o], vars[t]);
+        }
+      }
+      e.AddSummand(-1, margin);
+      lp.AddEquation(e);
+    }
+    lp.AddEquation(sum);
+    lp.SelectObjective(lp.AddObjective(objective));
+    LpSolver solver(lp);
+    if (!solver.Solve()) {
+      continue;
+    }
+    if (solver.solution()[margin] > kEpsilon * magnitude) {
+      return s;
+    }
+  }
+  return -1;
+}
+
+void GameReducer::Eliminate(const int player_id, const int index) {
+  vector<int>& strategies = strategies_[player_id];
+  assert(strategies.size() > 1u);
+  strategies.erase(strategies.begin() + index);
+  ++num_eliminated_;
+}
+
+Game GameReducer::ReducedGame() const {
+  const int num_players = game_.num_players();
+  Game reduced(game_.name());
+  for (int p = 0; p < num_players; ++p) {
+    const Player& original = game_.player(p);
+    Player player(original.name());
+    const vector<int>& strategies = strategies_[p];
+    for (auto it = strategies.begin(); it != strategies.end(); ++it) {
+      player.AddStrategy(
+          reduced.AddStrategy(game_.strategy(original.strategy(*it))));
+    }
+    reduced.AddPlayer(player);
+  }
+  const int64_t num_profiles = reduced.num_strategy_profiles();
+  vector<vector<int> > payoffs(num_players, vector<int>(num_profiles));
+  for (ProfileIterator it(reduced); !it.done(); it.Next()) {
+    const StrategyProfile original = Expand(it.profile());
+    int64_t id = 0;
+    for (int p = 0; p < num_players; ++p) {
+      id += original[p] * game_.stride(p);
+    }
+    for (int p = 0; p < num_players; ++p) {
+      payoffs[p][it.id()] = game_.payoff(id, p);
+    }
+  }
+  reduced.SwapDensePayoffs(&payoffs);
+  return reduced;
+}
+
+StrategyProfile GameReducer::Expand(const StrategyProfile& profile) const {
+  assert(profile.size() == game_.num_players());
+  StrategyProfile expanded(profile);
+  for (int p = 0; p < profile.size(); ++p) {
+    expanded.strategy(p, strategy(p, profile[p]));
+  }
+  return expanded;
+}
+
+MixedStrategyProfile GameReducer::Expand(
+    const MixedStrategyProfile& profile) const {
+  const int num_players = game_.num_players();
+  MixedStrategyProfile expanded(num_players);
+  for (int p = 0; p < num_players; ++p) {
+    expanded.SetNumStrategies(p, game_.num_strategies(p));
+    for (int i = 0; i < num_strategies(p); ++i) {
+      expanded.AddProbability(p, strategy(p, i), profile.probability(p, i));
+    }
+  }
+  return expanded;
+}
+
+void GameReducer::mixed(const bool enabled) {
+  mixed_ = enabled;
+}
+
+bool GameReducer::mixed() const {
+  return mixed_;
+}
+
+const Game& GameReducer::game() const {
+  return game_;
+}
+
+int GameReducer::strategy(const int player_id, const int index) const {
+  assert(index >= 0 && index < num_strategies(player_id));
+  return strategies_[player_id][index];
+}
+
+int GameReducer::num_strategies(const int player_id) const {
+  assert(player_id >= 0 && player_id < game_.num_players());
+  return strategies_[player_id].size();
+}
+
+int GameReducer::num_eliminated() const {
+  return num_eliminated_;
+}
+
+Clock::Diff GameReducer::duration() const {
+  return duration_;
+}
+
+}  // namespace ash
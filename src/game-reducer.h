@@ -0,0 +1,64 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_GAME_REDUCER_H_
+#define SRC_GAME_REDUCER_H_
+
+#include <vector>
+#include "./clock.h"
+#include "./game.h"
+
+namespace ash {
+
+// Iterated elimination of strictly dominated strategies. A strictly dominated
+// strategy is played in no Nash equilibrium, therefore the reduced game has
+// the same equilibria as the original game, with the eliminated strategies
+// at probability zero. The reducer maps the equilibria of the reduced game
+// back to the strategies of the original game.
+class GameReducer {
+ public:
+  explicit GameReducer(const Game& game);
+  // Eliminates the strategies, which are strictly dominated by another
+  // remaining pure strategy or, if enabled, by a mixed strategy over the
+  // remaining strategies, until none is left. Returns the number of
+  // eliminated strategies.
+  int Reduce();
+  // Returns the game restricted to the remaining strategies.
+  Game ReducedGame() const;
+  // Returns given profile of the reduced game in the original game.
+  StrategyProfile Expand(const StrategyProfile& profile) const;
+  MixedStrategyProfile Expand(const MixedStrategyProfile& profile) const;
+  // Enables the dominance check by mixed strategies, which solves one LP per
+  // strategy over the remaining profiles of the other players.
+  void mixed(const bool enabled);
+  bool mixed() const;
+  // Returns the original game.
+  const Game& game() const;
+  // Returns the original strategy index of the remaining strategy at given
+  // index.
+  int strategy(const int player_id, const int index) const;
+  int num_strategies(const int player_id) const;
+  int num_eliminated() const;
+  base::Clock::Diff duration() const;
+
+ private:
+  // Sets the payoff rows of given player, one per remaining strategy over the
+  // remaining profiles of the other players.
+  void PayoffRows(const int player_id,
+                  std::vector<std::vector<int> >* rows) const;
+  // Returns the index of a remaining strategy of given player, which is
+  // strictly dominated by another remaining pure strategy, or -1.
+  int FindPureDominated(const std::vector<std::vector<int> >& rows) const;
+  // Returns the index of a remaining strategy of given player, which is
+  // strictly dominated by a mixed strategy, or -1.
+  int FindMixedDominated(const std::vector<std::vector<int> >& rows) const;
+  void Eliminate(const int player_id, const int index);
+
+  const Game& game_;
+  // The original strategy indices of the remaining strategies per player.
+  std::vector<std::vector<int> > strategies_;
+  bool mixed_;
+  int num_eliminated_;
+  base::Clock::Diff duration_;
+};
+
+}  // namespace ash
+#endif  // SRC_GAME_REDUCER_H_
@@ -2,14 +2,19 @@
 #include "./game.h"
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <algorithm>
 #include <numeric>
+#include <utility>
 
 using std::string;
 using std::stringstream;
 using std::vector;
 using std::max;
+using std::numeric_limits;
+using std::shared_ptr;
 using std::pow;
 using std::accumulate;
 
@@ -44,6 +49,10 @@ const vector<int>& Outcome::payoffs() const {
   return payoffs_;
 }
 
+const string& Outcome::name() const {
+  return name_;
+}
+
 StrategyProfile::StrategyProfile(const vector<int>& strategies)
     : strategies_(strategies) {}
 
@@ -142,16 +151,82 @@ string MixedStrategyProfile::str(const Game& game) const {
   return ss.str();
 }
 
+ProfileIterator::ProfileIterator(const Game& game)
+    : game_(game),
+      profile_(game.num_players(), 0),
+      id_(0),
+      fixed_player_id_(Game::kInvalidId),
+      done_(game.num_strategy_profiles() == 0) {}
+
+ProfileIterator::ProfileIterator(const Game& game, const int fixed_player_id,
+                                 const int fixed_strategy_id)
+    : game_(game),
+      profile_(game.num_players(), 0),
+      id_(fixed_strategy_id * game.stride(fixed_player_id)),
+      fixed_player_id_(fixed_player_id),
+      done_(game.num_strategy_profiles() == 0) {
+  assert(fixed_strategy_id >= 0 &&
+         fixed_strategy_id < game.num_strategies(fixed_player_id));
+  profile_.strategy(fixed_player_id, fixed_strategy_id);
+}
+
+void ProfileIterator::Next() {
+  assert(!done_);
+  const int num_players = game_.num_players();
+  for (int p = 0; p < num_players; ++p) {
+    if (p == fixed_player_id_) {
+      continue;
+    }
+    const int s = profile_[p];
+    if (s + 1 < game_.num_strategies(p)) {
+      profile_.strategy(p, s + 1);
+      id_ += game_.stride(p);
+      return;
+    }
+    // Roll over to the first strategy and carry on to the next player.
+    profile_.strategy(p, 0);
+    id_ -= s * game_.stride(p);
+  }
+  done_ = true;
+}
+
+bool ProfileIterator::done() const {
+  return done_;
+}
+
+const StrategyProfile& ProfileIterator::profile() const {
+  return profile_;
+}
+
+int64_t ProfileIterator::id() const {
+  return id_;
+}
+
+int64_t ProfileIterator::deviation(const int player_id,
+                                   const int strategy_id) const {
+  assert(strategy_id >= 0 && strategy_id < game_.num_strategies(player_id));
+  return id_ + (strategy_id - profile_[player_id]) * game_.stride(player_id);
+}
+
 const int Game::kInvalidId = -1;
 
 Game::Game(const std::string& name)
     : name_(name),
+      num_strategy_profiles_(0),
       zero_sum_(true) {}
 
 int Game::AddPlayer(const Player& p) {
-  const int space = max(static_cast<size_t>(p.num_strategies()),
-                        p.num_strategies() * payoff_indices_.size());
-  payoff_indices_.resize(space, kInvalidId);
+  assert(p.num_strategies() > 0);
+  // The profile ids have to stay representable.
+  assert(num_strategy_profiles_ <=
+         numeric_limits<int64_t>::max() / p.num_strategies());
+  strides_.push_back(players_.empty() ? 1 : num_strategy_profiles_);
+  num_strategy_profiles_ = max<int64_t>(p.num_strategies(),
+                                        p.num_strategies() *
+                                        num_strategy_profiles_);
+  if (payoff_indices_.size()) {
+    payoff_indices_.resize(num_strategy_profiles_, kInvalidId);
+  }
   players_.push_back(p);
   return players_.size() - 1;
 }
@@ -162,8 +237,8 @@ int Game::AddStrategy(const std::string& name) {
 }
 
 int Game::AddOutcome(const Outcome& o) {
-  zero_sum_ = zero_sum_ &&
-              accumulate(o.payoffs().begin(), o.payoffs().end(), 0) == 0;
+  zero_sum_ = zero_sum_ && accumulate(o.payoffs().begin(), o.payoffs().end(),
+                                      int64_t(0)) == 0;
   outcomes_.push_back(o);
   return outcomes_.size() - 1;
 }
@@ -172,20 +247,127 @@ void Game::SetPayoff(const StrategyProfile& profile, const int outcome_id) {
   SetPayoff(StrategyProfileId(profile), outcome_id);
 }
 
-void Game::SetPayoff(const int sp_id, const int outcome_id) {
+void Game::SetPayoff(const int64_t sp_id, const int outcome_id) {
   assert(sp_id >= 0 && sp_id < num_strategy_profiles());
+  assert(!dense() && !packed());
+  if (payoff_indices_.empty()) {
+    payoff_indices_.resize(num_strategy_profiles_, kInvalidId);
+  }
   payoff_indices_[sp_id] = outcome_id;
 }
 
-StrategyProfile Game::CreateProfile(const int sp_id) const {
+void Game::SwapPayoffs(vector<int>* outcome_ids) {
+  assert(outcome_ids &&
+         static_cast<int64_t>(outcome_ids->size()) == num_strategy_profiles_);
+  assert(!dense() && !packed());
+  payoff_indices_ = base::Array<int>(outcome_ids);
+}
+
+void Game::SwapDensePayoffs(vector<vector<int> >* payoffs) {
+  assert(payoffs && static_cast<int>(payoffs->size()) == num_players());
+  const int _num_players = num_players();
+  bool zero_sum = true;
+  for (int64_t sp = 0; sp < num_strategy_profiles_ && zero_sum; ++sp) {
+    int64_t sum = 0;
+    for (int p = 0; p < _num_players; ++p) {
+      assert(static_cast<int64_t>((*payoffs)[p].size()) ==
+             num_strategy_profiles_);
+      sum += (*payoffs)[p][sp];
+    }
+    zero_sum = sum == 0;
+  }
+  assert(outcomes_.empty() && payoff_indices_.empty());
+  payoffs_.clear();
+  for (int p = 0; p < _num_players; ++p) {
+    payoffs_.push_back(base::Array<int>(&(*payoffs)[p]));
+  }
+  zero_sum_ = zero_sum;
+}
+
+void Game::SetPayoffs(const base::Array<int>& outcome_ids) {
+  assert(static_cast<int64_t>(outcome_ids.size()) == num_strategy_profiles_);
+  assert(!dense() && !packed());
+  payoff_indices_ = outcome_ids;
+}
+
+void Game::SetDensePayoffs(const vector<base::Array<int> >& payoffs,
+                           const bool zero_sum) {
+  assert(static_cast<int>(payoffs.size()) == num_players());
+  payoffs_ = payoffs;
+  zero_sum_ = zero_sum;
+}
+
+void Game::FlattenPayoffs() {
+  assert(static_cast<int64_t>(payoff_indices_.size()) ==
+         num_strategy_profiles_ || packed());
+  const int _num_players = num_players();
+  vector<vector<int> > payoffs(_num_players,
+                               vector<int>(num_strategy_profiles_, 0));
+  vector<int*> player_payoffs(_num_players);
+  for (int p = 0; p < _num_players; ++p) {
+    player_payoffs[p] = payoffs[p].data();
+  }
+  WritePayoffs(player_payoffs);
+  payoffs_.clear();
+  for (int p = 0; p < _num_players; ++p) {
+    payoffs_.push_back(base::Array<int>(&payoffs[p]));
+  }
+}
+
+bool Game::FlattenPayoffs(const string& path) {
+  assert(static_cast<int64_t>(payoff_indices_.size()) ==
+         num_strategy_profiles_ || packed());
+  const int _num_players = num_players();
+  const size_t player_size = num_strategy_profiles_ * sizeof(int);
+  shared_ptr<base::MappedFile> file(
+      new base::MappedFile(path, _num_players * player_size));
+  if (!file->good()) {
+    return false;
+  }
+  vector<int*> player_payoffs(_num_players);
+  for (int p = 0; p < _num_players; ++p) {
+    player_payoffs[p] = reinterpret_cast<int*>(file->mutable_data() +
+                                               p * player_size);
+  }
+  WritePayoffs(player_payoffs);
+  payoffs_.clear();
+  for (int p = 0; p < _num_players; ++p) {
+    payoffs_.push_back(base::Array<int>(file, p * player_size,
+                                        num_strategy_profiles_));
+  }
+  return true;
+}
+
+void Game::WritePayoffs(const vector<int*>& payoffs) const {
+  const int _num_players = num_players();
+  for (int64_t sp = 0; sp < num_strategy_profiles_; ++sp) {
+    const vector<int>& outcome_payoffs = outcomes_[payoff_index(sp)].payoffs();
+    for (int p = 0; p < _num_players; ++p) {
+      payoffs[p][sp] = outcome_payoffs[p];
+    }
+  }
+}
+
+void Game::PackPayoffs() {
+  assert(static_cast<int64_t>(payoff_indices_.size()) ==
+         num_strategy_profiles_);
+  assert(num_outcomes() > 0);
+  base::PackedArray packed_indices(num_strategy_profiles_,
+                                   num_outcomes() - 1);
+  const base::Array<int>& payoff_indices = payoff_indices_;
+  for (int64_t sp = 0; sp < num_strategy_profiles_; ++sp) {
+    packed_indices.set(sp, payoff_indices[sp]);
+  }
+  payoff_indices_ = base::Array<int>();
+  packed_indices_ = std::move(packed_indices);
+}
+
+StrategyProfile Game::CreateProfile(const int64_t sp_id) const {
   assert(sp_id >= 0 && sp_id < num_strategy_profiles());
   const int _num_players = num_players();
   StrategyProfile profile(_num_players, 0);
-  int product = 1;
   for (int i = 0; i < _num_players; ++i) {
-    const int num_player_strategies = player(i).num_strategies();
-    profile.strategy(i, (sp_id / product) % num_player_strategies);
-    product *= player(i).num_strategies();
+    profile.strategy(i, (sp_id / strides_[i]) % player(i).num_strategies());
   }
   return profile;
 }
@@ -200,22 +382,48 @@ const string& Game::strategy(const int id) const {
   return strategies_[id];
 }
 
-const vector<int>& Game::payoff(const StrategyProfile& profile) const {
+vector<int> Game::payoff(const StrategyProfile& profile) const {
   assert(Valid(profile));
-  const int sp_id = StrategyProfileId(profile);
-  const vector<int>& payoffs = outcomes_[payoff_indices_[sp_id]].payoffs();
+  const int64_t sp_id = StrategyProfileId(profile);
+  if (dense()) {
+    const int _num_players = num_players();
+    vector<int> payoffs(_num_players);
+    for (int p = 0; p < _num_players; ++p) {
+      payoffs[p] = payoffs_[p][sp_id];
+    }
+    return payoffs;
+  }
+  const vector<int>& payoffs = outcomes_[payoff_index(sp_id)].payoffs();
   assert(static_cast<int>(payoffs.size()) == profile.size());
   return payoffs;
 }
 
-int Game::StrategyProfileId(const StrategyProfile& profile) const {
+int Game::payoff(const StrategyProfile& profile, const int player_id) const {
+  assert(Valid(profile));
+  return payoff(StrategyProfileId(profile), player_id);
+}
+
+const int* Game::payoffs(const int player_id) const {
+  assert(dense());
+  assert(player_id >= 0 && player_id < num_players());
+  return payoffs_[player_id].data();
+}
+
+const string& Game::name() const {
+  return name_;
+}
+
+const Outcome& Game::outcome(const int id) const {
+  assert(id >= 0 && id < num_outcomes());
+  return outcomes_[id];
+}
+
+int64_t Game::StrategyProfileId(const StrategyProfile& profile) const {
   const int _num_players = num_players();
   assert(_num_players == static_cast<int>(profile.size()));
-  int product = 1;
-  int index = 0;
+  int64_t index = 0;
   for (int i = 0; i < _num_players; ++i) {
-    index += profile[i] * product;
-    product *= player(i).num_strategies();
+    index += profile[i] * strides_[i];
   }
   return index;
 }
@@ -232,8 +440,13 @@ bool Game::Valid(const StrategyProfile& profile) const {
   return true;
 }
 
-int Game::num_strategy_profiles() const {
-  return payoff_indices_.size();
+int64_t Game::num_strategy_profiles() const {
+  return num_strategy_profiles_;
+}
+
+int64_t Game::stride(const int player_id) const {
+  assert(player_id >= 0 && player_id < num_players());
+  return strides_[player_id];
 }
 
 int Game::num_players() const {
@@ -256,4 +469,17 @@ bool Game::zero_sum() const {
   return zero_sum_;
 }
 
+bool Game::packed() const {
+  return !packed_indices_.empty();
+}
+
+bool Game::dense() const {
+  return payoffs_.size();
+}
+
+bool Game::mapped() const {
+  return payoff_indices_.mapped() ||
+         (!payoffs_.empty() && payoffs_[0].mapped());
+}
+
 }  // namespace ash
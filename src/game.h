@@ -2,8 +2,13 @@
 #ifndef SRC_GAME_H_
 #define SRC_GAME_H_
 
+#include <cassert>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
+#include "./array.h"
+#include "./packed-array.h"
 
 namespace ash {
 
@@ -25,6 +30,7 @@ class Outcome {
  public:
   Outcome(const std::string& name, const std::vector<int>& payoffs);
   const std::vector<int>& payoffs() const;
+  const std::string& name() const;
 
  private:
   std::vector<int> payoffs_;
@@ -61,6 +67,37 @@ class MixedStrategyProfile {
   std::vector<std::vector<float> > probs_;
 };
 
+// Visitors of the equilibria of a search, called as each equilibrium is
+// found. Returning false stops the search.
+typedef std::function<bool(const StrategyProfile&)> PureVisitor;
+typedef std::function<bool(const MixedStrategyProfile&)> MixedVisitor;
+
+// Odometer over the strategy profiles of a game in ascending id order, which
+// updates the profile and its id incrementally. Optionally the strategy of
+// one player stays fixed, then only the profiles with that strategy are
+// visited.
+// Usage: for (ProfileIterator it(game); !it.done(); it.Next()) { ... }
+class ProfileIterator {
+ public:
+  explicit ProfileIterator(const Game& game);
+  ProfileIterator(const Game& game, const int fixed_player_id,
+                  const int fixed_strategy_id);
+  void Next();
+  bool done() const;
+  const StrategyProfile& profile() const;
+  int64_t id() const;
+  // Returns the id of the profile, in which given player unilaterally
+  // deviates to given strategy, by stepping along the player's stride.
+  int64_t deviation(const int player_id, const int strategy_id) const;
+
+ private:
+  const Game& game_;
+  StrategyProfile profile_;
+  int64_t id_;
+  int fixed_player_id_;
+  bool done_;
+};
+
 class Game {
  public:
   static const int kInvalidId;
@@ -70,30 +107,99 @@ class Game {
   int AddStrategy(const std::string& name);
   int AddOutcome(const Outcome& o);
   void SetPayoff(const StrategyProfile& profile, const int outcome_id);
-  void SetPayoff(const int sp_id, const int outcome_id);
-  StrategyProfile CreateProfile(const int sp_id) const;
-
-  const std::vector<int>& payoff(const StrategyProfile& profile) const;
+  void SetPayoff(const int64_t sp_id, const int outcome_id);
+  // Takes over the outcome ids of all strategy profiles by swapping them out
+  // of given vector.
+  void SwapPayoffs(std::vector<int>* outcome_ids);
+  // Takes over the payoffs of all players by swapping them out of given
+  // vector, which holds one payoff vector per player indexed by strategy
+  // profile id. Games defined this way have no outcomes.
+  void SwapDensePayoffs(std::vector<std::vector<int> >* payoffs);
+  // Sets the outcome ids of all strategy profiles, which may reside in a
+  // memory-mapped file.
+  void SetPayoffs(const base::Array<int>& outcome_ids);
+  // Sets the payoffs of all players like SwapDensePayoffs, which may reside in
+  // a memory-mapped file. The zero-sum property is given instead of computed.
+  // For games with outcomes the payoffs have to match the outcome payoffs.
+  void SetDensePayoffs(const std::vector<base::Array<int> >& payoffs,
+                       const bool zero_sum);
+  // Flattens the outcome payoffs into one contiguous payoff array per player
+  // indexed by strategy profile id, which is used by all payoff lookups
+  // afterwards. The outcomes stay available.
+  void FlattenPayoffs();
+  // Same as above, but places the payoff arrays in a memory-mapped scratch
+  // file at given path instead of the heap, so that games larger than memory
+  // can be scanned sequentially. Returns false if the file could not be
+  // mapped, the payoffs stay unchanged then.
+  bool FlattenPayoffs(const std::string& path);
+  // Packs the outcome ids of all strategy profiles at the narrowest bit width
+  // fitting the number of outcomes, which cuts their memory by up to 32
+  // times for games with few distinct outcomes. Lookups stay O(1).
+  void PackPayoffs();
+  StrategyProfile CreateProfile(const int64_t sp_id) const;
+
+  std::vector<int> payoff(const StrategyProfile& profile) const;
+  int payoff(const StrategyProfile& profile, const int player_id) const;
+  inline int payoff(const int64_t sp_id, const int player_id) const;
+  // Returns the flattened payoff array of given player.
+  const int* payoffs(const int player_id) const;
+  inline int payoff_index(const int64_t sp_id) const;
+  const std::string& name() const;
   const Player& player(const int id) const;
+  const Outcome& outcome(const int id) const;
   const std::string& strategy(const int id) const;
-  int num_strategy_profiles() const;
+  int64_t num_strategy_profiles() const;
+  // Returns the id distance between profiles, which differ only in the
+  // strategy of given player by one.
+  int64_t stride(const int player_id) const;
   int num_players() const;
   int num_strategies() const;
   int num_strategies(const int player_id) const;
   int num_outcomes() const;
   bool zero_sum() const;
+  // Returns true if the payoffs are stored in flattened per-player arrays.
+  bool dense() const;
+  // Returns true if the outcome ids are bit-packed.
+  bool packed() const;
+  // Returns true if the payoffs or outcome ids reside in a memory-mapped
+  // file.
+  bool mapped() const;
 
  private:
-  int StrategyProfileId(const StrategyProfile& profile) const;
+  int64_t StrategyProfileId(const StrategyProfile& profile) const;
   bool Valid(const StrategyProfile& profile) const;
+  // Writes the outcome payoffs into given per-player payoff arrays.
+  void WritePayoffs(const std::vector<int*>& payoffs) const;
 
   std::vector<Player> players_;
+  std::vector<int64_t> strides_;
   std::vector<Outcome> outcomes_;
-  std::vector<int> payoff_indices_;
+  base::Array<int> payoff_indices_;
+  base::PackedArray packed_indices_;
+  std::vector<base::Array<int> > payoffs_;
   std::vector<std::string> strategies_;
   std::string name_;
+  int64_t num_strategy_profiles_;
   bool zero_sum_;
 };
 
+inline int Game::payoff(const int64_t sp_id, const int player_id) const {
+  assert(sp_id >= 0 && sp_id < num_strategy_profiles());
+  assert(player_id >= 0 && player_id < num_players());
+  if (!payoffs_.empty()) {
+    return payoffs_[player_id][sp_id];
+  }
+  return outcomes_[payoff_index(sp_id)].payoffs()[player_id];
+}
+
+inline int Game::payoff_index(const int64_t sp_id) const {
+  assert(sp_id >= 0 && sp_id < num_strategy_profiles());
+  if (!packed_indices_.empty()) {
+    return packed_indices_[sp_id];
+  }
+  assert(!payoff_indices_.empty());
+  return payoff_indices_[sp_id];
+}
+
 }  // namespace ash
 #endif  // SRC_GAME_H_
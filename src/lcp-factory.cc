@@ -62,13 +62,10 @@ Lcp LcpFactory::Create(const Game& game, vector<vector<int> >* _compl_map,
       lcp.AddEquation(e);
       Equation e2(Equation::kGreaterEqual, 0);
       e2.AddSummand(1, payoff_var_id);
-      const int num_strategy_profiles = game.num_strategy_profiles();
-      for (int sp = 0; sp < num_strategy_profiles; ++sp) {
-        const StrategyProfile profile = game.CreateProfile(sp);
-        if (profile[p] != s) {
-          continue;
-        }
-        const int p_payoff = game.payoff(profile)[p];
+      // Visit only the profiles in which player p plays strategy s.
+      for (ProfileIterator it(game, p, s); !it.done(); it.Next()) {
+        const StrategyProfile& profile = it.profile();
+        const int p_payoff = game.payoff(it.id(), p);
         for (int p2 = 0; p2 < num_players; ++p2) {
           if (p2 == p) {
             continue;
@@ -86,6 +86,15 @@ const Equation& Lcp::selected_equation(const int id) const {
   return compl_equations_[index + 1];
 }
 
+const Equation& Lcp::compl_equation(const int id) const {
+  assert(id >= 0 && id < static_cast<int>(compl_equations_.size()));
+  return compl_equations_[id];
+}
+
+bool Lcp::compl_active(const int id) const {
+  assert(id >= 0 && id < static_cast<int>(compl_active_.size()));
+  return compl_active_[id];
+}
 
 int Lcp::num_linear() const {
   return equations_.size();
@@ -28,6 +28,10 @@ class Lcp {
   const Objective& selected_objective() const;
   const Equation& equation(const int id) const;
   const Equation& selected_equation(const int id) const;
+  // Returns the complementary equation or its selection state by its id as
+  // used by SelectEquation, the pair of equations id / 2.
+  const Equation& compl_equation(const int id) const;
+  bool compl_active(const int id) const;
 
   int num_linear() const;
   int num_complementary() const;
@@ -0,0 +1,240 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./lemke-howson.h"
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <vector>
+
+using std::vector;
+using std::set;
+using std::numeric_limits;
+
+namespace ash {
+
+// Returns the greatest common divisor of given non-negative numbers.
+static int64_t Gcd(int64_t a, int64_t b) {
+  while (b) {
+    const int64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+LemkeHowson::LemkeHowson(const Game& game)
+    : m_(game.num_strategies(0)),
+      n_(game.num_players() == 2 ? game.num_strategies(1) : 0),
+      payoffs_(2, vector<int64_t>(game.num_strategy_profiles())),
+      num_pivots_(0) {
+  assert(game.num_players() == 2);
+  for (int p = 0; p < 2; ++p) {
+    // Positive payoffs keep the best response polytopes bounded.
+    int min_payoff = numeric_limits<int>::max();
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      min_payoff = std::min(min_payoff, game.payoff(id, p));
+    }
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      payoffs_[p][id] = int64_t(game.payoff(id, p)) - min_payoff + 1;
+    }
+  }
+}
+
+void LemkeHowson::Reset() {
+  const int num_cols = num_labels() + 1;
+  // Player 0: A y + r = 1, the slacks r are basic.
+  Tableau& t0 = tableaux_[0];
+  t0.rows.assign(m_, vector<int64_t>(num_cols, 0));
+  t0.basis.resize(m_);
+  t0.denominator = 1;
+  t0.first_slack = 0;
+  t0.num_slacks = m_;
+  for (int i = 0; i < m_; ++i) {
+    t0.rows[i][i] = 1;
+    for (int j = 0; j < n_; ++j) {
+      t0.rows[i][m_ + j] = payoffs_[0][i + j * m_];
+    }
+    t0.rows[i][num_cols - 1] = 1;
+    t0.basis[i] = i;
+  }
+  // Player 1: B^T x + s = 1, the slacks s are basic.
+  Tableau& t1 = tableaux_[1];
+  t1.rows.assign(n_, vector<int64_t>(num_cols, 0));
+  t1.basis.resize(n_);
+  t1.denominator = 1;
+  t1.first_slack = m_;
+  t1.num_slacks = n_;
+  for (int j = 0; j < n_; ++j) {
+    for (int i = 0; i < m_; ++i) {
+      t1.rows[j][i] = payoffs_[1][i + j * m_];
+    }
+    t1.rows[j][m_ + j] = 1;
+    t1.rows[j][num_cols - 1] = 1;
+    t1.basis[j] = m_ + j;
+  }
+}
+
+bool LemkeHowson::Solve(const int missing_label,
+                        MixedStrategyProfile* equilibrium) {
+  num_pivots_ = 0;
+  if (!FollowPath(missing_label)) {
+    return false;
+  }
+  *equilibrium = Equilibrium(Strategy(tableaux_[1], 0, m_),
+                             Strategy(tableaux_[0], m_, n_));
+  return true;
+}
+
+int64_t LemkeHowson::FindMixed(const size_t max_num,
+                               const MixedVisitor& visitor) {
+  num_pivots_ = 0;
+  // Different paths may end in the same equilibrium, the reduced integer
+  // strategies identify it exactly.
+  set<vector<int64_t> > found;
+  int64_t num_found = 0;
+  for (int label = 0; label < num_labels(); ++label) {
+    if (!FollowPath(label)) {
+      continue;
+    }
+    const vector<int64_t> x = Strategy(tableaux_[1], 0, m_);
+    const vector<int64_t> y = Strategy(tableaux_[0], m_, n_);
+    vector<int64_t> key(x);
+    key.insert(key.end(), y.begin(), y.end());
+    if (!found.insert(key).second) {
+      continue;
+    }
+    ++num_found;
+    if ((visitor && !visitor(Equilibrium(x, y))) ||
+        size_t(num_found) >= max_num) {
+      break;
+    }
+  }
+  return num_found;
+}
+
+bool LemkeHowson::FollowPath(const int missing_label) {
+  assert(missing_label >= 0 && missing_label < num_labels());
+  Reset();
+  int label = missing_label;
+  // The variable of the missing label enters the tableau, in which it is
+  // non-basic, the leaving label enters the other tableau next.
+  int t = label < m_ ? 1 : 0;
+  while (true) {
+    const int row = LeavingRow(tableaux_[t], label);
+    assert(row != -1);
+    const int leaving = tableaux_[t].basis[row];
+    if (!Pivot(row, label, &tableaux_[t])) {
+      return false;
+    }
+    ++num_pivots_;
+    if (leaving == missing_label) {
+      return true;
+    }
+    label = leaving;
+    t = 1 - t;
+  }
+}
+
+bool LemkeHowson::Pivot(const int row, const int label, Tableau* tableau) {
+  vector<vector<int64_t> >& rows = tableau->rows;
+  const vector<int64_t>& pivot_row = rows[row];
+  const int64_t pivot = pivot_row[label];
+  const int num_cols = pivot_row.size();
+  for (int i = 0; i < static_cast<int>(rows.size()); ++i) {
+    const int64_t factor = rows[i][label];
+    if (i == row) {
+      continue;
+    }
+    for (int j = 0; j < num_cols; ++j) {
+      // Exact division by the previous pivot (Bareiss).
+      const __int128 value = (__int128(rows[i][j]) * pivot -
+                              __int128(factor) * pivot_row[j]) /
+                             tableau->denominator;
+      if (value > numeric_limits<int64_t>::max() ||
+          value < numeric_limits<int64_t>::min()) {
+        return false;
+      }
+      rows[i][j] = value;
+    }
+  }
+  tableau->denominator = pivot;
+  tableau->basis[row] = label;
+  return true;
+}
+
+int LemkeHowson::LeavingRow(const Tableau& tableau, const int label) const {
+  const int rhs = num_labels();
+  int best = -1;
+  for (int i = 0; i < static_cast<int>(tableau.rows.size()); ++i) {
+    const vector<int64_t>& r = tableau.rows[i];
+    if (r[label] <= 0) {
+      continue;
+    }
+    if (best == -1) {
+      best = i;
+      continue;
+    }
+    // Compares the right-hand sides and then the slack columns divided by
+    // the entering column, the rows of the basis inverse are distinct.
+    const vector<int64_t>& b = tableau.rows[best];
+    for (int c = -1; c < tableau.num_slacks; ++c) {
+      const int col = c == -1 ? rhs : tableau.first_slack + c;
+      const __int128 lhs = __int128(r[col]) * b[label];
+      const __int128 rhs_value = __int128(b[col]) * r[label];
+      if (lhs != rhs_value) {
+        if (lhs < rhs_value) {
+          best = i;
+        }
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+vector<int64_t> LemkeHowson::Strategy(const Tableau& tableau, const int first,
+                                      const int num) const {
+  const int rhs = num_labels();
+  vector<int64_t> weights(num, 0);
+  int64_t gcd = 0;
+  for (size_t i = 0; i < tableau.basis.size(); ++i) {
+    const int label = tableau.basis[i];
+    if (label >= first && label < first + num) {
+      weights[label - first] = tableau.rows[i][rhs];
+      gcd = Gcd(gcd, tableau.rows[i][rhs]);
+    }
+  }
+  assert(gcd > 0);
+  for (auto it = weights.begin(); it != weights.end(); ++it) {
+    *it /= gcd;
+  }
+  return weights;
+}
+
+MixedStrategyProfile LemkeHowson::Equilibrium(const vector<int64_t>& x,
+                                              const vector<int64_t>& y) const {
+  MixedStrategyProfile profile(2);
+  const vector<int64_t>* weights[] = {&x, &y};
+  for (int p = 0; p < 2; ++p) {
+    const vector<int64_t>& w = *weights[p];
+    profile.SetNumStrategies(p, w.size());
+    double sum = 0.0;
+    for (auto it = w.begin(); it != w.end(); ++it) {
+      sum += *it;
+    }
+    for (size_t s = 0; s < w.size(); ++s) {
+      profile.AddProbability(p, s, w[s] / sum);
+    }
+  }
+  return profile;
+}
+
+int LemkeHowson::num_labels() const {
+  return m_ + n_;
+}
+
+int LemkeHowson::num_pivots() const {
+  return num_pivots_;
+}
+
+}  // namespace ash
@@ -0,0 +1,80 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_LEMKE_HOWSON_H_
+#define SRC_LEMKE_HOWSON_H_
+
+#include <cstdint>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// The Lemke-Howson method for two-player games of any size. The best response
+// polytopes of both players are kept in integer tableaux, which pivot exactly:
+// each entry is a subdeterminant of the initial tableau and each pivot step
+// divides exactly by the previous pivot element (Bareiss). The path of a
+// missing label starts at the artificial equilibrium and alternates between
+// the tableaux until the missing label is picked up again, which is an
+// equilibrium. The lexicographic ratio test keeps the paths from cycling on
+// degenerate games. Labels 0 to m - 1 are the strategies of player 0 and
+// labels m to m + n - 1 the strategies of player 1.
+class LemkeHowson {
+ public:
+  explicit LemkeHowson(const Game& game);
+  // Follows the path of given missing label. Returns false if an entry of the
+  // tableaux exceeds 64 bits.
+  bool Solve(const int missing_label, MixedStrategyProfile* equilibrium);
+  // Follows the paths of all missing labels until given number of distinct
+  // equilibria is reached and visits each distinct equilibrium as it is
+  // found. Returns the number of visited equilibria.
+  int64_t FindMixed(const size_t max_num, const MixedVisitor& visitor);
+  int num_labels() const;
+  // Returns the number of pivots of the last call of Solve or FindMixed.
+  int num_pivots() const;
+
+ private:
+  // Tableau of the constraints of one player's best response polytope, with
+  // one column per label and the right-hand side in the last column.
+  struct Tableau {
+    std::vector<std::vector<int64_t> > rows;
+    // The label of the basic variable of each row.
+    std::vector<int> basis;
+    // The previous pivot element, the common denominator of all entries.
+    int64_t denominator;
+    // The labels of the slack variables, the columns of the initial basis.
+    int first_slack;
+    int num_slacks;
+  };
+
+  // Resets the tableaux to the artificial equilibrium.
+  void Reset();
+  // Follows the path of given missing label from the artificial equilibrium.
+  // Returns false on overflow.
+  bool FollowPath(const int missing_label);
+  // Pivots the variable of given label into the basis at given row. Returns
+  // false on overflow.
+  bool Pivot(const int row, const int label, Tableau* tableau);
+  // Returns the leaving row of the lexicographic ratio test for given label
+  // or -1 if no entry is positive.
+  int LeavingRow(const Tableau& tableau, const int label) const;
+  // Returns the basic values of the labels in [first, first + num) of given
+  // tableau, reduced by their greatest common divisor.
+  std::vector<int64_t> Strategy(const Tableau& tableau, const int first,
+                                const int num) const;
+  // Returns the mixed strategy profile of given strategy weights.
+  MixedStrategyProfile Equilibrium(const std::vector<int64_t>& x,
+                                   const std::vector<int64_t>& y) const;
+
+  // Numbers of strategies of player 0 and player 1.
+  int m_;
+  int n_;
+  // Payoffs per player indexed by profile id, shifted to be positive.
+  std::vector<std::vector<int64_t> > payoffs_;
+  // The tableau with the slacks of player 0 and the strategies of player 1
+  // and the tableau with the strategies of player 0 and the slacks of
+  // player 1.
+  Tableau tableaux_[2];
+  int num_pivots_;
+};
+
+}  // namespace ash
+#endif  // SRC_LEMKE_HOWSON_H_
@@ -0,0 +1,162 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./lemke-solver.h"
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using std::vector;
+using base::Clock;
+
+namespace ash {
+
+// Tolerance for pivot elements and ratio ties.
+static const double kEpsilon = 1e-9;
+
+const int LemkeSolver::kMaxNumPivots = 1000000;
+
+LemkeSolver::LemkeSolver(const vector<vector<double> >& m,
+                         const vector<double>& q)
+    : tableau_(q.size(), vector<double>(2 * q.size() + 2, 0.0)),
+      basis_(q.size()),
+      n_(q.size()),
+      num_pivots_(0),
+      duration_(0) {
+  assert(static_cast<int>(m.size()) == n_);
+  for (int i = 0; i < n_; ++i) {
+    assert(static_cast<int>(m[i].size()) == n_);
+    vector<double>& row = tableau_[i];
+    row[i] = 1.0;
+    for (int j = 0; j < n_; ++j) {
+      row[n_ + j] = -m[i][j];
+    }
+    row[2 * n_] = -1.0;
+    row[2 * n_ + 1] = q[i];
+    basis_[i] = i;
+  }
+}
+
+bool LemkeSolver::Solve() {
+  Clock beg;
+  solution_.assign(n_, 0.0);
+  // The trivial solution z = 0 applies for nonnegative q.
+  int row = 0;
+  for (int i = 1; i < n_; ++i) {
+    if (tableau_[i][2 * n_ + 1] <= tableau_[row][2 * n_ + 1]) {
+      row = i;
+    }
+  }
+  if (n_ == 0 || tableau_[row][2 * n_ + 1] >= 0.0) {
+    duration_ = Clock() - beg;
+    return true;
+  }
+  // The artificial z0 enters at the most negative q, which makes the basis
+  // feasible.
+  int leaving = basis_[row];
+  Pivot(row, 2 * n_);
+  bool solved = false;
+  while (num_pivots_ < kMaxNumPivots) {
+    // The complement of the leaving variable enters.
+    const int entering = leaving < n_ ? leaving + n_ : leaving - n_;
+    row = LeavingRow(entering);
+    if (row == -1) {
+      break;
+    }
+    leaving = basis_[row];
+    Pivot(row, entering);
+    if (leaving == 2 * n_) {
+      solved = true;
+      break;
+    }
+  }
+  if (solved) {
+    for (int i = 0; i < n_; ++i) {
+      if (basis_[i] >= n_ && basis_[i] < 2 * n_) {
+        solution_[basis_[i] - n_] = tableau_[i][2 * n_ + 1];
+      }
+    }
+  }
+  duration_ = Clock() - beg;
+  return solved;
+}
+
+int LemkeSolver::LeavingRow(const int col) const {
+  vector<int> rows;
+  double min_ratio = 0.0;
+  for (int i = 0; i < n_; ++i) {
+    const double a = tableau_[i][col];
+    if (a <= kEpsilon) {
+      continue;
+    }
+    const double ratio = tableau_[i][2 * n_ + 1] / a;
+    if (rows.empty() || ratio < min_ratio - kEpsilon) {
+      rows.assign(1, i);
+      min_ratio = ratio;
+    } else if (ratio <= min_ratio + kEpsilon) {
+      rows.push_back(i);
+    }
+  }
+  if (rows.size() <= 1u) {
+    return rows.empty() ? -1 : rows[0];
+  }
+  // Prefer z0 to leave, which terminates the method.
+  for (auto it = rows.begin(); it != rows.end(); ++it) {
+    if (basis_[*it] == 2 * n_) {
+      return *it;
+    }
+  }
+  // Lexicographic tie-breaking over the columns of the basis inverse.
+  for (int j = 0; j < n_ && rows.size() > 1u; ++j) {
+    vector<int> min_rows;
+    double min_value = 0.0;
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+      const double value = tableau_[*it][j] / tableau_[*it][col];
+      if (min_rows.empty() || value < min_value - kEpsilon) {
+        min_rows.assign(1, *it);
+        min_value = value;
+      } else if (value <= min_value + kEpsilon) {
+        min_rows.push_back(*it);
+      }
+    }
+    rows.swap(min_rows);
+  }
+  return rows[0];
+}
+
+void LemkeSolver::Pivot(const int row, const int col) {
+  vector<double>& pivot_row = tableau_[row];
+  const int num_cols = pivot_row.size();
+  const double pivot = pivot_row[col];
+  assert(std::fabs(pivot) > kEpsilon);
+  for (int j = 0; j < num_cols; ++j) {
+    pivot_row[j] /= pivot;
+  }
+  for (int i = 0; i < n_; ++i) {
+    if (i == row) {
+      continue;
+    }
+    vector<double>& r = tableau_[i];
+    const double factor = r[col];
+    if (factor == 0.0) {
+      continue;
+    }
+    for (int j = 0; j < num_cols; ++j) {
+      r[j] -= factor * pivot_row[j];
+    }
+  }
+  basis_[row] = col;
+  ++num_pivots_;
+}
+
+const vector<double>& LemkeSolver::solution() const {
+  return solution_;
+}
+
+int LemkeSolver::num_pivots() const {
+  return num_pivots_;
+}
+
+Clock::Diff LemkeSolver::duration() const {
+  return duration_;
+}
+
+}  // namespace ash
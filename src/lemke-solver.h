@@ -0,0 +1,47 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_LEMKE_SOLVER_H_
+#define SRC_LEMKE_SOLVER_H_
+
+#include <vector>
+#include "./clock.h"
+
+namespace ash {
+
+// Lemke's complementary pivoting method for the linear complementarity
+// problem: find z >= 0 with w = q + M z >= 0 and w'z = 0. It pivots on a
+// dense tableau with the covering vector of ones and breaks ties in the ratio
+// test lexicographically, which keeps it from cycling on degenerate problems.
+// For copositive-plus M with a feasible q it terminates with a solution.
+class LemkeSolver {
+ public:
+  static const int kMaxNumPivots;
+
+  // Initialises the solver with the n x n matrix M and the n-vector q.
+  LemkeSolver(const std::vector<std::vector<double> >& m,
+              const std::vector<double>& q);
+  // Returns true if a solution was found, false on ray termination.
+  bool Solve();
+
+  const std::vector<double>& solution() const;
+  int num_pivots() const;
+  base::Clock::Diff duration() const;
+
+ private:
+  // Pivots the variable of given column into the basis at given row.
+  void Pivot(const int row, const int col);
+  // Returns the leaving row of the lexicographic ratio test for given column
+  // or -1 if the column is unbounded.
+  int LeavingRow(const int col) const;
+
+  // The tableau [I, -M, -1 | q] with 2n + 2 columns per row.
+  std::vector<std::vector<double> > tableau_;
+  // The variable of each basis row: w_i as i, z_i as n + i and z0 as 2n.
+  std::vector<int> basis_;
+  std::vector<double> solution_;
+  int n_;
+  int num_pivots_;
+  base::Clock::Diff duration_;
+};
+
+}  // namespace ash
+#endif  // SRC_LEMKE_SOLVER_H_
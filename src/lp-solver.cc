@@ -27,89 +27,117 @@ static int ConstraintType(const Equation::Type type) {
 }
 
 LpSolver::LpSolver(const Lcp& lcp)
-    : lcp_(lcp) {
+    : lcp_(lcp),
+      lp_(NULL) {
   Reset();
 }
 
+LpSolver::~LpSolver() {
+  if (lp_) {
+    delete_lp(lp_);
+  }
+}
+
 bool LpSolver::Solve() {
   Reset();
   Clock beg;
-  const int num_vars = lcp_.num_variables();
-  lprec* lp = make_lp(0, num_vars);
-  assert(lp);
-  if (FLAGS_verbose) {
-    for (int i = 0; i < num_vars; ++i) {
-      set_col_name(lp, i + 1, const_cast<char*>(lcp_.variable(i).c_str()));
-    }
+  if (!lp_) {
+    BuildModel();
   }
-  set_add_rowmode(lp, true);
-  const int num_linear = lcp_.num_linear();
-  for (int e = 0; e < num_linear; ++e) {
-    const Equation& eq = lcp_.equation(e);
-    AddEquation(eq, lp);
-  }
-  const int num_compl = lcp_.num_complementary();
-  for (int e = 0; e < num_compl; ++e) {
-    const Equation& eq = lcp_.selected_equation(e);
-    AddEquation(eq, lp);
-  }
-  set_add_rowmode(lp, false);
+  SelectRows();
   if (lcp_.has_objective()) {
     const Objective& obj = lcp_.selected_objective();
-    AddObjective(obj, lp);
+    AddObjective(obj, lp_);
   }
-  set_verbose(lp, NEUTRAL);
-  const int result = solve(lp);
+  // The model keeps the basis of the previous solve as its starting point.
+  const int result = solve(lp_);
   const bool solved = result == OPTIMAL;
   if (solved) {
+    const int num_vars = lcp_.num_variables();
     solution_.resize(num_vars, 0.0);
-    get_variables(lp, &solution_[0]);
+    get_variables(lp_, &solution_[0]);
     if (FLAGS_verbose) {
       std::cout << lcp_.str();
       std::cout << "lp-solve input:\n";
-      write_LP(lp, stdout);
+      write_LP(lp_, stdout);
       std::cout << "\nlp-solve solution:\n";
       for (int i = 0; i < num_vars; ++i) {
-        std::cout << "(" << get_col_name(lp, i + 1)
+        std::cout << "(" << get_col_name(lp_, i + 1)
                   << " " <<  solution_[i] << ")\n";
       }
       std::cout << "\n";
     }
   }
-  delete_lp(lp);
   duration_ = Clock() - beg;
   return solved;
 }
 
+void LpSolver::BuildModel() {
+  const int num_vars = lcp_.num_variables();
+  lp_ = make_lp(0, num_vars);
+  assert(lp_);
+  if (FLAGS_verbose) {
+    for (int i = 0; i < num_vars; ++i) {
+      set_col_name(lp_, i + 1, const_cast<char*>(lcp_.variable(i).c_str()));
+    }
+  }
+  set_add_rowmode(lp_, true);
+  const int num_linear = lcp_.num_linear();
+  for (int e = 0; e < num_linear; ++e) {
+    AddEquation(lcp_.equation(e), lp_);
+  }
+  // Both equations of each complementary pair, selected by their type.
+  const int num_compl = lcp_.num_complementary() * 2;
+  for (int e = 0; e < num_compl; ++e) {
+    AddEquation(lcp_.compl_equation(e), lp_);
+  }
+  set_add_rowmode(lp_, false);
+  active_rows_.assign(num_compl, true);
+  set_verbose(lp_, NEUTRAL);
+}
+
+void LpSolver::SelectRows() {
+  const int first_row = lcp_.num_linear() + 1;
+  const int num_compl = active_rows_.size();
+  for (int e = 0; e < num_compl; ++e) {
+    const bool active = lcp_.compl_active(e);
+    if (active != active_rows_[e]) {
+      const int type = active ?
+                       ConstraintType(lcp_.compl_equation(e).type()) : FR;
+      set_constr_type(lp_, first_row + e, type);
+      active_rows_[e] = active;
+    }
+  }
+}
+
 bool LpSolver::AddEquation(const Equation& e, lprec* lp) {
-  vector<int> vars;
-  vector<double> coeffs;
+  vars_.clear();
+  coeffs_.clear();
   const int num_summands = e.size();
-  int used_summands = 0;
   for (int su = 0; su < num_summands; ++su) {
     const int coeff = e.coefficient(su);
     if (coeff != 0) {
-      vars.push_back(e.variable(su) + 1);
-      coeffs.push_back(e.coefficient(su));
-      ++used_summands;
+      vars_.push_back(e.variable(su) + 1);
+      coeffs_.push_back(coeff);
     }
   }
   const int type = ConstraintType(e.type());
-  const bool ok = add_constraintex(lp, used_summands, &coeffs[0], &vars[0],
-                                   type, e.constant());
+  const bool ok = add_constraintex(lp, vars_.size(), coeffs_.data(),
+                                   vars_.data(), type, e.constant());
   assert(ok);
   return ok;
 }
 
 bool LpSolver::AddObjective(const Objective& obj, lprec* lp) {
-  vector<int> vars;
-  vector<double> coeffs;
+  vars_.clear();
+  coeffs_.clear();
   const int num_summands = obj.size();
   for (int su = 0; su < num_summands; ++su) {
-    vars.push_back(obj.variable(su) + 1);
-    coeffs.push_back(obj.coefficient(su));
+    vars_.push_back(obj.variable(su) + 1);
+    coeffs_.push_back(obj.coefficient(su));
   }
-  const bool ok = set_obj_fnex(lp, num_summands, &coeffs[0], &vars[0]);
+  const bool ok = set_obj_fnex(lp, num_summands, coeffs_.data(),
+                               vars_.data());
   assert(ok);
   if (obj.type() == Objective::kMin) {
     set_minim(lp);
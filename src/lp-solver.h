@@ -14,9 +14,16 @@ class Lcp;
 class Equation;
 class Objective;
 
+// Solves the LP of an LCP with its selected complementary equations. The
+// lp_solve model is built on the first solve and kept: it holds the rows of
+// all complementary equations and later solves only switch the rows of
+// changed selections between their constraint type and free, set the
+// objective and start from the previous basis. The equations of the LCP must
+// not change between the solves, only their selection and the objective.
 class LpSolver {
  public:
   explicit LpSolver(const Lcp& lcp);
+  ~LpSolver();
   bool Solve();
   bool AddEquation(const Equation& e, lprec* lp);
   bool AddObjective(const Objective& obj, lprec* lp);
@@ -26,7 +33,22 @@ class LpSolver {
   base::Clock::Diff duration() const;
 
  private:
+  LpSolver(const LpSolver&);
+  LpSolver& operator=(const LpSolver&);
+
+  // Builds the model with the rows of all linear and complementary equations.
+  void BuildModel();
+  // Sets the constraint types of the complementary rows to the selection of
+  // the LCP.
+  void SelectRows();
+
   const Lcp& lcp_;
+  lprec* lp_;
+  // The selection state of each complementary row in the model.
+  std::vector<bool> active_rows_;
+  // Summand buffers of AddEquation and AddObjective, reused between rows.
+  std::vector<int> vars_;
+  std::vector<double> coeffs_;
   std::vector<double> solution_;
   base::Clock::Diff duration_;
 };
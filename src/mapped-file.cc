@@ -0,0 +1,83 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./mapped-file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cassert>
+
+using std::string;
+
+namespace base {
+
+MappedFile::MappedFile(const string& path)
+    : data_(NULL),
+      size_(0),
+      writable_(false) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return;
+  }
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    void* addr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<char*>(addr);
+      size_ = info.st_size;
+      // The file is scanned front to back exactly once.
+      madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+  }
+  // The mapping stays valid after closing its file descriptor.
+  close(fd);
+}
+
+MappedFile::MappedFile(const string& path, const size_t size)
+    : data_(NULL),
+      size_(0),
+      writable_(true) {
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd == -1) {
+    return;
+  }
+  // The mapping keeps the unlinked file alive.
+  unlink(path.c_str());
+  if (size > 0 && ftruncate(fd, size) == 0) {
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<char*>(addr);
+      size_ = size;
+      madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+}
+
+bool MappedFile::good() const {
+  return data_ != NULL;
+}
+
+const char* MappedFile::data() const {
+  return data_;
+}
+
+char* MappedFile::mutable_data() {
+  assert(writable_);
+  return data_;
+}
+
+const char* MappedFile::end() const {
+  return data_ + size_;
+}
+
+size_t MappedFile::size() const {
+  return size_;
+}
+
+}  // namespace base
@@ -0,0 +1,40 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_MAPPED_FILE_H_
+#define SRC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace base {
+
+// Memory mapping of a whole file. The mapping is released on destruction.
+class MappedFile {
+ public:
+  // Maps the file at given path read-only, use good() to check for success.
+  explicit MappedFile(const std::string& path);
+  // Creates a scratch file of given size at given path and maps it writable.
+  // The file is unlinked right away, its pages are written back to disk
+  // under memory pressure and released with the mapping. This allows data
+  // larger than memory to be held in the page cache.
+  MappedFile(const std::string& path, const size_t size);
+  ~MappedFile();
+
+  // Returns true if the file is mapped and non-empty.
+  bool good() const;
+  const char* data() const;
+  // Returns the writable data of a scratch file mapping.
+  char* mutable_data();
+  const char* end() const;
+  size_t size() const;
+
+ private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  char* data_;
+  size_t size_;
+  bool writable_;
+};
+
+}  // namespace base
+#endif  // SRC_MAPPED_FILE_H_
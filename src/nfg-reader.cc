@@ -0,0 +1,433 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./nfg-reader.h"
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include "./numeral-tokenizer.h"
+#include "./parser.h"
+
+using std::string;
+using std::stringstream;
+using std::vector;
+using std::numeric_limits;
+using std::thread;
+
+namespace ash { namespace parse {
+
+// Returns true for characters which separate tokens without being tokens.
+static inline bool Separator(const char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+}
+
+// Returns true for characters which end a word or numeral.
+static inline bool Delimiter(const char c) {
+  return Separator(c) || c == Parser::kCurlBeg || c == Parser::kCurlEnd ||
+         c == Parser::kQuot;
+}
+
+static inline bool Digit(const char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Scans the numeral starting at pos and stores its value.
+// Returns the position past the numeral or NULL if it is not a valid integer,
+// overflow is set for numerals beyond the int range.
+static inline const char* ScanNumeral(const char* pos, const char* end,
+                                      int* value, bool* overflow) {
+  static const int64_t kMax = numeric_limits<int>::max();
+  *overflow = false;
+  const bool negative = *pos == '-';
+  pos += negative;
+  if (pos == end || !Digit(*pos)) {
+    return NULL;
+  }
+  // The magnitude of negative numerals may exceed the maximum by one.
+  const int64_t limit = kMax + negative;
+  int64_t v = 0;
+  while (pos != end && Digit(*pos)) {
+    v = v * 10 + (*pos - '0');
+    if (v > limit) {
+      *overflow = true;
+      return NULL;
+    }
+    ++pos;
+  }
+  if (pos != end && !Delimiter(*pos)) {
+    return NULL;
+  }
+  *value = static_cast<int>(negative ? -v : v);
+  return pos;
+}
+
+Token::Token()
+    : type(kNone),
+      beg(NULL),
+      end(NULL),
+      number(0) {}
+
+string Token::str() const {
+  return string(beg, end);
+}
+
+const char* NfgReader::NextToken(const char* pos, const char* end,
+                                 Token* token) {
+  assert(token);
+  while (pos != end && Separator(*pos)) {
+    ++pos;
+  }
+  token->beg = pos;
+  if (pos == end) {
+    token->type = Token::kNone;
+    token->end = pos;
+    return pos;
+  }
+  const char c = *pos;
+  if (c == Parser::kCurlBeg || c == Parser::kCurlEnd) {
+    token->type = c == Parser::kCurlBeg ? Token::kOpen : Token::kClose;
+    token->end = ++pos;
+    return pos;
+  }
+  if (c == Parser::kQuot) {
+    // Backslash-escaped quotation marks are part of the string.
+    ++pos;
+    token->beg = pos;
+    while (pos != end && (*pos != Parser::kQuot || *(pos - 1) == '\\')) {
+      ++pos;
+    }
+    token->type = Token::kString;
+    token->end = pos;
+    return pos == end ? pos : pos + 1;
+  }
+  bool overflow = false;
+  if (c == '-' || Digit(c)) {
+    const char* num_end = ScanNumeral(pos, end, &token->number, &overflow);
+    if (num_end) {
+      token->type = Token::kNumber;
+      token->end = num_end;
+      return num_end;
+    }
+  }
+  while (pos != end && !Delimiter(*pos)) {
+    ++pos;
+  }
+  token->type = overflow ? Token::kOverflow : Token::kWord;
+  token->end = pos;
+  return pos;
+}
+
+NfgReader::NfgReader(StrategicGame* game)
+    : game_(game),
+      state_(kNfg),
+      payoff_player_(0),
+      offset_(0),
+      last_(true),
+      num_threads_(std::max(1u, thread::hardware_concurrency())) {
+  assert(game_);
+}
+
+const char* NfgReader::ReadPayoffIndices(const char* pos, const char* end) {
+  vector<int>& indices = game_->payoff_indices;
+  while (true) {
+    while (pos != end && Separator(*pos)) {
+      ++pos;
+    }
+    if (pos == end) {
+      return pos;
+    }
+    int value = 0;
+    bool overflow = false;
+    const char* num_end = ScanNumeral(pos, end, &value, &overflow);
+    if (!num_end || (num_end == end && !last_)) {
+      return pos;
+    }
+    indices.push_back(value);
+    pos = num_end;
+  }
+}
+
+const char* NfgReader::ReadPayoffs(const char* pos, const char* end) {
+  vector<vector<int> >& payoffs = game_->payoffs;
+  const size_t num_players = payoffs.size();
+  size_t player = payoff_player_;
+  while (true) {
+    while (pos != end && Separator(*pos)) {
+      ++pos;
+    }
+    if (pos == end) {
+      break;
+    }
+    int value = 0;
+    bool overflow = false;
+    const char* num_end = ScanNumeral(pos, end, &value, &overflow);
+    if (!num_end || (num_end == end && !last_)) {
+      break;
+    }
+    payoffs[player].push_back(value);
+    player = player + 1 == num_players ? 0 : player + 1;
+    pos = num_end;
+  }
+  payoff_player_ = player;
+  return pos;
+}
+
+void NfgReader::BeginPayoffs() {
+  const size_t num_profiles = NumProfiles();
+  game_->payoffs.resize(game_->players.size());
+  for (auto it = game_->payoffs.begin(), end = game_->payoffs.end();
+       it != end; ++it) {
+    it->reserve(num_profiles);
+  }
+  payoff_player_ = 0;
+  state_ = kPayoffs;
+}
+
+bool NfgReader::Read(const char* beg, const char* end) {
+  return Feed(beg, end, true) && Finish();
+}
+
+const char* NfgReader::Feed(const char* beg, const char* end, const bool last) {
+  assert(beg <= end);
+  last_ = last;
+  const char* pos = beg;
+  Token token;
+  while (true) {
+    if (state_ == kPayoffIndices) {
+      // The payoff indices usually make up most of the input, therefore they
+      // are scanned without the token dispatch.
+      if (game_->payoff_indices.empty()) {
+        game_->payoff_indices.reserve(NumProfiles());
+        // A completely available large section is converted in parallel,
+        // malformed sections are left to the sequential scan for reporting.
+        if (last_ && static_cast<size_t>(end - pos) >=
+            NumeralTokenizer::kMinParallelSize &&
+            NumeralTokenizer::ConvertParallel(pos, end, num_threads_,
+                                              &game_->payoff_indices)) {
+          pos = end;
+        }
+      }
+      pos = ReadPayoffIndices(pos, end);
+    } else if (state_ == kPayoffs) {
+      pos = ReadPayoffs(pos, end);
+    }
+    const char* next = NextToken(pos, end, &token);
+    if (token.type == Token::kNone) {
+      pos = next;
+      break;
+    }
+    if (!last && token.type != Token::kOpen && token.type != Token::kClose &&
+        token.end == end) {
+      // The token might continue in the next part.
+      pos = token.beg - (token.type == Token::kString);
+      break;
+    }
+    if (!Consume(token)) {
+      stringstream ss;
+      ss << error_ << " at byte " << offset_ + (token.beg - beg);
+      error_ = ss.str();
+      return NULL;
+    }
+    pos = next;
+  }
+  offset_ += pos - beg;
+  return pos;
+}
+
+bool NfgReader::Consume(const Token& token) {
+  if (token.type == Token::kOverflow) {
+    return Fail("Numeral out of integer range");
+  }
+  switch (state_) {
+    case kNfg:
+      if (token.type != Token::kWord || token.str() != "NFG") {
+        return Fail("Expected NFG header");
+      }
+      state_ = kVersion;
+      return true;
+    case kVersion:
+      if (token.type != Token::kNumber || token.number != 1) {
+        return Fail("Unsupported NFG version");
+      }
+      state_ = kFormat;
+      return true;
+    case kFormat:
+      if (token.type != Token::kWord || token.str() != "R") {
+        return Fail("Unsupported NFG number format");
+      }
+      state_ = kName;
+      return true;
+    case kName:
+      if (token.type != Token::kString) {
+        return Fail("Expected game name");
+      }
+      game_->name = token.str();
+      state_ = kPlayersBeg;
+      return true;
+    case kPlayersBeg:
+      if (token.type != Token::kOpen) {
+        return Fail("Expected players section");
+      }
+      state_ = kPlayers;
+      return true;
+    case kPlayers:
+      if (token.type == Token::kString) {
+        game_->players.push_back(token.str());
+        return true;
+      } else if (token.type == Token::kClose && game_->players.size()) {
+        state_ = kStrategiesBeg;
+        return true;
+      }
+      return Fail("Expected player name");
+    case kStrategiesBeg:
+      if (token.type != Token::kOpen) {
+        return Fail("Expected strategies section");
+      }
+      state_ = kStrategies;
+      return true;
+    case kStrategies:
+      if (token.type == Token::kOpen &&
+          game_->strategies.size() < game_->players.size()) {
+        game_->strategies.push_back(vector<string>());
+        state_ = kPlayerStrategies;
+        return true;
+      } else if (token.type == Token::kNumber && token.number > 0 &&
+                 game_->strategies.size() < game_->players.size()) {
+        // The payoff version may only state the number of strategies, which
+        // are then named by their position.
+        game_->strategies.push_back(vector<string>());
+        for (int s = 1; s <= token.number; ++s) {
+          stringstream ss;
+          ss << s;
+          game_->strategies.back().push_back(ss.str());
+        }
+        return true;
+      } else if (token.type == Token::kClose &&
+                 game_->strategies.size() == game_->players.size()) {
+        if (!NumProfiles()) {
+          return Fail("Number of strategy profiles exceeds 64-bit range");
+        }
+        state_ = kComment;
+        return true;
+      }
+      return Fail("Expected strategies for each player");
+    case kPlayerStrategies:
+      if (token.type == Token::kString) {
+        game_->strategies.back().push_back(token.str());
+        return true;
+      } else if (token.type == Token::kClose &&
+                 game_->strategies.back().size()) {
+        state_ = kStrategies;
+        return true;
+      }
+      return Fail("Expected strategy name");
+    case kComment:
+      if (token.type == Token::kString) {
+        game_->comment = token.str();
+        return true;
+      } else if (token.type == Token::kOpen) {
+        state_ = kOutcomes;
+        return true;
+      } else if (token.type == Token::kNumber) {
+        // Payoff version, the token is the first player's first payoff.
+        BeginPayoffs();
+        game_->payoffs[0].push_back(token.number);
+        payoff_player_ = 1 % game_->payoffs.size();
+        return true;
+      }
+      return Fail("Expected outcomes or payoffs section");
+    case kOutcomes:
+      if (token.type == Token::kOpen) {
+        state_ = kOutcomeName;
+        return true;
+      } else if (token.type == Token::kClose) {
+        state_ = kPayoffIndices;
+        return true;
+      }
+      return Fail("Expected outcome");
+    case kOutcomeName:
+      if (token.type != Token::kString) {
+        return Fail("Expected outcome name");
+      }
+      game_->outcomes.push_back(Outcome(token.str(), vector<int>()));
+      game_->outcomes.back().payoffs.reserve(game_->players.size());
+      state_ = kOutcomePayoffs;
+      return true;
+    case kOutcomePayoffs:
+      if (token.type == Token::kNumber) {
+        game_->outcomes.back().payoffs.push_back(token.number);
+        return true;
+      } else if (token.type == Token::kClose &&
+                 game_->outcomes.back().payoffs.size() ==
+                 game_->players.size()) {
+        state_ = kOutcomes;
+        return true;
+      }
+      return Fail("Expected one payoff per player");
+    case kPayoffIndices:
+      return Fail("Expected payoff index");
+    case kPayoffs:
+      return Fail("Expected payoff");
+  }
+  assert(false && "Unknown parser state");
+  return false;
+}
+
+bool NfgReader::Finish() {
+  const size_t num_profiles = NumProfiles();
+  if (state_ == kPayoffs) {
+    const vector<vector<int> >& payoffs = game_->payoffs;
+    if (payoff_player_ != 0 || payoffs[0].size() != num_profiles) {
+      stringstream ss;
+      ss << "Expected " << num_profiles * payoffs.size() << " payoffs";
+      return Fail(ss.str());
+    }
+    return true;
+  }
+  if (state_ != kPayoffIndices) {
+    return Fail("Unexpected end of input");
+  }
+  if (game_->payoff_indices.size() != num_profiles) {
+    stringstream ss;
+    ss << "Expected " << num_profiles << " payoff indices, found "
+       << game_->payoff_indices.size();
+    return Fail(ss.str());
+  }
+  const int num_outcomes = game_->outcomes.size();
+  for (auto it = game_->payoff_indices.begin(),
+       end = game_->payoff_indices.end(); it != end; ++it) {
+    if (*it < 0 || *it > num_outcomes) {
+      return Fail("Payoff index out of outcome range");
+    }
+  }
+  return true;
+}
+
+bool NfgReader::Fail(const string& reason) {
+  error_ = reason;
+  return false;
+}
+
+size_t NfgReader::NumProfiles() const {
+  const size_t max_num_profiles = numeric_limits<int64_t>::max();
+  size_t num_profiles = 1;
+  for (auto it = game_->strategies.begin(), end = game_->strategies.end();
+       it != end; ++it) {
+    if (num_profiles > max_num_profiles / it->size()) {
+      return 0;
+    }
+    num_profiles *= it->size();
+  }
+  return num_profiles;
+}
+
+void NfgReader::num_threads(const int num_threads) {
+  num_threads_ = std::max(1, num_threads);
+}
+
+const string& NfgReader::error() const {
+  return error_;
+}
+
+} }  // namespace ash::parse
@@ -0,0 +1,102 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_NFG_READER_H_
+#define SRC_NFG_READER_H_
+
+#include <string>
+#include <vector>
+
+namespace ash { namespace parse {
+
+struct StrategicGame;
+
+// Token of the Gambit strategic game format. It references the characters of
+// the scanned input instead of copying them.
+struct Token {
+  // Numerals beyond the int range are of type kOverflow.
+  enum Type { kNone, kWord, kString, kNumber, kOverflow, kOpen, kClose };
+
+  Token();
+  std::string str() const;
+
+  Type type;
+  const char* beg;
+  const char* end;
+  int number;
+};
+
+// One-pass reader for the Gambit strategic game format, both the outcome and
+// the payoff version. The input is tokenized in place and the tokens drive a
+// state machine over the game sections, only names are copied into the
+// resulting game. Payoffs of the payoff version are distributed directly into
+// the per-player payoff vectors.
+// The input may be fed in consecutive parts, which allows reading streams in
+// fixed-size chunks.
+class NfgReader {
+ public:
+  // Scans the next token within [pos, end), whitespace and commas are
+  // skipped. Returns the position past the token, the token type is kNone if
+  // no token is left.
+  static const char* NextToken(const char* pos, const char* end, Token* token);
+
+  explicit NfgReader(StrategicGame* game);
+
+  // Reads a complete game from the character range [beg, end).
+  // Returns false on malformed input, the reason is given by error().
+  bool Read(const char* beg, const char* end);
+
+  // Reads the next part of the input from the character range [beg, end).
+  // Unless it is the last part, a trailing token which might continue in the
+  // next part is not consumed and has to be fed again, prepended to the next
+  // part. Returns the position past the consumed characters or NULL on
+  // malformed input, the reason is given by error().
+  const char* Feed(const char* beg, const char* end, const bool last);
+
+  // Checks whether the game is complete after the last part has been fed.
+  // Returns false on incomplete input, the reason is given by error().
+  bool Finish();
+
+  // Sets the number of threads used to convert large payoff sections.
+  void num_threads(const int num_threads);
+
+  const std::string& error() const;
+
+ private:
+  enum State {
+    kNfg, kVersion, kFormat, kName, kPlayersBeg, kPlayers, kStrategiesBeg,
+    kStrategies, kPlayerStrategies, kComment, kOutcomes, kOutcomeName,
+    kOutcomePayoffs, kPayoffIndices, kPayoffs
+  };
+
+  // Scans consecutive payoff indices of the outcome version within
+  // [pos, end). Returns the position of the first character not belonging to
+  // a numeral, whitespace or comma, or of a numeral which might continue in
+  // the next part of the input.
+  const char* ReadPayoffIndices(const char* pos, const char* end);
+  // Scans consecutive payoffs of the payoff version within [pos, end) and
+  // appends them to the payoff vector of the player they belong to.
+  // Returns the position like ReadPayoffIndices.
+  const char* ReadPayoffs(const char* pos, const char* end);
+  // Switches to the payoff version and reserves space for all payoffs.
+  void BeginPayoffs();
+  // Advances the state machine by given token.
+  bool Consume(const Token& token);
+  // Sets the error message and returns false.
+  bool Fail(const std::string& reason);
+  // Returns the number of strategy profiles defined by the strategies read,
+  // 0 if it exceeds the range of 64-bit profile ids.
+  size_t NumProfiles() const;
+
+  StrategicGame* game_;
+  State state_;
+  // The player of the next payoff in the payoff version.
+  size_t payoff_player_;
+  // Number of characters consumed by all previous parts.
+  size_t offset_;
+  // Whether the current part is the last part of the input.
+  bool last_;
+  int num_threads_;
+  std::string error_;
+};
+
+} }  // namespace ash::parse
+#endif  // SRC_NFG_READER_H_
@@ -0,0 +1,172 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./numeral-tokenizer.h"
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif  // __SSE2__
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using std::vector;
+using std::thread;
+using std::numeric_limits;
+
+namespace ash { namespace parse {
+
+static inline bool Separator(const char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+}
+
+static inline bool Digit(const char c) {
+  return c >= '0' && c <= '9';
+}
+
+const size_t NumeralTokenizer::kMinParallelSize = 1 << 20;
+
+bool NumeralTokenizer::Count(const char* beg, const char* end,
+                             size_t* _count) {
+  assert(_count);
+  size_t count = 0;
+  // Whether the character before the current position belongs to a numeral.
+  bool in_numeral = false;
+  const char* pos = beg;
+#ifdef __SSE2__
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i comma = _mm_set1_epi8(',');
+  const __m128i minus = _mm_set1_epi8('-');
+  const __m128i below_zero = _mm_set1_epi8('0' - 1);
+  const __m128i above_nine = _mm_set1_epi8('9' + 1);
+  for (; end - pos >= 16; pos += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+    const __m128i separators = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, space),
+                     _mm_cmpeq_epi8(chars, newline)),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, carriage),
+                                  _mm_cmpeq_epi8(chars, tab)),
+                     _mm_cmpeq_epi8(chars, comma)));
+    const __m128i numerals = _mm_or_si128(
+        _mm_and_si128(_mm_cmpgt_epi8(chars, below_zero),
+                      _mm_cmplt_epi8(chars, above_nine)),
+        _mm_cmpeq_epi8(chars, minus));
+    const unsigned separator_mask = _mm_movemask_epi8(separators);
+    const unsigned numeral_mask = _mm_movemask_epi8(numerals);
+    if ((separator_mask | numeral_mask) != 0xffffu) {
+      return false;
+    }
+    // A numeral begins where a numeral character follows a separator.
+    const unsigned begins = numeral_mask &
+                            ~((numeral_mask << 1) | in_numeral) & 0xffffu;
+    count += __builtin_popcount(begins);
+    in_numeral = numeral_mask >> 15;
+  }
+#endif  // __SSE2__
+  for (; pos != end; ++pos) {
+    const char c = *pos;
+    if (Separator(c)) {
+      in_numeral = false;
+    } else if (Digit(c) || c == '-') {
+      count += !in_numeral;
+      in_numeral = true;
+    } else {
+      return false;
+    }
+  }
+  *_count = count;
+  return true;
+}
+
+bool NumeralTokenizer::Convert(const char* beg, const char* end,
+                               int* numerals) {
+  assert(numerals);
+  static const int64_t kMax = numeric_limits<int>::max();
+  const char* pos = beg;
+  while (true) {
+    while (pos != end && Separator(*pos)) {
+      ++pos;
+    }
+    if (pos == end) {
+      return true;
+    }
+    const bool negative = *pos == '-';
+    pos += negative;
+    if (pos == end || !Digit(*pos)) {
+      return false;
+    }
+    // The magnitude of negative numerals may exceed the maximum by one.
+    const int64_t limit = kMax + negative;
+    int64_t value = 0;
+    while (pos != end && Digit(*pos)) {
+      value = value * 10 + (*pos - '0');
+      if (value > limit) {
+        return false;
+      }
+      ++pos;
+    }
+    if (pos != end && !Separator(*pos)) {
+      return false;
+    }
+    *numerals++ = static_cast<int>(negative ? -value : value);
+  }
+}
+
+bool NumeralTokenizer::ConvertParallel(const char* beg, const char* end,
+                                       const int num_threads,
+                                       vector<int>* numerals) {
+  assert(numerals && num_threads > 0);
+  const size_t size = end - beg;
+  // Chunks begin at separators, so no numeral is split among them.
+  vector<const char*> bounds(num_threads + 1, end);
+  bounds[0] = beg;
+  for (int t = 1; t < num_threads; ++t) {
+    const char* bound = std::max(bounds[t - 1], beg + size / num_threads * t);
+    while (bound != end && !Separator(*bound)) {
+      ++bound;
+    }
+    bounds[t] = bound;
+  }
+  vector<size_t> counts(num_threads, 0);
+  vector<char> valid(num_threads, true);
+  vector<thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.push_back(thread([&bounds, &counts, &valid, t]() {
+      valid[t] = Count(bounds[t], bounds[t + 1], &counts[t]);
+    }));
+  }
+  size_t total = 0;
+  for (int t = 0; t < num_threads; ++t) {
+    threads[t].join();
+    total += counts[t];
+  }
+  threads.clear();
+  for (int t = 0; t < num_threads; ++t) {
+    if (!valid[t]) {
+      return false;
+    }
+  }
+  const size_t offset = numerals->size();
+  numerals->resize(offset + total);
+  int* out = numerals->data() + offset;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.push_back(thread([&bounds, &valid, out, t]() {
+      valid[t] = Convert(bounds[t], bounds[t + 1], out);
+    }));
+    out += counts[t];
+  }
+  bool ok = true;
+  for (int t = 0; t < num_threads; ++t) {
+    threads[t].join();
+    ok = ok && valid[t];
+  }
+  if (!ok) {
+    numerals->resize(offset);
+  }
+  return ok;
+}
+
+} }  // namespace ash::parse
@@ -0,0 +1,39 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_NUMERAL_TOKENIZER_H_
+#define SRC_NUMERAL_TOKENIZER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace ash { namespace parse {
+
+// Tokenizer for large blocks of integer numerals separated by whitespace or
+// commas, like the payoff section of strategic games. Characters are
+// classified 16 at a time using SSE2 where available.
+struct NumeralTokenizer {
+  // Blocks smaller than this are not worth splitting among threads.
+  static const size_t kMinParallelSize;
+
+  // Counts the numerals within [beg, end) into count.
+  // Returns false if the block contains other characters than numerals and
+  // separators.
+  static bool Count(const char* beg, const char* end, size_t* count);
+
+  // Converts the numerals within [beg, end) into consecutive integers
+  // starting at given position, which has to provide space for all of them.
+  // Returns false if the block contains malformed numerals or numerals beyond
+  // the int range.
+  static bool Convert(const char* beg, const char* end, int* numerals);
+
+  // Splits the block at separators into one chunk per thread, counts and
+  // converts the chunks in parallel and writes them straight into their final
+  // positions after the current end of the given vector.
+  // Returns false if the block contains other characters than well-formed
+  // numerals and separators, the vector is left unchanged in that case.
+  static bool ConvertParallel(const char* beg, const char* end,
+                              const int num_threads,
+                              std::vector<int>* numerals);
+};
+
+} }  // namespace ash::parse
+#endif  // SRC_NUMERAL_TOKENIZER_H_
@@ -0,0 +1,87 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_PACKED_ARRAY_H_
+#define SRC_PACKED_ARRAY_H_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace base {
+
+// Array of unsigned integers, which are packed into 64-bit words at a fixed
+// power-of-two bit width (1, 2, 4, 8, 16 or 32 bits). Elements never cross
+// word boundaries, therefore random access is a shift and a mask.
+class PackedArray {
+ public:
+  // Returns the narrowest supported bit width, which fits given value.
+  static int Width(const uint32_t max_value) {
+    int width = 1;
+    while (width < 32 && (max_value >> width) != 0u) {
+      width *= 2;
+    }
+    return width;
+  }
+
+  PackedArray()
+      : size_(0),
+        width_(0),
+        log_per_word_(0),
+        mask_(0u) {}
+
+  // Initialises size zero elements at the width fitting given max value.
+  PackedArray(const size_t size, const uint32_t max_value)
+      : size_(size),
+        width_(Width(max_value)),
+        log_per_word_(0),
+        mask_(width_ == 32 ? 0xffffffffu : (1u << width_) - 1u) {
+    while ((64 >> log_per_word_) > width_) {
+      ++log_per_word_;
+    }
+    words_.resize((size + (size_t(1) << log_per_word_) - 1) >> log_per_word_,
+                  0u);
+  }
+
+  uint32_t operator[](const size_t index) const {
+    assert(index < size_);
+    const size_t offset = (index & ((size_t(1) << log_per_word_) - 1)) *
+                          width_;
+    return (words_[index >> log_per_word_] >> offset) & mask_;
+  }
+
+  void set(const size_t index, const uint32_t value) {
+    assert(index < size_ && value <= mask_);
+    const size_t offset = (index & ((size_t(1) << log_per_word_) - 1)) *
+                          width_;
+    uint64_t& word = words_[index >> log_per_word_];
+    word = (word & ~(uint64_t(mask_) << offset)) | (uint64_t(value) << offset);
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  // Returns the bit width of the elements.
+  int width() const {
+    return width_;
+  }
+
+  // Returns the number of bytes used by the packed elements.
+  size_t num_bytes() const {
+    return words_.size() * sizeof(uint64_t);
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+  size_t size_;
+  int width_;
+  // The binary logarithm of the number of elements per word.
+  int log_per_word_;
+  uint32_t mask_;
+};
+
+}  // namespace base
+#endif  // SRC_PACKED_ARRAY_H_
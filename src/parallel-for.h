@@ -0,0 +1,80 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_PARALLEL_FOR_H_
+#define SRC_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+// Runs the tasks 0 to num_tasks - 1 on given number of threads, including the
+// calling thread. Each thread takes the next task from a shared counter, which
+// balances uneven tasks and keeps the tasks started in ascending order.
+// Returns after all tasks are done.
+inline void ParallelFor(const int64_t num_tasks, const int num_threads,
+                        const std::function<void(const int64_t)>& task) {
+  std::atomic<int64_t> next(0);
+  auto work = [&]() {
+    for (int64_t t = next++; t < num_tasks; t = next++) {
+      task(t);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads && i < num_tasks; ++i) {
+    threads.push_back(std::thread(work));
+  }
+  work();
+  for (auto it = threads.begin(); it != threads.end(); ++it) {
+    it->join();
+  }
+}
+
+// Runs the tasks like ParallelFor, each task fills its own result. The results
+// are passed in task order to given merge function as soon as all tasks
+// before are complete, one call at a time from the worker threads. Once the
+// merge function returns false, no tasks after the merged ones are started
+// and no further results are merged. Tasks are only skipped by their index
+// relative to the merged ones, never for results of tasks after them.
+template<typename Result>
+void OrderedParallelFor(const int64_t num_tasks, const int num_threads,
+                        const std::function<void(const int64_t, Result*)>& task,
+                        const std::function<bool(Result*)>& merge) {
+  std::vector<Result> results(num_tasks);
+  std::vector<bool> done(num_tasks, false);
+  std::mutex mutex;
+  int64_t next = 0;
+  // The index of the first task which is not needed anymore.
+  std::atomic<int64_t> limit(num_tasks);
+  ParallelFor(num_tasks, num_threads, [&](const int64_t t) {
+    if (t >= limit) {
+      return;
+    }
+    task(t, &results[t]);
+    std::lock_guard<std::mutex> lock(mutex);
+    done[t] = true;
+    for (; next < limit && done[next]; ++next) {
+      if (!merge(&results[next])) {
+        limit = next + 1;
+      }
+      // Merged results are released early.
+      results[next] = Result();
+    }
+  });
+}
+
+// Returns the size of the chunks, which split given range into enough tasks
+// for given number of threads to balance uneven tasks, but at least given
+// minimum size.
+inline int64_t ChunkSize(const int64_t size, const int num_threads,
+                         const int64_t min_size) {
+  static const int64_t kTasksPerThread = 16;
+  return std::max(min_size, size / (num_threads * kTasksPerThread) + 1);
+}
+
+}  // namespace base
+#endif  // SRC_PARALLEL_FOR_H_
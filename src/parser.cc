@@ -1,8 +1,12 @@
 // Copyright 2012 Eugen Sawin <esawin@me73.com>
 #include "./parser.h"
 #include <cassert>
+#include <algorithm>
 #include <fstream>
+#include <iostream>
 #include <sstream>
+#include "./mapped-file.h"
+#include "./nfg-reader.h"
 
 using std::string;
 using std::ifstream;
@@ -10,6 +14,7 @@ using std::stringstream;
 using std::vector;
 using std::set;
 using std::min;
+using base::MappedFile;
 
 namespace ash { namespace parse {
 
@@ -51,6 +56,21 @@ string StrategicGame::Str() const {
   if (comment.size()) {
     ss << "  (comment " << comment << ")\n";
   }
+  if (payoffs.size()) {
+    ss << "  (payoffs ";
+    for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+      ss << "\n    (";
+      for (auto it2 = it->begin(); it2 != it->end(); ++it2) {
+        if (it2 != it->begin()) {
+          ss << " ";
+        }
+        ss << *it2;
+      }
+      ss << ")";
+    }
+    ss << "))\n";
+    return ss.str();
+  }
   ss << "  (outcomes ";
   for (auto it = outcomes.begin(); it != outcomes.end(); ++it) {
     const Outcome& o = *it;
@@ -72,6 +92,8 @@ const char* Parser::kWhitespace = "\n\r\t ";
 const char Parser::kQuot = '\"';
 const char Parser::kCurlBeg = '{';
 const char Parser::kCurlEnd = '}';
+const char* Parser::kStdin = "-";
+const size_t Parser::kChunkSize = 1 << 16;
 
 size_t Parser::FileSize(const string& path) {
   ifstream stream(path.c_str());
@@ -155,9 +177,20 @@ string Parser::StripWhitespace(const string& content) {
 }
 
 Parser::Parser(const string& path)
-    : path_(path) {}
+    : path_(path),
+      mode_(kBuffered) {}
+
+Parser::Parser(const string& path, const Mode mode)
+    : path_(path),
+      mode_(mode) {}
 
 StrategicGame Parser::ParseStrategicGame() {
+  error_.clear();
+  if (mode_ == kMapped) {
+    return ParseMapped();
+  } else if (mode_ == kStream) {
+    return ParseStream();
+  }
   if (content_.size() == 0) {
     ReadAll();
   }
@@ -166,6 +199,10 @@ StrategicGame Parser::ParseStrategicGame() {
   size_t pos = 0;
   pos = LoadHeader(pos, &game);
   pos = LoadPlayers(pos, &game);
+  if (!OutcomeFormat(pos)) {
+    // The cached sections are copied out for the outcome format only.
+    return ParseContent();
+  }
   pos = LoadStrategies(pos, &game);
   size_t comment_end = Between(pos, kQuot, kQuot, &game.comment);
   if (comment_end != string::npos) {
@@ -176,6 +213,90 @@ StrategicGame Parser::ParseStrategicGame() {
   return game;
 }
 
+bool Parser::OutcomeFormat(const size_t pos) const {
+  string section;
+  size_t end = Between(pos, kCurlBeg, kCurlEnd, &section);
+  if (end == string::npos || section.find(kCurlBeg) == string::npos) {
+    // Numbers of strategies instead of strategy names.
+    return false;
+  }
+  string comment;
+  const size_t comment_end = Between(end, kQuot, kQuot, &comment);
+  if (comment_end != string::npos) {
+    end = comment_end;
+  }
+  const size_t outcomes = content_.find_first_not_of(" \t\r\n", end);
+  return outcomes != string::npos && content_[outcomes] == kCurlBeg;
+}
+
+StrategicGame Parser::ParseContent() {
+  StrategicGame game;
+  NfgReader reader(&game);
+  if (!reader.Read(content_.data(), content_.data() + content_.size())) {
+    error_ = reader.error();
+  }
+  return game;
+}
+
+StrategicGame Parser::ParseMapped() {
+  StrategicGame game;
+  MappedFile file(path_);
+  if (!file.good()) {
+    // Pipes and other unmappable files are streamed instead.
+    return ParseStream();
+  }
+  NfgReader reader(&game);
+  if (!reader.Read(file.data(), file.end())) {
+    error_ = reader.error();
+  }
+  return game;
+}
+
+StrategicGame Parser::ParseStream() {
+  StrategicGame game;
+  ifstream file;
+  if (path_ != kStdin) {
+    file.open(path_.c_str());
+  }
+  std::istream& stream = path_ == kStdin ? std::cin : file;
+  if (!stream.good()) {
+    error_ = "Could not open file " + path_;
+    return game;
+  }
+  NfgReader reader(&game);
+  // The buffer holds one chunk plus the unconsumed rest of the previous one,
+  // which is at most a single token.
+  vector<char> buffer(2 * kChunkSize);
+  size_t rest = 0;
+  bool last = false;
+  while (!last) {
+    if (buffer.size() - rest < kChunkSize) {
+      // Tokens longer than a chunk need more lookahead.
+      buffer.resize(rest + kChunkSize);
+    }
+    stream.read(&buffer[rest], kChunkSize);
+    const size_t size = rest + stream.gcount();
+    last = !stream.good();
+    const char* beg = &buffer[0];
+    const char* end = beg + size;
+    const char* pos = reader.Feed(beg, end, last);
+    if (!pos) {
+      error_ = reader.error();
+      return game;
+    }
+    rest = end - pos;
+    std::copy(pos, end, buffer.begin());
+  }
+  if (!reader.Finish()) {
+    error_ = reader.error();
+  }
+  return game;
+}
+
+const string& Parser::error() const {
+  return error_;
+}
+
 size_t Parser::LoadHeader(const size_t pos, StrategicGame* game) const {
   assert(game);
   assert(pos < content_.size());
@@ -21,7 +21,7 @@ struct Outcome {
   std::vector<int> payoffs;
 };
 
-// Gambit strategic game format, the outcome version.
+// Gambit strategic game format, the outcome or the payoff version.
 struct StrategicGame {
   std::string Str() const;
 
@@ -29,8 +29,11 @@ struct StrategicGame {
   std::vector<std::string> players;
   std::vector<std::vector<std::string> > strategies;
   std::string comment;
+  // Outcome version only.
   std::vector<Outcome> outcomes;
   std::vector<int> payoff_indices;
+  // Payoff version only, the payoffs of each player by strategy profile id.
+  std::vector<std::vector<int> > payoffs;
 };
 
 class Parser {
@@ -71,12 +74,30 @@ class Parser {
   static size_t Between(const size_t beg, const char open, const char close,
                         const std::string& content, std::string* between);
 
+  // Parsing modes: kBuffered reads the whole file into the parser cache and
+  // copies out its sections (the payoff version is tokenized in a single
+  // pass), kMapped memory-maps the file and tokenizes it in a single pass
+  // without copying, kStream reads the file in fixed-size chunks and works on
+  // pipes and standard input (path kStdin) as well.
+  enum Mode { kBuffered, kMapped, kStream };
+
+  // Path used to read from standard input.
+  static const char* kStdin;
+  // Size of the chunks read in stream mode.
+  static const size_t kChunkSize;
+
   // Initialised the parser with given path.
   explicit Parser(const std::string& path);
 
-  // Parses a strategic game in outcome format.
+  // Initialised the parser with given path and parsing mode.
+  Parser(const std::string& path, const Mode mode);
+
+  // Parses a strategic game in outcome or payoff format.
   StrategicGame ParseStrategicGame();
 
+  // Returns the reason of the last parsing failure, empty if there was none.
+  const std::string& error() const;
+
  private:
   size_t LoadHeader(const size_t beg, StrategicGame* game) const;
   size_t LoadPlayers(const size_t beg, StrategicGame* game) const;
@@ -94,8 +115,23 @@ class Parser {
   // Reads the whole file into parser cache.
   void ReadAll();
 
+  // Returns true if the cached file is in the outcome format, given the
+  // position past the players section.
+  bool OutcomeFormat(const size_t pos) const;
+
+  // Parses the cached file in a single pass, for the payoff format.
+  StrategicGame ParseContent();
+
+  // Parses the memory-mapped file in a single pass.
+  StrategicGame ParseMapped();
+
+  // Parses the file or standard input chunk by chunk.
+  StrategicGame ParseStream();
+
   std::string path_;
   std::string content_;
+  std::string error_;
+  Mode mode_;
 };
 
 } }  // namespace ash::parse
@@ -0,0 +1,317 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./polymatrix-game.h"
+#include <cassert>
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./lemke-solver.h"
+
+using std::string;
+using std::stringstream;
+using std::vector;
+using std::deque;
+using std::max;
+
+namespace ash {
+
+// Backtracking search for pure strategy equilibria. It keeps for each player
+// the payoff sums of its strategies against the assigned neighbors, which are
+// updated incrementally along the edges of each assigned player.
+class PureSearch {
+ public:
+  PureSearch(const PolymatrixGame& game, const size_t max_num,
+             vector<StrategyProfile>* equilibria);
+  void Run();
+
+ private:
+  // Tries all strategies of the player at given position of the order.
+  void Assign(const int index);
+  // Adds the payoffs against given strategy of given player to the payoff
+  // sums of its neighbors, subtracts them for negative sign.
+  void Update(const int player, const int strategy, const int sign);
+  // Returns true if given player has no profitable deviation.
+  bool Stable(const int player) const;
+
+  const PolymatrixGame& game_;
+  size_t max_num_;
+  vector<StrategyProfile>* equilibria_;
+  // The players in assignment order.
+  vector<int> order_;
+  // The players to be checked after the assignment at each position.
+  vector<vector<int> > checks_;
+  // The payoff sums of each player's strategies against the assigned players.
+  vector<vector<int> > sums_;
+  StrategyProfile profile_;
+};
+
+PureSearch::PureSearch(const PolymatrixGame& game, const size_t max_num,
+                       vector<StrategyProfile>* equilibria)
+    : game_(game),
+      max_num_(max_num),
+      equilibria_(equilibria),
+      checks_(game.num_players()),
+      sums_(game.num_players()),
+      profile_(game.num_players(), 0) {
+  const int num_players = game.num_players();
+  // Breadth-first order keeps neighbors close, so that players are checked
+  // early in the search.
+  vector<int> position(num_players, -1);
+  for (int root = 0; root < num_players; ++root) {
+    if (position[root] != -1) {
+      continue;
+    }
+    deque<int> queue(1, root);
+    position[root] = order_.size();
+    order_.push_back(root);
+    while (!queue.empty()) {
+      const int p = queue.front();
+      queue.pop_front();
+      const vector<PolymatrixGame::HalfEdge>& edges = game.neighbors_[p];
+      for (auto it = edges.begin(), end = edges.end(); it != end; ++it) {
+        if (position[it->neighbor] == -1) {
+          position[it->neighbor] = order_.size();
+          order_.push_back(it->neighbor);
+          queue.push_back(it->neighbor);
+        }
+      }
+    }
+  }
+  for (int p = 0; p < num_players; ++p) {
+    int ready = position[p];
+    const vector<PolymatrixGame::HalfEdge>& edges = game.neighbors_[p];
+    for (auto it = edges.begin(), end = edges.end(); it != end; ++it) {
+      ready = max(ready, position[it->neighbor]);
+    }
+    checks_[ready].push_back(p);
+    sums_[p].assign(game.num_strategies(p), 0);
+  }
+}
+
+void PureSearch::Run() {
+  if (game_.num_players() && equilibria_->size() < max_num_) {
+    Assign(0);
+  }
+}
+
+void PureSearch::Assign(const int index) {
+  if (index == static_cast<int>(order_.size())) {
+    equilibria_->push_back(profile_);
+    return;
+  }
+  const int p = order_[index];
+  const int num_strategies = game_.num_strategies(p);
+  for (int s = 0; s < num_strategies && equilibria_->size() < max_num_; ++s) {
+    profile_.strategy(p, s);
+    Update(p, s, 1);
+    bool stable = true;
+    const vector<int>& checks = checks_[index];
+    for (auto it = checks.begin(), end = checks.end(); it != end && stable;
+         ++it) {
+      stable = Stable(*it);
+    }
+    if (stable) {
+      Assign(index + 1);
+    }
+    Update(p, s, -1);
+  }
+}
+
+void PureSearch::Update(const int player, const int strategy,
+                        const int sign) {
+  const int num_strategies = game_.num_strategies(player);
+  const vector<PolymatrixGame::HalfEdge>& edges = game_.neighbors_[player];
+  for (auto it = edges.begin(), end = edges.end(); it != end; ++it) {
+    vector<int>& sums = sums_[it->neighbor];
+    const int* payoffs = &game_.payoffs_[it->reverse_offset];
+    const int num_neighbor_strategies = sums.size();
+    for (int t = 0; t < num_neighbor_strategies; ++t) {
+      sums[t] += sign * payoffs[t * num_strategies + strategy];
+    }
+  }
+}
+
+bool PureSearch::Stable(const int player) const {
+  const vector<int>& sums = sums_[player];
+  return *std::max_element(sums.begin(), sums.end()) ==
+         sums[profile_[player]];
+}
+
+PolymatrixGame::PolymatrixGame(const string& name)
+    : name_(name),
+      num_edges_(0) {}
+
+int PolymatrixGame::AddPlayer(const string& name,
+                              const vector<string>& strategies) {
+  assert(strategies.size());
+  players_.push_back(name);
+  strategies_.push_back(strategies);
+  neighbors_.push_back(vector<HalfEdge>());
+  return players_.size() - 1;
+}
+
+int PolymatrixGame::AddEdge(const int u, const int v,
+                            const vector<int>& u_payoffs,
+                            const vector<int>& v_payoffs) {
+  assert(u >= 0 && u < num_players() && v >= 0 && v < num_players());
+  assert(u != v);
+  assert(static_cast<int>(u_payoffs.size()) ==
+         num_strategies(u) * num_strategies(v));
+  assert(v_payoffs.size() == u_payoffs.size());
+  const size_t u_offset = payoffs_.size();
+  payoffs_.insert(payoffs_.end(), u_payoffs.begin(), u_payoffs.end());
+  const size_t v_offset = payoffs_.size();
+  payoffs_.insert(payoffs_.end(), v_payoffs.begin(), v_payoffs.end());
+  const HalfEdge u_edge = {v, u_offset, v_offset};
+  const HalfEdge v_edge = {u, v_offset, u_offset};
+  neighbors_[u].push_back(u_edge);
+  neighbors_[v].push_back(v_edge);
+  return num_edges_++;
+}
+
+int PolymatrixGame::FindPure(const size_t max_num,
+                             vector<StrategyProfile>* equilibria) const {
+  assert(equilibria);
+  const size_t num_before = equilibria->size();
+  PureSearch search(*this, max_num, equilibria);
+  search.Run();
+  return equilibria->size() - num_before;
+}
+
+bool PolymatrixGame::FindMixed(MixedStrategyProfile* equilibrium) const {
+  assert(equilibrium);
+  // The LCP of Howson over the strategy probabilities x and the player values
+  // v: w = C x - E v >= 0 complementary to x and w = E'x - 1 >= 0
+  // complementary to v. The costs C = K - payoffs are positive, which makes
+  // M copositive-plus. The constant own block K shifts all strategies of a
+  // player equally and keeps x'Cx positive.
+  const int _num_players = num_players();
+  vector<int> offsets(_num_players + 1, 0);
+  for (int p = 0; p < _num_players; ++p) {
+    offsets[p + 1] = offsets[p] + num_strategies(p);
+  }
+  const int num_strategies_total = offsets[_num_players];
+  const int n = num_strategies_total + _num_players;
+  int max_payoff = 0;
+  for (auto it = payoffs_.begin(), end = payoffs_.end(); it != end; ++it) {
+    max_payoff = max(max_payoff, *it);
+  }
+  const double k = max_payoff + 1.0;
+  vector<vector<double> > m(n, vector<double>(n, 0.0));
+  vector<double> q(n, 0.0);
+  for (int p = 0; p < _num_players; ++p) {
+    const int num_own = num_strategies(p);
+    for (int s = 0; s < num_own; ++s) {
+      vector<double>& row = m[offsets[p] + s];
+      for (int s2 = 0; s2 < num_own; ++s2) {
+        row[offsets[p] + s2] = k;
+      }
+      const vector<HalfEdge>& edges = neighbors_[p];
+      for (auto it = edges.begin(), end = edges.end(); it != end; ++it) {
+        const int num_other = num_strategies(it->neighbor);
+        const int* payoffs = &payoffs_[it->offset + s * num_other];
+        for (int t = 0; t < num_other; ++t) {
+          row[offsets[it->neighbor] + t] += k - payoffs[t];
+        }
+      }
+      row[num_strategies_total + p] = -1.0;
+      m[num_strategies_total + p][offsets[p] + s] = 1.0;
+    }
+    q[num_strategies_total + p] = -1.0;
+  }
+  LemkeSolver solver(m, q);
+  if (!solver.Solve()) {
+    return false;
+  }
+  const vector<double>& z = solver.solution();
+  MixedStrategyProfile profile(_num_players);
+  for (int p = 0; p < _num_players; ++p) {
+    const int num_own = num_strategies(p);
+    double sum = 0.0;
+    for (int s = 0; s < num_own; ++s) {
+      sum += z[offsets[p] + s];
+    }
+    profile.SetNumStrategies(p, num_own);
+    for (int s = 0; s < num_own; ++s) {
+      profile.AddProbability(p, s, z[offsets[p] + s] / sum);
+    }
+  }
+  *equilibrium = profile;
+  return true;
+}
+
+int PolymatrixGame::payoff(const StrategyProfile& profile,
+                           const int player_id) const {
+  return payoffs(profile, player_id)[profile[player_id]];
+}
+
+vector<int> PolymatrixGame::payoffs(const StrategyProfile& profile,
+                                    const int player_id) const {
+  assert(profile.size() == num_players());
+  const int num_own = num_strategies(player_id);
+  vector<int> sums(num_own, 0);
+  const vector<HalfEdge>& edges = neighbors_[player_id];
+  for (auto it = edges.begin(), end = edges.end(); it != end; ++it) {
+    const int num_other = num_strategies(it->neighbor);
+    const int t = profile[it->neighbor];
+    for (int s = 0; s < num_own; ++s) {
+      sums[s] += payoffs_[it->offset + s * num_other + t];
+    }
+  }
+  return sums;
+}
+
+const string& PolymatrixGame::name() const {
+  return name_;
+}
+
+const string& PolymatrixGame::player(const int id) const {
+  assert(id >= 0 && id < num_players());
+  return players_[id];
+}
+
+const string& PolymatrixGame::strategy(const int player_id,
+                                       const int id) const {
+  assert(id >= 0 && id < num_strategies(player_id));
+  return strategies_[player_id][id];
+}
+
+int PolymatrixGame::num_players() const {
+  return players_.size();
+}
+
+int PolymatrixGame::num_strategies(const int player_id) const {
+  assert(player_id >= 0 && player_id < num_players());
+  return strategies_[player_id].size();
+}
+
+int PolymatrixGame::num_edges() const {
+  return num_edges_;
+}
+
+string PolymatrixGame::str(const StrategyProfile& profile) const {
+  stringstream ss;
+  ss << "(pure profile";
+  for (int p = 0; p < profile.size(); ++p) {
+    ss << "\n  (" << player(p) << " " << strategy(p, profile[p]) << ")";
+  }
+  ss << ")";
+  return ss.str();
+}
+
+string PolymatrixGame::str(const MixedStrategyProfile& profile) const {
+  stringstream ss;
+  ss << "(mixed profile ";
+  for (int p = 0; p < num_players(); ++p) {
+    ss << "\n  (" << player(p);
+    for (int s = 0; s < num_strategies(p); ++s) {
+      ss << " (" << profile.probability(p, s) << " " << strategy(p, s) << ")";
+    }
+    ss << ")";
+  }
+  ss << ")";
+  return ss.str();
+}
+
+}  // namespace ash
@@ -0,0 +1,73 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_POLYMATRIX_GAME_H_
+#define SRC_POLYMATRIX_GAME_H_
+
+#include <string>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Graphical game, in which the payoff of each player is the sum of pairwise
+// interactions with its neighbors, each given by a payoff matrix for both
+// players of the edge. Unlike Game it holds no payoffs per strategy profile,
+// its size and the work of its solvers scale with the number of edges.
+class PolymatrixGame {
+ public:
+  explicit PolymatrixGame(const std::string& name);
+  int AddPlayer(const std::string& name,
+                const std::vector<std::string>& strategies);
+  // Adds the interaction between players u and v. The payoffs of u are
+  // indexed by s_u * num_strategies(v) + s_v, those of v by
+  // s_v * num_strategies(u) + s_u. Returns the edge id.
+  int AddEdge(const int u, const int v, const std::vector<int>& u_payoffs,
+              const std::vector<int>& v_payoffs);
+
+  // Appends the pure strategy equilibria, until given number of equilibria
+  // is reached. The players are assigned in breadth-first order, each player
+  // is checked for a profitable deviation as soon as its neighbors are
+  // assigned, which prunes the search to the consistent partial profiles.
+  // Returns the number of equilibria found.
+  int FindPure(const size_t max_num,
+               std::vector<StrategyProfile>* equilibria) const;
+  // Finds a mixed strategy equilibrium by solving the polymatrix LCP with
+  // Lemke's method. Returns false if the method failed.
+  bool FindMixed(MixedStrategyProfile* equilibrium) const;
+
+  // Returns the payoff of given player in given profile.
+  int payoff(const StrategyProfile& profile, const int player_id) const;
+  // Returns the payoff sum of the neighbors of given player for each of its
+  // strategies against given profile.
+  std::vector<int> payoffs(const StrategyProfile& profile,
+                           const int player_id) const;
+  const std::string& name() const;
+  const std::string& player(const int id) const;
+  const std::string& strategy(const int player_id, const int id) const;
+  int num_players() const;
+  int num_strategies(const int player_id) const;
+  int num_edges() const;
+  std::string str(const StrategyProfile& profile) const;
+  std::string str(const MixedStrategyProfile& profile) const;
+
+ private:
+  // The interaction of a player with one neighbor, its payoffs are indexed
+  // by own strategy * num_strategies(neighbor) + neighbor strategy, those of
+  // the neighbor at the reverse offset the other way around.
+  struct HalfEdge {
+    int neighbor;
+    size_t offset;
+    size_t reverse_offset;
+  };
+
+  friend class PureSearch;
+
+  std::string name_;
+  std::vector<std::string> players_;
+  std::vector<std::vector<std::string> > strategies_;
+  std::vector<std::vector<HalfEdge> > neighbors_;
+  std::vector<int> payoffs_;
+  int num_edges_;
+};
+
+}  // namespace ash
+#endif  // SRC_POLYMATRIX_GAME_H_
@@ -0,0 +1,164 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./polymatrix-reader.h"
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./polymatrix-game.h"
+
+using std::string;
+using std::stringstream;
+using std::vector;
+
+namespace ash { namespace parse {
+
+// The header word of the polymatrix format.
+static const char kHeader[] = "PMG";
+
+bool PolymatrixReader::Detect(const char* beg, const char* end) {
+  Token token;
+  NfgReader::NextToken(beg, end, &token);
+  return token.type == Token::kWord && token.str() == kHeader;
+}
+
+PolymatrixReader::PolymatrixReader(PolymatrixGame* game)
+    : game_(game),
+      beg_(NULL),
+      pos_(NULL),
+      end_(NULL) {
+  assert(game_);
+}
+
+bool PolymatrixReader::Read(const char* beg, const char* end) {
+  beg_ = beg;
+  pos_ = beg;
+  end_ = end;
+  if (!Next() || token_.type != Token::kWord || token_.str() != kHeader) {
+    return Fail("Expected PMG header");
+  }
+  if (!Next() || token_.type != Token::kNumber || token_.number != 1) {
+    return Fail("Expected version 1");
+  }
+  if (!Next() || token_.type != Token::kWord || token_.str() != "R") {
+    return Fail("Expected format R");
+  }
+  if (!Next() || token_.type != Token::kString) {
+    return Fail("Expected game name");
+  }
+  *game_ = PolymatrixGame(token_.str());
+  vector<string> players;
+  if (!Next() || token_.type != Token::kOpen) {
+    return Fail("Expected players");
+  }
+  while (Next() && token_.type == Token::kString) {
+    players.push_back(token_.str());
+  }
+  if (token_.type != Token::kClose || players.empty()) {
+    return Fail("Expected player name");
+  }
+  if (!Next() || token_.type != Token::kOpen) {
+    return Fail("Expected strategies");
+  }
+  for (size_t p = 0; p < players.size(); ++p) {
+    vector<string> strategies;
+    if (!Next()) {
+      return Fail("Expected strategies for each player");
+    }
+    if (token_.type == Token::kNumber && token_.number > 0) {
+      // Strategies given by their number are named by their position.
+      for (int s = 1; s <= token_.number; ++s) {
+        stringstream ss;
+        ss << s;
+        strategies.push_back(ss.str());
+      }
+    } else if (token_.type == Token::kOpen) {
+      while (Next() && token_.type == Token::kString) {
+        strategies.push_back(token_.str());
+      }
+      if (token_.type != Token::kClose || strategies.empty()) {
+        return Fail("Expected strategy name");
+      }
+    } else {
+      return Fail("Expected strategies for each player");
+    }
+    game_->AddPlayer(players[p], strategies);
+  }
+  if (!Next() || token_.type != Token::kClose) {
+    return Fail("Expected strategies for each player");
+  }
+  if (Next() && token_.type == Token::kString) {
+    // Skipping the comment.
+    Next();
+  }
+  if (token_.type != Token::kOpen) {
+    return Fail("Expected edges");
+  }
+  while (Next() && token_.type == Token::kOpen) {
+    int players_ids[2];
+    for (int i = 0; i < 2; ++i) {
+      if (!Next() || token_.type != Token::kNumber || token_.number < 1 ||
+          token_.number > game_->num_players()) {
+        return Fail("Expected player id");
+      }
+      players_ids[i] = token_.number - 1;
+    }
+    const int u = players_ids[0];
+    const int v = players_ids[1];
+    if (u == v) {
+      return Fail("Expected distinct players");
+    }
+    const size_t size = game_->num_strategies(u) * game_->num_strategies(v);
+    vector<int> u_payoffs;
+    vector<int> v_payoffs;
+    if (!ReadNumbers(&u_payoffs) || !ReadNumbers(&v_payoffs)) {
+      return false;
+    }
+    if (u_payoffs.size() != size || v_payoffs.size() != size) {
+      stringstream ss;
+      ss << "Expected " << size << " payoffs per player";
+      return Fail(ss.str());
+    }
+    if (!Next() || token_.type != Token::kClose) {
+      return Fail("Expected end of edge");
+    }
+    game_->AddEdge(u, v, u_payoffs, v_payoffs);
+  }
+  if (token_.type != Token::kClose) {
+    return Fail("Expected edge");
+  }
+  if (Next()) {
+    return Fail("Unexpected trailing input");
+  }
+  return true;
+}
+
+bool PolymatrixReader::Next() {
+  pos_ = NfgReader::NextToken(pos_, end_, &token_);
+  return token_.type != Token::kNone;
+}
+
+bool PolymatrixReader::ReadNumbers(vector<int>* numbers) {
+  if (!Next() || token_.type != Token::kOpen) {
+    return Fail("Expected payoffs");
+  }
+  while (Next() && token_.type == Token::kNumber) {
+    numbers->push_back(token_.number);
+  }
+  if (token_.type != Token::kClose) {
+    return Fail("Expected payoff");
+  }
+  return true;
+}
+
+bool PolymatrixReader::Fail(const string& reason) {
+  stringstream ss;
+  ss << reason << " at byte " << token_.beg - beg_;
+  error_ = ss.str();
+  return false;
+}
+
+const string& PolymatrixReader::error() const {
+  return error_;
+}
+
+} }  // namespace ash::parse
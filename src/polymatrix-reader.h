@@ -0,0 +1,59 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_POLYMATRIX_READER_H_
+#define SRC_POLYMATRIX_READER_H_
+
+#include <string>
+#include <vector>
+#include "./nfg-reader.h"
+
+namespace ash {
+
+class PolymatrixGame;
+
+namespace parse {
+
+// Reader for polymatrix games in a format modelled after the Gambit
+// strategic game format. The header and strategies are the same, the payoffs
+// are given per edge by the 1-based ids of both players, followed by the
+// payoffs of the first player indexed by its strategy times the number of
+// strategies of the second player plus the strategy of the second player,
+// and the payoffs of the second player the other way around:
+//   PMG 1 R "Ring" { "P1" "P2" "P3" }
+//   { { "A" "B" } 2 2 }
+//   ""
+//   {
+//   { 1 2 { 1 0 0 1 } { 1 0 0 1 } }
+//   { 2 3 { 1 0 0 1 } { 0 1 1 0 } }
+//   }
+class PolymatrixReader {
+ public:
+  // Returns true if the character range starts with the polymatrix header.
+  static bool Detect(const char* beg, const char* end);
+
+  explicit PolymatrixReader(PolymatrixGame* game);
+
+  // Reads a complete game from the character range [beg, end).
+  // Returns false on malformed input, the reason is given by error().
+  bool Read(const char* beg, const char* end);
+
+  const std::string& error() const;
+
+ private:
+  // Scans the next token, returns false at the end of the input.
+  bool Next();
+  // Reads a braced list of numbers.
+  bool ReadNumbers(std::vector<int>* numbers);
+  // Sets the error message with the current position and returns false.
+  bool Fail(const std::string& reason);
+
+  PolymatrixGame* game_;
+  const char* beg_;
+  const char* pos_;
+  const char* end_;
+  Token token_;
+  std::string error_;
+};
+
+}  // namespace parse
+}  // namespace ash
+#endif  // SRC_POLYMATRIX_READER_H_
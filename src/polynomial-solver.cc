@@ -0,0 +1,307 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./polynomial-solver.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+namespace ash {
+
+// Tolerance for the residual and the singular Jacobians.
+static const double kEpsilon = 1e-9;
+// Tolerance for the best response and positivity conditions and for the
+// distinction of solutions.
+static const double kEquilibriumEpsilon = 1e-6;
+// Maximum number of Newton iterations per start.
+static const int kMaxNumIterations = 50;
+// Minimum weight of a strategy in the random starts before normalization.
+static const double kMinRandomWeight = 0.01;
+
+// Solves the n x n system a x = b in place by Gaussian elimination with
+// partial pivoting. Returns false if the system is singular.
+static bool SolveLinear(vector<vector<double> >* a, vector<double>* b) {
+  const int n = b->size();
+  for (int c = 0; c < n; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < n; ++r) {
+      if (std::fabs((*a)[r][c]) > std::fabs((*a)[pivot][c])) {
+        pivot = r;
+      }
+    }
+    if (std::fabs((*a)[pivot][c]) < kEpsilon) {
+      return false;
+    }
+    std::swap((*a)[c], (*a)[pivot]);
+    std::swap((*b)[c], (*b)[pivot]);
+    for (int r = c + 1; r < n; ++r) {
+      const double factor = (*a)[r][c] / (*a)[c][c];
+      for (int j = c; j < n; ++j) {
+        (*a)[r][j] -= factor * (*a)[c][j];
+      }
+      (*b)[r] -= factor * (*b)[c];
+    }
+  }
+  for (int r = n - 1; r >= 0; --r) {
+    for (int j = r + 1; j < n; ++j) {
+      (*b)[r] -= (*a)[r][j] * (*b)[j];
+    }
+    (*b)[r] /= (*a)[r][r];
+  }
+  return true;
+}
+
+PolynomialSolver::PolynomialSolver(const Game& game)
+    : game_(game),
+      num_players_(game.num_players()),
+      payoffs_(num_players_, vector<double>(game.num_strategy_profiles())),
+      supports_(num_players_),
+      support_ids_(num_players_),
+      offsets_(num_players_),
+      expected_(num_players_),
+      num_iterations_(0) {
+  int max_payoff = 1;
+  for (int p = 0; p < num_players_; ++p) {
+    assert(game.num_strategies(p) <= 32);
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      max_payoff = std::max(max_payoff, std::abs(game.payoff(id, p)));
+    }
+    expected_[p].resize(game.num_strategies(p));
+  }
+  for (int p = 0; p < num_players_; ++p) {
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      payoffs_[p][id] = double(game.payoff(id, p)) / max_payoff;
+    }
+  }
+}
+
+int PolynomialSolver::Solve(const vector<uint32_t>& supports,
+                            vector<MixedStrategyProfile>* equilibria) {
+  assert(static_cast<int>(supports.size()) == num_players_);
+  int num_vars = 0;
+  for (int p = 0; p < num_players_; ++p) {
+    supports_[p].clear();
+    support_ids_[p].clear();
+    offsets_[p] = num_vars;
+    for (int s = 0; s < game_.num_strategies(p); ++s) {
+      if (supports[p] & (1u << s)) {
+        supports_[p].push_back(s);
+        support_ids_[p].push_back(s * game_.stride(p));
+      }
+    }
+    assert(supports_[p].size());
+    num_vars += supports_[p].size();
+  }
+  // Without mixed supports the barycenter is the only solution.
+  const int num_free_vars = num_vars - num_players_;
+  const int num_starts = num_free_vars ? 1 + num_vars + num_free_vars : 1;
+  std::minstd_rand random;
+  vector<vector<double> > solutions;
+  probs_.resize(num_vars);
+  for (int start = 0; start < num_starts; ++start) {
+    if (!SetStart(start, &random) || !Newton() || !Equilibrium()) {
+      continue;
+    }
+    bool distinct = true;
+    for (auto it = solutions.begin(); it != solutions.end() && distinct;
+         ++it) {
+      double distance = 0.0;
+      for (int v = 0; v < num_vars; ++v) {
+        distance = std::max(distance, std::fabs((*it)[v] - probs_[v]));
+      }
+      distinct = distance > kEquilibriumEpsilon;
+    }
+    if (!distinct) {
+      continue;
+    }
+    solutions.push_back(probs_);
+    MixedStrategyProfile profile(num_players_);
+    for (int p = 0; p < num_players_; ++p) {
+      profile.SetNumStrategies(p, game_.num_strategies(p));
+      for (size_t i = 0; i < supports_[p].size(); ++i) {
+        profile.AddProbability(p, supports_[p][i], probs_[offsets_[p] + i]);
+      }
+    }
+    equilibria->push_back(profile);
+  }
+  return solutions.size();
+}
+
+bool PolynomialSolver::SetStart(const int start, std::minstd_rand* random) {
+  std::uniform_real_distribution<double> distribution(kMinRandomWeight, 1.0);
+  for (int p = 0; p < num_players_; ++p) {
+    const int first = offsets_[p];
+    const int size = supports_[p].size();
+    if (start == 0 || (size == 1 && start == first + 1)) {
+      // The barycenter, which is halfway to the vertex of a pure support, too.
+      std::fill(probs_.begin() + first, probs_.begin() + first + size,
+                1.0 / size);
+      if (start) {
+        return false;
+      }
+    } else if (start <= static_cast<int>(probs_.size())) {
+      const int var = start - 1;
+      const bool own = var >= first && var < first + size;
+      for (int i = 0; i < size; ++i) {
+        probs_[first + i] = own ? (first + i == var) * 0.5 + 0.5 / size :
+                                  1.0 / size;
+      }
+    } else {
+      double sum = 0.0;
+      for (int i = 0; i < size; ++i) {
+        probs_[first + i] = distribution(*random);
+        sum += probs_[first + i];
+      }
+      for (int i = 0; i < size; ++i) {
+        probs_[first + i] /= sum;
+      }
+    }
+  }
+  return true;
+}
+
+bool PolynomialSolver::Newton() {
+  const int size = probs_.size();
+  vector<double> residual(size);
+  vector<vector<double> > jacobian(size, vector<double>(size));
+  for (int iteration = 0; iteration < kMaxNumIterations; ++iteration) {
+    Evaluate(&residual, &jacobian);
+    double norm = 0.0;
+    for (int i = 0; i < size; ++i) {
+      norm = std::max(norm, std::fabs(residual[i]));
+    }
+    ++num_iterations_;
+    vector<double>& step = residual;
+    if (!SolveLinear(&jacobian, &step)) {
+      return false;
+    }
+    // Converged if the step is small as well, the slow convergence towards a
+    // singular root on the boundary leaves a small residual only.
+    double step_norm = 0.0;
+    for (int i = 0; i < size; ++i) {
+      step_norm = std::max(step_norm, std::fabs(step[i]));
+    }
+    if (norm < kEpsilon && step_norm < kEpsilon) {
+      return true;
+    }
+    // Damp the step to stay within the positive orthant.
+    double lambda = 1.0;
+    for (int i = 0; i < size; ++i) {
+      if (probs_[i] - lambda * step[i] < 0.0) {
+        lambda = 0.9 * probs_[i] / step[i];
+      }
+    }
+    if (lambda < kEpsilon) {
+      return false;
+    }
+    for (int i = 0; i < size; ++i) {
+      probs_[i] -= lambda * step[i];
+      // Heads for a root outside of the positive orthant.
+      if (probs_[i] <= kEquilibriumEpsilon) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+void PolynomialSolver::Evaluate(vector<double>* residual,
+                                vector<vector<double> >* jacobian) {
+  vector<int> counters(num_players_);
+  // The product of the probabilities of all opponents except one.
+  vector<double> partials(num_players_);
+  vector<double> prefix(num_players_ + 1);
+  for (int p = 0; p < num_players_; ++p) {
+    const int num_strategies = game_.num_strategies(p);
+    const int64_t stride = game_.stride(p);
+    const vector<int64_t>& own_ids = support_ids_[p];
+    const int first = offsets_[p];
+    const int size = own_ids.size();
+    vector<double>& expected = expected_[p];
+    std::fill(expected.begin(), expected.end(), 0.0);
+    // The first row of each player sums up its probabilities, the others
+    // equalize the expected payoffs of its supported strategies.
+    (*residual)[first] = -1.0;
+    for (int i = 0; i < size; ++i) {
+      (*residual)[first] += probs_[first + i];
+      vector<double>& row = (*jacobian)[first + i];
+      std::fill(row.begin(), row.end(), 0.0);
+    }
+    std::fill((*jacobian)[first].begin() + first,
+              (*jacobian)[first].begin() + first + size, 1.0);
+    // Odometer over the support profiles of the opponents.
+    std::fill(counters.begin(), counters.end(), 0);
+    while (true) {
+      int64_t id = 0;
+      prefix[0] = 1.0;
+      for (int q = 0; q < num_players_; ++q) {
+        const bool own = q == p;
+        const double prob = own ? 1.0 : probs_[offsets_[q] + counters[q]];
+        id += own ? 0 : support_ids_[q][counters[q]];
+        prefix[q + 1] = prefix[q] * prob;
+      }
+      double suffix = 1.0;
+      for (int q = num_players_ - 1; q >= 0; --q) {
+        partials[q] = prefix[q] * suffix;
+        suffix *= q == p ? 1.0 : probs_[offsets_[q] + counters[q]];
+      }
+      const double* payoffs = &payoffs_[p][id];
+      const double weight = prefix[num_players_];
+      for (int s = 0; s < num_strategies; ++s) {
+        expected[s] += payoffs[s * stride] * weight;
+      }
+      const double base = payoffs[own_ids[0]];
+      for (int i = 1; i < size; ++i) {
+        const double difference = payoffs[own_ids[i]] - base;
+        vector<double>& row = (*jacobian)[first + i];
+        for (int q = 0; q < num_players_; ++q) {
+          if (q != p) {
+            row[offsets_[q] + counters[q]] += difference * partials[q];
+          }
+        }
+      }
+      int q = 0;
+      while (q < num_players_ && (q == p || ++counters[q] ==
+                                  static_cast<int>(supports_[q].size()))) {
+        if (q != p) {
+          counters[q] = 0;
+        }
+        ++q;
+      }
+      if (q == num_players_) {
+        break;
+      }
+    }
+    for (int i = 1; i < size; ++i) {
+      (*residual)[first + i] = expected[supports_[p][i]] -
+                               expected[supports_[p][0]];
+    }
+  }
+}
+
+bool PolynomialSolver::Equilibrium() const {
+  for (int p = 0; p < num_players_; ++p) {
+    const vector<int>& support = supports_[p];
+    const vector<double>& expected = expected_[p];
+    for (size_t i = 0; i < support.size(); ++i) {
+      if (probs_[offsets_[p] + i] <= kEquilibriumEpsilon) {
+        return false;
+      }
+    }
+    const double value = expected[support[0]];
+    for (size_t s = 0; s < expected.size(); ++s) {
+      if (expected[s] > value + kEquilibriumEpsilon) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int64_t PolynomialSolver::num_iterations() const {
+  return num_iterations_;
+}
+
+}  // namespace ash
@@ -0,0 +1,67 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_POLYNOMIAL_SOLVER_H_
+#define SRC_POLYNOMIAL_SOLVER_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Solves the support systems of games with any number of players. With the
+// supports fixed, the expected payoff of a strategy is a multilinear
+// polynomial in the probabilities of the opponents, a product of one
+// probability per opponent for each profile of their supports. Each player
+// must be indifferent between its supported strategies and its probabilities
+// sum up to 1, which is a square polynomial system. It is solved by Newton's
+// method with the exact Jacobian from several starts, damped to stay within
+// the positive orthant. A solution is an equilibrium if no unsupported
+// strategy pays more. The payoffs are scaled to [-1, 1] for the tolerances.
+// Unlike a full homotopy, the starts may miss solutions of large supports.
+// The supports are bit masks, each player may have at most 32 strategies.
+class PolynomialSolver {
+ public:
+  explicit PolynomialSolver(const Game& game);
+  // Solves the system of given support profile and appends the distinct
+  // equilibria with exactly these supports. Returns the number of appended
+  // equilibria.
+  int Solve(const std::vector<uint32_t>& supports,
+            std::vector<MixedStrategyProfile>* equilibria);
+  // Returns the number of Newton iterations of all calls of Solve.
+  int64_t num_iterations() const;
+
+ private:
+  // Sets the probabilities to given start, the barycenter of the supports
+  // first, then halfway from it to the vertex of each supported strategy and
+  // random points. Returns false for starts which equal the barycenter.
+  bool SetStart(const int start, std::minstd_rand* random);
+  // Runs Newton's method from the current probabilities. Returns true if both
+  // the residual and the last step vanish.
+  bool Newton();
+  // Sets the expected payoffs of all strategies against the current
+  // probabilities and the residual and Jacobian of the system.
+  void Evaluate(std::vector<double>* residual,
+                std::vector<std::vector<double> >* jacobian);
+  // Returns true if the current solution is an equilibrium with exactly the
+  // current supports.
+  bool Equilibrium() const;
+
+  const Game& game_;
+  int num_players_;
+  // Payoffs per player indexed by profile id, scaled to [-1, 1].
+  std::vector<std::vector<double> > payoffs_;
+  // The supported strategies of each player, their profile id offsets and
+  // the index of the first probability of each player in the variables.
+  std::vector<std::vector<int> > supports_;
+  std::vector<std::vector<int64_t> > support_ids_;
+  std::vector<int> offsets_;
+  // The probabilities of the supported strategies.
+  std::vector<double> probs_;
+  // Expected payoffs of each strategy of each player.
+  std::vector<std::vector<double> > expected_;
+  int64_t num_iterations_;
+};
+
+}  // namespace ash
+#endif  // SRC_POLYNOMIAL_SOLVER_H_
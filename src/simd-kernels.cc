@@ -0,0 +1,271 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./simd-kernels.h"
+#include <cassert>
+#include <algorithm>
+
+// Function-level target attributes for the intrinsics need GCC 4.9 or newer.
+#if defined(__x86_64__) && defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define ASH_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace ash {
+namespace simd {
+
+static void MaxIntoScalar(const int* in, const int64_t n, int* out) {
+  for (int64_t i = 0; i < n; ++i) {
+    out[i] = std::max(out[i], in[i]);
+  }
+}
+
+static int MaxScalar(const int* in, const int64_t n) {
+  return *std::max_element(in, in + n);
+}
+
+static void ClearUnequalScalar(const int* payoffs, const int* best,
+                               const int64_t n, int32_t* mask) {
+  for (int64_t i = 0; i < n; ++i) {
+    mask[i] &= -static_cast<int32_t>(payoffs[i] == best[i]);
+  }
+}
+
+static void ClearUnequalBroadcastScalar(const int* payoffs, const int best,
+                                        const int64_t n, int32_t* mask) {
+  for (int64_t i = 0; i < n; ++i) {
+    mask[i] &= -static_cast<int32_t>(payoffs[i] == best);
+  }
+}
+
+static int64_t NextSetScalar(const int32_t* mask, const int64_t n) {
+  return std::find_if(mask, mask + n, [](const int32_t m) { return m; }) -
+         mask;
+}
+
+#ifdef ASH_SIMD
+__attribute__((target("avx2")))
+static void MaxIntoAvx2(const int* in, const int64_t n, int* out) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_max_epi32(a, b));
+  }
+  MaxIntoScalar(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static int MaxAvx2(const int* in, const int64_t n) {
+  if (n < 8) {
+    return MaxScalar(in, n);
+  }
+  __m256i max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+  int64_t i = 8;
+  for (; i + 8 <= n; i += 8) {
+    max = _mm256_max_epi32(
+        max, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)));
+  }
+  int lanes[8];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), max);
+  const int lane_max = MaxScalar(lanes, 8);
+  return i < n ? std::max(lane_max, MaxScalar(in + i, n - i)) : lane_max;
+}
+
+__attribute__((target("avx2")))
+static void ClearUnequalAvx2(const int* payoffs, const int* best,
+                             const int64_t n, int32_t* mask) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(payoffs + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(best + i));
+    __m256i* m = reinterpret_cast<__m256i*>(mask + i);
+    _mm256_storeu_si256(m, _mm256_and_si256(_mm256_loadu_si256(m),
+                                            _mm256_cmpeq_epi32(a, b)));
+  }
+  ClearUnequalScalar(payoffs + i, best + i, n - i, mask + i);
+}
+
+__attribute__((target("avx2")))
+static void ClearUnequalBroadcastAvx2(const int* payoffs, const int best,
+                                      const int64_t n, int32_t* mask) {
+  const __m256i b = _mm256_set1_epi32(best);
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(payoffs + i));
+    __m256i* m = reinterpret_cast<__m256i*>(mask + i);
+    _mm256_storeu_si256(m, _mm256_and_si256(_mm256_loadu_si256(m),
+                                            _mm256_cmpeq_epi32(a, b)));
+  }
+  ClearUnequalBroadcastScalar(payoffs + i, best, n - i, mask + i);
+}
+
+__attribute__((target("avx2")))
+static int64_t NextSetAvx2(const int32_t* mask, const int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i m =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+    if (!_mm256_testz_si256(m, m)) {
+      break;
+    }
+  }
+  return i + NextSetScalar(mask + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void MaxIntoAvx512(const int* in, const int64_t n, int* out) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i a = _mm512_loadu_si512(in + i);
+    const __m512i b = _mm512_loadu_si512(out + i);
+    _mm512_storeu_si512(out + i, _mm512_mask_max_epi32(b, 0xffff, a, b));
+  }
+  MaxIntoScalar(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx512f")))
+static int MaxAvx512(const int* in, const int64_t n) {
+  if (n < 16) {
+    return MaxScalar(in, n);
+  }
+  __m512i max = _mm512_loadu_si512(in);
+  int64_t i = 16;
+  for (; i + 16 <= n; i += 16) {
+    max = _mm512_mask_max_epi32(max, 0xffff, max, _mm512_loadu_si512(in + i));
+  }
+  int lanes[16];
+  _mm512_storeu_si512(lanes, max);
+  const int lane_max = MaxScalar(lanes, 16);
+  return i < n ? std::max(lane_max, MaxScalar(in + i, n - i)) : lane_max;
+}
+
+__attribute__((target("avx512f")))
+static void ClearUnequalAvx512(const int* payoffs, const int* best,
+                               const int64_t n, int32_t* mask) {
+  // Only the unequal positions are stored, which clears them.
+  const __m512i zero = _mm512_setzero_si512();
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i a = _mm512_loadu_si512(payoffs + i);
+    const __m512i b = _mm512_loadu_si512(best + i);
+    _mm512_mask_storeu_epi32(mask + i, _mm512_cmpneq_epi32_mask(a, b), zero);
+  }
+  ClearUnequalScalar(payoffs + i, best + i, n - i, mask + i);
+}
+
+__attribute__((target("avx512f")))
+static void ClearUnequalBroadcastAvx512(const int* payoffs, const int best,
+                                        const int64_t n, int32_t* mask) {
+  const __m512i b = _mm512_set1_epi32(best);
+  const __m512i zero = _mm512_setzero_si512();
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i a = _mm512_loadu_si512(payoffs + i);
+    _mm512_mask_storeu_epi32(mask + i, _mm512_cmpneq_epi32_mask(a, b), zero);
+  }
+  ClearUnequalBroadcastScalar(payoffs + i, best, n - i, mask + i);
+}
+
+__attribute__((target("avx512f")))
+static int64_t NextSetAvx512(const int32_t* mask, const int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i m = _mm512_loadu_si512(mask + i);
+    const __mmask16 set = _mm512_test_epi32_mask(m, m);
+    if (set) {
+      return i + __builtin_ctz(set);
+    }
+  }
+  return i + NextSetScalar(mask + i, n - i);
+}
+#endif  // ASH_SIMD
+
+// The kernels of the selected level.
+struct Kernels {
+  Level level;
+  void (*max_into)(const int*, const int64_t, int*);
+  int (*max)(const int*, const int64_t);
+  void (*clear_unequal)(const int*, const int*, const int64_t, int32_t*);
+  void (*clear_unequal_broadcast)(const int*, const int, const int64_t,
+                                  int32_t*);
+  int64_t (*next_set)(const int32_t*, const int64_t);
+};
+
+static Kernels CreateKernels(const Level level) {
+  Kernels kernels = {kScalar, MaxIntoScalar, MaxScalar, ClearUnequalScalar,
+                     ClearUnequalBroadcastScalar, NextSetScalar};
+#ifdef ASH_SIMD
+  if (level == kAvx2) {
+    kernels = {kAvx2, MaxIntoAvx2, MaxAvx2, ClearUnequalAvx2,
+               ClearUnequalBroadcastAvx2, NextSetAvx2};
+  } else if (level == kAvx512) {
+    kernels = {kAvx512, MaxIntoAvx512, MaxAvx512, ClearUnequalAvx512,
+               ClearUnequalBroadcastAvx512, NextSetAvx512};
+  }
+#endif
+  return kernels;
+}
+
+static Kernels kernels = CreateKernels(SupportedLevel());
+
+Level SupportedLevel() {
+#ifdef ASH_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return kAvx2;
+  }
+#endif
+  return kScalar;
+}
+
+void SetLevel(const Level level) {
+  assert(level <= SupportedLevel());
+  kernels = CreateKernels(level);
+}
+
+Level level() {
+  return kernels.level;
+}
+
+const char* LevelName(const Level level) {
+  static const char* kNames[] = {"scalar", "avx2", "avx512"};
+  return kNames[level];
+}
+
+namespace internal {
+
+void MaxInto(const int* in, const int64_t n, int* out) {
+  kernels.max_into(in, n, out);
+}
+
+int Max(const int* in, const int64_t n) {
+  return kernels.max(in, n);
+}
+
+void ClearUnequal(const int* payoffs, const int* best, const int64_t n,
+                  int32_t* mask) {
+  kernels.clear_unequal(payoffs, best, n, mask);
+}
+
+void ClearUnequal(const int* payoffs, const int best, const int64_t n,
+                  int32_t* mask) {
+  kernels.clear_unequal_broadcast(payoffs, best, n, mask);
+}
+
+int64_t NextSet(const int32_t* mask, const int64_t n) {
+  return kernels.next_set(mask, n);
+}
+
+}  // namespace internal
+
+}  // namespace simd
+}  // namespace ash
@@ -0,0 +1,99 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_SIMD_KERNELS_H_
+#define SRC_SIMD_KERNELS_H_
+
+#include <cstdint>
+
+namespace ash {
+namespace simd {
+
+// Instruction set levels of the kernels. The highest level supported by the
+// processor is selected at runtime, the scalar kernels are always available.
+enum Level { kScalar, kAvx2, kAvx512 };
+
+// Returns the highest level supported by the processor and the build.
+Level SupportedLevel();
+// Selects the kernels of given level, which has to be supported.
+void SetLevel(const Level level);
+Level level();
+const char* LevelName(const Level level);
+
+// Calls of the kernels with fewer elements run inline, the call through the
+// selected kernels costs more than the vectorization gains.
+static const int64_t kMinVectorSize = 16;
+
+namespace internal {
+
+void MaxInto(const int* in, const int64_t n, int* out);
+int Max(const int* in, const int64_t n);
+void ClearUnequal(const int* payoffs, const int* best, const int64_t n,
+                  int32_t* mask);
+void ClearUnequal(const int* payoffs, const int best, const int64_t n,
+                  int32_t* mask);
+int64_t NextSet(const int32_t* mask, const int64_t n);
+
+}  // namespace internal
+
+// Sets out[i] = max(out[i], in[i]) for i in [0, n).
+inline void MaxInto(const int* in, const int64_t n, int* out) {
+  if (n >= kMinVectorSize) {
+    internal::MaxInto(in, n, out);
+    return;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    out[i] = out[i] < in[i] ? in[i] : out[i];
+  }
+}
+
+// Returns the maximum of in[0] to in[n - 1], n > 0.
+inline int Max(const int* in, const int64_t n) {
+  if (n >= kMinVectorSize) {
+    return internal::Max(in, n);
+  }
+  int max = in[0];
+  for (int64_t i = 1; i < n; ++i) {
+    max = max < in[i] ? in[i] : max;
+  }
+  return max;
+}
+
+// Clears the mask at the positions, where the payoff differs from the best
+// payoff, masks are -1 if set and 0 if cleared.
+inline void ClearUnequal(const int* payoffs, const int* best, const int64_t n,
+                         int32_t* mask) {
+  if (n >= kMinVectorSize) {
+    internal::ClearUnequal(payoffs, best, n, mask);
+    return;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    mask[i] &= -static_cast<int32_t>(payoffs[i] == best[i]);
+  }
+}
+
+// Same as above with the same best payoff for all positions.
+inline void ClearUnequal(const int* payoffs, const int best, const int64_t n,
+                         int32_t* mask) {
+  if (n >= kMinVectorSize) {
+    internal::ClearUnequal(payoffs, best, n, mask);
+    return;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    mask[i] &= -static_cast<int32_t>(payoffs[i] == best);
+  }
+}
+
+// Returns the position of the first set mask, n if none is set.
+inline int64_t NextSet(const int32_t* mask, const int64_t n) {
+  if (n >= kMinVectorSize) {
+    return internal::NextSet(mask, n);
+  }
+  int64_t i = 0;
+  while (i < n && !mask[i]) {
+    ++i;
+  }
+  return i;
+}
+
+}  // namespace simd
+}  // namespace ash
+#endif  // SRC_SIMD_KERNELS_H_
@@ -0,0 +1,162 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./support-enumerator.h"
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using std::vector;
+using std::pair;
+using std::make_pair;
+using std::min;
+using std::max;
+
+namespace ash {
+
+// Returns the enumeration order key of given support size profile.
+static pair<int, int> OrderKey(const vector<int>& sizes) {
+  int total = 0;
+  int smallest = sizes[0];
+  int largest = sizes[0];
+  for (auto it = sizes.begin(); it != sizes.end(); ++it) {
+    total += *it;
+    smallest = min(smallest, *it);
+    largest = max(largest, *it);
+  }
+  const int balance = largest - smallest;
+  return sizes.size() == 2 ? make_pair(balance, total) :
+                             make_pair(total, balance);
+}
+
+// Returns the first support of given size, the lowest strategies.
+static uint32_t FirstSupport(const int size) {
+  return (uint64_t(1) << size) - 1u;
+}
+
+SupportEnumerator::SupportEnumerator(const Game& game, const int min_size,
+                                     const int max_size)
+    : game_(game),
+      size_profile_(-1),
+      supports_(game.num_players(), 0u) {
+  assert(min_size > 0 && min_size <= max_size);
+  const int num_players = game.num_players();
+  vector<int> sizes(num_players, min_size);
+  for (int p = 0; p < num_players; ++p) {
+    assert(game.num_strategies(p) <= 32);
+    if (min_size > game.num_strategies(p)) {
+      return;
+    }
+  }
+  // Odometer over the support sizes of all players.
+  int p = 0;
+  while (p < num_players) {
+    size_profiles_.push_back(sizes);
+    for (p = 0; p < num_players; ++p) {
+      if (sizes[p] < min(max_size, game.num_strategies(p))) {
+        ++sizes[p];
+        break;
+      }
+      sizes[p] = min_size;
+    }
+  }
+  std::stable_sort(size_profiles_.begin(), size_profiles_.end(),
+                   [](const vector<int>& a, const vector<int>& b) {
+                     return OrderKey(a) < OrderKey(b);
+                   });
+}
+
+bool SupportEnumerator::Next() {
+  const int num_players = game_.num_players();
+  if (size_profile_ >= 0) {
+    for (int p = 0; p < num_players; ++p) {
+      if (NextSupport(p)) {
+        return true;
+      }
+      supports_[p] = FirstSupport(size_profiles_[size_profile_][p]);
+    }
+  }
+  if (size_profile_ + 1 >= num_size_profiles()) {
+    size_profile_ = num_size_profiles();
+    return false;
+  }
+  ++size_profile_;
+  ResetSupports();
+  return true;
+}
+
+bool SupportEnumerator::ConditionallyDominated() const {
+  const int num_players = game_.num_players();
+  vector<int64_t> ids;
+  for (int p = 0; p < num_players; ++p) {
+    // The profile ids of the support profiles of the other players, with
+    // strategy 0 for p.
+    ids.assign(1, 0);
+    for (int q = 0; q < num_players; ++q) {
+      if (q == p) {
+        continue;
+      }
+      const size_t num_ids = ids.size();
+      for (int s = 1; s < game_.num_strategies(q); ++s) {
+        if (supports_[q] & (1u << s)) {
+          for (size_t i = 0; i < num_ids; ++i) {
+            ids.push_back(ids[i] + s * game_.stride(q));
+          }
+        }
+      }
+      if (!(supports_[q] & 1u)) {
+        ids.erase(ids.begin(), ids.begin() + num_ids);
+      }
+    }
+    const int64_t stride = game_.stride(p);
+    const int num_strategies = game_.num_strategies(p);
+    for (int s = 0; s < num_strategies; ++s) {
+      if (!(supports_[p] & (1u << s))) {
+        continue;
+      }
+      for (int d = 0; d < num_strategies; ++d) {
+        bool dominated = d != s;
+        for (auto it = ids.begin(); dominated && it != ids.end(); ++it) {
+          dominated = game_.payoff(*it + d * stride, p) >
+                      game_.payoff(*it + s * stride, p);
+        }
+        if (dominated) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void SupportEnumerator::ResetSupports() {
+  for (int p = 0; p < game_.num_players(); ++p) {
+    supports_[p] = FirstSupport(size_profiles_[size_profile_][p]);
+  }
+}
+
+bool SupportEnumerator::NextSupport(const int player_id) {
+  // Next bit mask with the same number of bits (Gosper's hack).
+  const uint64_t mask = supports_[player_id];
+  const uint64_t lowest = mask & -mask;
+  const uint64_t ripple = mask + lowest;
+  const uint64_t next = (((ripple ^ mask) >> 2) / lowest) | ripple;
+  if (next >> game_.num_strategies(player_id)) {
+    return false;
+  }
+  supports_[player_id] = next;
+  return true;
+}
+
+const vector<uint32_t>& SupportEnumerator::supports() const {
+  return supports_;
+}
+
+int SupportEnumerator::size_profile() const {
+  return size_profile_;
+}
+
+int SupportEnumerator::num_size_profiles() const {
+  return size_profiles_.size();
+}
+
+}  // namespace ash
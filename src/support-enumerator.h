@@ -0,0 +1,48 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_SUPPORT_ENUMERATOR_H_
+#define SRC_SUPPORT_ENUMERATOR_H_
+
+#include <cstdint>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Enumerates the support profiles of a game in the order of Porter, Nudelman
+// and Shoham. The support size profiles are ordered by increasing balance and
+// total size for two players and by increasing total size and balance for
+// more players, where the balance is the difference between the largest and
+// the smallest support size. Small and balanced supports hold an equilibrium
+// most likely, which finds the first equilibrium early. Each support is a bit
+// mask of the strategies of its player, the support sizes are bounded.
+// Usage: for (SupportEnumerator it(game, 1, 3); it.Next();) { ... }
+class SupportEnumerator {
+ public:
+  SupportEnumerator(const Game& game, const int min_size, const int max_size);
+  // Advances to the next support profile, returns false after the last one.
+  bool Next();
+  // Returns true if a strategy in the support of a player is strictly
+  // dominated by another strategy of the player, given the supports of the
+  // other players. Such supports hold no equilibrium.
+  bool ConditionallyDominated() const;
+  const std::vector<uint32_t>& supports() const;
+  // Returns the index of the current support size profile.
+  int size_profile() const;
+  int num_size_profiles() const;
+
+ private:
+  // Sets the supports to the first supports of the current size profile.
+  void ResetSupports();
+  // Advances the support of given player to the next one of the same size,
+  // returns false after the last one.
+  bool NextSupport(const int player_id);
+
+  const Game& game_;
+  // The support size profiles in enumeration order.
+  std::vector<std::vector<int> > size_profiles_;
+  int size_profile_;
+  std::vector<uint32_t> supports_;
+};
+
+}  // namespace ash
+#endif  // SRC_SUPPORT_ENUMERATOR_H_
@@ -0,0 +1,475 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./symmetric-game.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using std::vector;
+using std::numeric_limits;
+
+namespace ash {
+
+// Tolerance for the indifference and best response conditions.
+static const double kEpsilon = 1e-9;
+// Maximum number of Newton iterations per start.
+static const int kMaxNumIterations = 100;
+
+// Visits the permutations of the candidate count vectors over the players up
+// to given player in ascending profile id order, the candidates are those
+// which contain the counts already used by the players after. Returns false
+// once the visitor stops or given number of profiles is reached.
+static bool VisitPermutations(const int player,
+                              const vector<const vector<int>*>& candidates,
+                              const size_t max_num, const PureVisitor& visitor,
+                              vector<int>* used, StrategyProfile* profile,
+                              size_t* num_found) {
+  if (player < 0) {
+    ++*num_found;
+    return visitor(*profile) && *num_found < max_num;
+  }
+  const int num_strategies = used->size();
+  vector<const vector<int>*> remaining;
+  for (int s = 0; s < num_strategies; ++s) {
+    ++(*used)[s];
+    remaining.clear();
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+      if ((**it)[s] >= (*used)[s]) {
+        remaining.push_back(*it);
+      }
+    }
+    profile->strategy(player, s);
+    const bool proceed = remaining.empty() ||
+                         VisitPermutations(player - 1, remaining, max_num,
+                                           visitor, used, profile, num_found);
+    --(*used)[s];
+    if (!proceed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the number of permutations of given counts, which is their
+// multinomial coefficient, or given limit if it is larger. Requires the limit
+// times the number of counted players to fit into int64_t.
+static int64_t NumPermutations(const vector<int>& counts, const int64_t limit) {
+  int64_t num = 1;
+  int m = 0;
+  for (auto it = counts.begin(); it != counts.end(); ++it) {
+    m += *it;
+    // C(m, c) is built up over the smaller of c and m - c, the partial
+    // coefficients increase on the way.
+    const int k = std::min(*it, m - *it);
+    int64_t binomial = 1;
+    for (int i = 0; i < k; ++i) {
+      binomial = binomial * (m - i) / (i + 1);
+      if (binomial > limit) {
+        return limit;
+      }
+    }
+    if (binomial > limit / num) {
+      return limit;
+    }
+    num *= binomial;
+  }
+  return num;
+}
+
+// Solves the n x n system a x = b in place by Gaussian elimination with
+// partial pivoting. Returns false if the system is singular.
+static bool SolveLinear(vector<vector<double> >* a, vector<double>* b) {
+  const int n = b->size();
+  for (int c = 0; c < n; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < n; ++r) {
+      if (std::fabs((*a)[r][c]) > std::fabs((*a)[pivot][c])) {
+        pivot = r;
+      }
+    }
+    if (std::fabs((*a)[pivot][c]) < kEpsilon) {
+      return false;
+    }
+    std::swap((*a)[c], (*a)[pivot]);
+    std::swap((*b)[c], (*b)[pivot]);
+    for (int r = c + 1; r < n; ++r) {
+      const double factor = (*a)[r][c] / (*a)[c][c];
+      for (int j = c; j < n; ++j) {
+        (*a)[r][j] -= factor * (*a)[c][j];
+      }
+      (*b)[r] -= factor * (*b)[c];
+    }
+  }
+  for (int r = n - 1; r >= 0; --r) {
+    for (int j = r + 1; j < n; ++j) {
+      (*b)[r] -= (*a)[r][j] * (*b)[j];
+    }
+    (*b)[r] /= (*a)[r][r];
+  }
+  return true;
+}
+
+bool SymmetricGame::Create(const Game& game, SymmetricGame* symmetric) {
+  assert(symmetric);
+  const int num_players = game.num_players();
+  if (num_players < 2) {
+    return false;
+  }
+  const int num_strategies = game.num_strategies(0);
+  for (int p = 1; p < num_players; ++p) {
+    if (game.num_strategies(p) != num_strategies) {
+      return false;
+    }
+  }
+  SymmetricGame sym(num_players, num_strategies);
+  vector<bool> set(sym.payoffs_.size(), false);
+  vector<int> counts(num_strategies, 0);
+  for (ProfileIterator it(game); !it.done(); it.Next()) {
+    const StrategyProfile& profile = it.profile();
+    counts.assign(num_strategies, 0);
+    for (int p = 0; p < num_players; ++p) {
+      ++counts[profile[p]];
+    }
+    for (int p = 0; p < num_players; ++p) {
+      const int s = profile[p];
+      --counts[s];
+      const size_t index = s * sym.num_counts_ + sym.CountId(counts);
+      ++counts[s];
+      const int payoff = game.payoff(it.id(), p);
+      if (!set[index]) {
+        sym.payoffs_[index] = payoff;
+        set[index] = true;
+      } else if (sym.payoffs_[index] != payoff) {
+        return false;
+      }
+    }
+  }
+  *symmetric = sym;
+  return true;
+}
+
+bool SymmetricGame::NextCounts(vector<int>* counts) {
+  assert(counts && counts->size());
+  const int last = counts->size() - 1;
+  int i = last;
+  while (i > 0 && (*counts)[i] == 0) {
+    --i;
+  }
+  if (i == 0) {
+    return false;
+  }
+  // Increment the count before the last non-zero count and move the rest of
+  // the tail to the last count.
+  const int tail = (*counts)[i] - 1;
+  (*counts)[i] = 0;
+  ++(*counts)[i - 1];
+  (*counts)[last] = tail;
+  return true;
+}
+
+SymmetricGame::SymmetricGame(const int num_players, const int num_strategies)
+    : num_players_(num_players),
+      num_strategies_(num_strategies),
+      num_counts_(0) {
+  assert(num_players >= 0 && num_strategies >= 0);
+  if (num_players == 0 || num_strategies == 0) {
+    return;
+  }
+  const int size = num_players + num_strategies;
+  binomials_.assign(size, vector<int64_t>(num_strategies + 1, 0));
+  for (int n = 0; n < size; ++n) {
+    binomials_[n][0] = 1;
+    for (int k = 1; k <= num_strategies && k <= n; ++k) {
+      binomials_[n][k] = binomials_[n - 1][k - 1] +
+                         (k < n ? binomials_[n - 1][k] : 0);
+      assert(binomials_[n][k] > 0);
+    }
+  }
+  const int64_t num_counts =
+      binomials_[num_players + num_strategies - 2][num_strategies - 1];
+  assert(num_counts * num_strategies <= numeric_limits<int>::max());
+  num_counts_ = num_counts;
+  payoffs_.assign(num_counts_ * num_strategies, 0);
+  log_coefficients_.reserve(num_counts_);
+  vector<int> counts(num_strategies, 0);
+  counts.back() = num_players - 1;
+  do {
+    double log_coefficient = std::lgamma(num_players);
+    for (int s = 0; s < num_strategies; ++s) {
+      log_coefficient -= std::lgamma(counts[s] + 1);
+    }
+    log_coefficients_.push_back(log_coefficient);
+  } while (NextCounts(&counts));
+  assert(static_cast<int>(log_coefficients_.size()) == num_counts_);
+}
+
+void SymmetricGame::SetPayoff(const int strategy, const vector<int>& counts,
+                              const int payoff) {
+  assert(strategy >= 0 && strategy < num_strategies_);
+  payoffs_[strategy * num_counts_ + CountId(counts)] = payoff;
+}
+
+int SymmetricGame::FindPureCounts(vector<vector<int> >* equilibria) const {
+  assert(equilibria);
+  if (!num_counts_) {
+    return 0;
+  }
+  const size_t num_before = equilibria->size();
+  vector<int> counts(num_strategies_, 0);
+  counts.back() = num_players_;
+  do {
+    bool equilibrium = true;
+    for (int s = 0; s < num_strategies_ && equilibrium; ++s) {
+      if (!counts[s]) {
+        continue;
+      }
+      // The players of strategy s face the other players' counts.
+      vector<int> others = counts;
+      --others[s];
+      const int id = CountId(others);
+      const int payoff = payoffs_[s * num_counts_ + id];
+      for (int t = 0; t < num_strategies_ && equilibrium; ++t) {
+        equilibrium = payoffs_[t * num_counts_ + id] <= payoff;
+      }
+    }
+    if (equilibrium) {
+      equilibria->push_back(counts);
+    }
+  } while (NextCounts(&counts));
+  return equilibria->size() - num_before;
+}
+
+int SymmetricGame::FindPure(const size_t max_num,
+                            vector<StrategyProfile>* equilibria) const {
+  assert(equilibria);
+  return FindPure(max_num, [equilibria](const StrategyProfile& profile) {
+    equilibria->push_back(profile);
+    return true;
+  });
+}
+
+int64_t SymmetricGame::FindPure(const size_t max_num,
+                                const PureVisitor& visitor) const {
+  vector<vector<int> > count_equilibria;
+  FindPureCounts(&count_equilibria);
+  if (!visitor) {
+    const int64_t limit = std::min<uint64_t>(
+        max_num, numeric_limits<int64_t>::max() / (num_players_ + 1));
+    int64_t num_found = 0;
+    for (auto it = count_equilibria.begin();
+         it != count_equilibria.end() && num_found < limit; ++it) {
+      num_found += NumPermutations(*it, limit - num_found);
+    }
+    return num_found;
+  }
+  vector<const vector<int>*> candidates;
+  for (auto it = count_equilibria.begin(); it != count_equilibria.end();
+       ++it) {
+    candidates.push_back(&*it);
+  }
+  size_t num_found = 0;
+  if (max_num && !candidates.empty()) {
+    vector<int> used(num_strategies_, 0);
+    StrategyProfile profile(num_players_, 0);
+    VisitPermutations(num_players_ - 1, candidates, max_num, visitor, &used,
+                      &profile, &num_found);
+  }
+  return num_found;
+}
+
+int SymmetricGame::FindMixed(const size_t max_num,
+                             vector<MixedStrategyProfile>* equilibria) const {
+  assert(equilibria);
+  const size_t num_before = equilibria->size();
+  vector<double> expected;
+  for (uint32_t mask = 1u; mask < (1u << num_strategies_) &&
+       equilibria->size() - num_before < max_num; ++mask) {
+    vector<int> support;
+    for (int s = 0; s < num_strategies_; ++s) {
+      if (mask & (1u << s)) {
+        support.push_back(s);
+      }
+    }
+    const int size = support.size();
+    // Start at the barycenter of the support and halfway to each vertex.
+    vector<vector<double> > solutions;
+    for (int start = -1; start < (size > 1 ? size : 0); ++start) {
+      vector<double> probs(num_strategies_, 0.0);
+      for (int i = 0; i < size; ++i) {
+        probs[support[i]] = start == -1 ? 1.0 / size :
+                            (i == start ? 0.5 : 0.0) + 0.5 / size;
+      }
+      if (!Solve(support, &probs)) {
+        continue;
+      }
+      ExpectedPayoffs(probs, &expected);
+      const double value = expected[support[0]];
+      bool equilibrium = true;
+      for (int s = 0; s < num_strategies_ && equilibrium; ++s) {
+        equilibrium = expected[s] <= value + 1e-6 &&
+                      (!probs[s] || probs[s] > 1e-6);
+      }
+      for (auto it = solutions.begin(); it != solutions.end() && equilibrium;
+           ++it) {
+        double distance = 0.0;
+        for (int s = 0; s < num_strategies_; ++s) {
+          distance = std::max(distance, std::fabs((*it)[s] - probs[s]));
+        }
+        equilibrium = distance > 1e-6;
+      }
+      if (!equilibrium) {
+        continue;
+      }
+      solutions.push_back(probs);
+      MixedStrategyProfile profile(num_players_);
+      for (int p = 0; p < num_players_; ++p) {
+        profile.SetNumStrategies(p, num_strategies_);
+        for (int s = 0; s < num_strategies_; ++s) {
+          profile.AddProbability(p, s, probs[s]);
+        }
+      }
+      equilibria->push_back(profile);
+      if (equilibria->size() - num_before >= max_num) {
+        break;
+      }
+    }
+  }
+  return equilibria->size() - num_before;
+}
+
+bool SymmetricGame::Solve(const vector<int>& support,
+                          vector<double>* probs) const {
+  const int size = support.size();
+  vector<double> residual(size);
+  vector<double> shifted_residual(size);
+  for (int iteration = 0; iteration < kMaxNumIterations; ++iteration) {
+    Residual(support, *probs, &residual);
+    double norm = 0.0;
+    for (int i = 0; i < size; ++i) {
+      norm = std::max(norm, std::fabs(residual[i]));
+    }
+    if (norm < kEpsilon) {
+      return true;
+    }
+    // Forward difference Jacobian.
+    const double h = 1e-7;
+    vector<vector<double> > jacobian(size, vector<double>(size));
+    for (int j = 0; j < size; ++j) {
+      vector<double> shifted = *probs;
+      shifted[support[j]] += h;
+      Residual(support, shifted, &shifted_residual);
+      for (int i = 0; i < size; ++i) {
+        jacobian[i][j] = (shifted_residual[i] - residual[i]) / h;
+      }
+    }
+    vector<double> step = residual;
+    if (!SolveLinear(&jacobian, &step)) {
+      return false;
+    }
+    // Damp the step to stay within the nonnegative orthant.
+    double lambda = 1.0;
+    for (int i = 0; i < size; ++i) {
+      const double x = (*probs)[support[i]];
+      if (x - lambda * step[i] < 0.0) {
+        lambda = 0.9 * x / step[i];
+      }
+    }
+    if (lambda < kEpsilon) {
+      return false;
+    }
+    for (int i = 0; i < size; ++i) {
+      (*probs)[support[i]] -= lambda * step[i];
+    }
+  }
+  return false;
+}
+
+void SymmetricGame::Residual(const vector<int>& support,
+                             const vector<double>& probs,
+                             vector<double>* residual) const {
+  const int size = support.size();
+  vector<double> expected;
+  ExpectedPayoffs(probs, &expected);
+  double sum = 0.0;
+  for (int i = 0; i < size; ++i) {
+    sum += probs[support[i]];
+    if (i) {
+      (*residual)[i] = expected[support[i]] - expected[support[0]];
+    }
+  }
+  (*residual)[0] = sum - 1.0;
+}
+
+int SymmetricGame::payoff(const int strategy, const vector<int>& counts) const {
+  assert(strategy >= 0 && strategy < num_strategies_);
+  return payoffs_[strategy * num_counts_ + CountId(counts)];
+}
+
+void SymmetricGame::ExpectedPayoffs(const vector<double>& probs,
+                                    vector<double>* payoffs) const {
+  assert(static_cast<int>(probs.size()) == num_strategies_);
+  assert(payoffs);
+  payoffs->assign(num_strategies_, 0.0);
+  if (!num_counts_) {
+    return;
+  }
+  vector<double> log_probs(num_strategies_);
+  for (int s = 0; s < num_strategies_; ++s) {
+    log_probs[s] = probs[s] > 0.0 ? std::log(probs[s]) :
+                   -numeric_limits<double>::infinity();
+  }
+  vector<int> counts(num_strategies_, 0);
+  counts.back() = num_players_ - 1;
+  int id = 0;
+  do {
+    // Probability of the count vector under the multinomial distribution.
+    double log_weight = log_coefficients_[id];
+    for (int s = 0; s < num_strategies_; ++s) {
+      if (counts[s]) {
+        log_weight += counts[s] * log_probs[s];
+      }
+    }
+    const double weight = std::exp(log_weight);
+    if (weight > 0.0) {
+      for (int s = 0; s < num_strategies_; ++s) {
+        (*payoffs)[s] += weight * payoffs_[s * num_counts_ + id];
+      }
+    }
+    ++id;
+  } while (NextCounts(&counts));
+}
+
+int SymmetricGame::CountId(const vector<int>& counts) const {
+  assert(static_cast<int>(counts.size()) == num_strategies_);
+  // Counts the vectors with a smaller count at the first differing position.
+  // Those with count v < c_i at position i and the remaining r - v spread
+  // over the k + 1 following positions number C(r - v + k, k), which sum up
+  // to C(r + k + 1, k + 1) - C(r - c_i + k + 1, k + 1).
+  int id = 0;
+  int remaining = num_players_ - 1;
+  for (int i = 0; i + 1 < num_strategies_; ++i) {
+    const int k = num_strategies_ - 2 - i;
+    const int c = counts[i];
+    assert(c >= 0 && c <= remaining);
+    id += binomials_[remaining + k + 1][k + 1] -
+          binomials_[remaining - c + k + 1][k + 1];
+    remaining -= c;
+  }
+  assert(counts.back() == remaining);
+  return id;
+}
+
+int SymmetricGame::num_players() const {
+  return num_players_;
+}
+
+int SymmetricGame::num_strategies() const {
+  return num_strategies_;
+}
+
+int SymmetricGame::num_counts() const {
+  return num_counts_;
+}
+
+}  // namespace ash
@@ -0,0 +1,81 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_SYMMETRIC_GAME_H_
+#define SRC_SYMMETRIC_GAME_H_
+
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Symmetric game, in which the payoff of a player depends only on its own
+// strategy and on how many of the other players choose each strategy. The
+// payoffs are stored per own strategy and count vector of the other players,
+// which are C(n + s - 2, s - 1) per strategy for n players and s strategies
+// instead of s^n, and the solvers run over count vectors.
+class SymmetricGame {
+ public:
+  // Returns true and sets the symmetric game if given game is symmetric.
+  static bool Create(const Game& game, SymmetricGame* symmetric);
+  // Advances the count vector to the next one in ascending lexicographic
+  // order, which is the order of the count ids. Returns false after the last.
+  static bool NextCounts(std::vector<int>* counts);
+
+  SymmetricGame(const int num_players, const int num_strategies);
+  // Sets the payoff of given strategy against given counts of the other
+  // players.
+  void SetPayoff(const int strategy, const std::vector<int>& counts,
+                 const int payoff);
+  // Appends the count vectors over all players of the pure equilibria.
+  int FindPureCounts(std::vector<std::vector<int> >* equilibria) const;
+  // Appends the pure equilibria, which are the permutations of the
+  // equilibrium count vectors, in ascending profile id order until given
+  // number of equilibria is reached.
+  int FindPure(const size_t max_num,
+               std::vector<StrategyProfile>* equilibria) const;
+  // Same as above, but streams the equilibria to given visitor instead, until
+  // the visitor stops. Without visitor the permutations are only counted by
+  // the multinomial coefficients of the count vectors, no profiles are
+  // created. Returns the number of equilibria found.
+  int64_t FindPure(const size_t max_num, const PureVisitor& visitor) const;
+  // Appends the symmetric mixed equilibria, in which all players play the
+  // same mixed strategy, until given number of equilibria is reached. For
+  // each support it solves the indifference of the supported strategies with
+  // Newton's method from several starting points.
+  int FindMixed(const size_t max_num,
+                std::vector<MixedStrategyProfile>* equilibria) const;
+
+  int payoff(const int strategy, const std::vector<int>& counts) const;
+  // Sets the expected payoffs of all strategies against the other players,
+  // who all play given mixed strategy.
+  void ExpectedPayoffs(const std::vector<double>& probs,
+                       std::vector<double>* payoffs) const;
+  // Returns the id of given count vector of the other players.
+  int CountId(const std::vector<int>& counts) const;
+  int num_players() const;
+  int num_strategies() const;
+  // Returns the number of count vectors of the other players.
+  int num_counts() const;
+
+ private:
+  // Returns true if Newton's method converges to a completely mixed
+  // equilibrium over the given support from given start.
+  bool Solve(const std::vector<int>& support, std::vector<double>* probs) const;
+  // Sets the residual of the indifference between the supported strategies
+  // and of the probability sum.
+  void Residual(const std::vector<int>& support,
+                const std::vector<double>& probs,
+                std::vector<double>* residual) const;
+
+  int num_players_;
+  int num_strategies_;
+  int num_counts_;
+  // Binomial coefficients C(n, k) for n < num_players + num_strategies.
+  std::vector<std::vector<int64_t> > binomials_;
+  // Logarithm of the multinomial coefficient of each count vector.
+  std::vector<double> log_coefficients_;
+  // Payoffs indexed by strategy * num_counts + count id.
+  std::vector<int> payoffs_;
+};
+
+}  // namespace ash
+#endif  // SRC_SYMMETRIC_GAME_H_
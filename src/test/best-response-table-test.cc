@@ -0,0 +1,213 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "../best-response-table.h"
+#include "../game.h"
+#include "../simd-kernels.h"
+
+using ash::BestResponseTable;
+using ash::Game;
+using ash::Outcome;
+using ash::Player;
+using ash::ProfileIterator;
+using ash::StrategyProfile;
+
+using std::vector;
+
+namespace simd = ash::simd;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given numbers of strategies and random payoffs from
+// given range.
+Game CreateRandomGame(const vector<int>& num_strategies, const int range) {
+  Game game("random");
+  for (size_t p = 0; p < num_strategies.size(); ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(num_strategies.size(),
+                               vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+TEST(BestResponseTableTest, BestPayoffs) {
+  std::srand(5);
+  const Game game = CreateRandomGame({3, 2, 4}, 100);
+  const BestResponseTable table(game, 1);
+  for (ProfileIterator it(game); !it.done(); it.Next()) {
+    for (int p = 0; p < game.num_players(); ++p) {
+      int best = game.payoff(it.deviation(p, 0), p);
+      for (int s = 1; s < game.num_strategies(p); ++s) {
+        best = std::max(best, game.payoff(it.deviation(p, s), p));
+      }
+      EXPECT_EQ(best,
+                table.best_payoff(table.SubProfileId(it.profile(), p), p));
+    }
+  }
+  StrategyProfile profile({2, 1, 3});
+  EXPECT_EQ(2 + 3 * 3, table.SubProfileId(profile, 1));
+  EXPECT_EQ(1 + 2 * 3, table.SubProfileId(profile, 0));
+  EXPECT_EQ(2 + 3 * 1, table.SubProfileId(profile, 2));
+}
+
+TEST(BestResponseTableTest, FindPure) {
+  std::srand(9);
+  for (int i = 0; i < 20; ++i) {
+    const Game game = CreateRandomGame({2 + i % 3, 3, 1, 2 + i % 2}, 3);
+    vector<StrategyProfile> expected;
+    for (ProfileIterator it(game); !it.done(); it.Next()) {
+      bool equilibrium = true;
+      for (int p = 0; p < game.num_players(); ++p) {
+        for (int s = 0; s < game.num_strategies(p); ++s) {
+          equilibrium &= game.payoff(it.deviation(p, s), p) <=
+                         game.payoff(it.id(), p);
+        }
+      }
+      if (equilibrium) {
+        expected.push_back(it.profile());
+      }
+    }
+    const BestResponseTable table(game, 1);
+    vector<StrategyProfile> equilibria;
+    ASSERT_EQ(expected.size(), table.FindPure(100, 1, &equilibria));
+    for (size_t e = 0; e < expected.size(); ++e) {
+      EXPECT_EQ(expected[e].str(), equilibria[e].str());
+    }
+    equilibria.clear();
+    EXPECT_EQ(std::min<size_t>(1, expected.size()),
+              table.FindPure(1, 1, &equilibria));
+  }
+}
+
+TEST(BestResponseTableTest, ParallelMatchesSerial) {
+  std::srand(13);
+  // Enough profiles for several chunks and many equilibria.
+  const Game game = CreateRandomGame({10, 10, 10, 10, 10}, 2);
+  const BestResponseTable serial_table(game, 1);
+  const BestResponseTable table(game, 4);
+  vector<StrategyProfile> serial;
+  serial_table.FindPure(100000, 1, &serial);
+  ASSERT_LT(10u, serial.size());
+  for (int64_t sp = 0; sp < game.num_strategy_profiles(); sp += 997) {
+    const StrategyProfile profile = game.CreateProfile(sp);
+    for (int p = 0; p < game.num_players(); ++p) {
+      const int64_t sub = table.SubProfileId(profile, p);
+      EXPECT_EQ(serial_table.best_payoff(sub, p), table.best_payoff(sub, p));
+    }
+  }
+  // Repeated runs give later chunks the chance to finish before earlier
+  // ones, which must not change the equilibria found.
+  const size_t max_nums[] = {100000, serial.size() / 2, 1, 2, 3, 5, 8, 13};
+  for (int i = 0; i < 8 * 10; ++i) {
+    vector<StrategyProfile> equilibria;
+    ASSERT_EQ(std::min(max_nums[i % 8], serial.size()),
+              table.FindPure(max_nums[i % 8], 4, &equilibria));
+    for (size_t e = 0; e < equilibria.size(); ++e) {
+      EXPECT_EQ(serial[e].str(), equilibria[e].str());
+    }
+  }
+}
+
+TEST(BestResponseTableTest, SimdMatchesScalar) {
+  std::srand(17);
+  const simd::Level supported = simd::SupportedLevel();
+  const vector<int> dims[] = {{37, 41}, {2, 3, 9, 5}, {3, 3, 3, 3, 3, 3}};
+  for (int d = 0; d < 3; ++d) {
+    const Game game = CreateRandomGame(dims[d], 3);
+    vector<vector<StrategyProfile> > results;
+    for (int l = simd::kScalar; l <= supported; ++l) {
+      simd::SetLevel(static_cast<simd::Level>(l));
+      const BestResponseTable table(game, 1);
+      vector<StrategyProfile> equilibria;
+      table.FindPure(100000, 1, &equilibria);
+      results.push_back(equilibria);
+    }
+    for (size_t l = 1; l < results.size(); ++l) {
+      ASSERT_EQ(results[0].size(), results[l].size());
+      for (size_t e = 0; e < results[0].size(); ++e) {
+        EXPECT_EQ(results[0][e].str(), results[l][e].str());
+      }
+    }
+  }
+  simd::SetLevel(supported);
+}
+
+TEST(BestResponseTableTest, Visitor) {
+  std::srand(21);
+  const Game game = CreateRandomGame({10, 10, 10, 10, 10}, 2);
+  const BestResponseTable table(game, 1);
+  vector<StrategyProfile> expected;
+  table.FindPure(100000, 1, &expected);
+  ASSERT_LT(10u, expected.size());
+  for (int num_threads = 1; num_threads <= 4; num_threads += 3) {
+    EXPECT_EQ(expected.size(), table.FindPure(100000, num_threads,
+                                              ash::PureVisitor()));
+    EXPECT_EQ(5, table.FindPure(5, num_threads, ash::PureVisitor()));
+    // The visitor stops after the tenth equilibrium.
+    vector<StrategyProfile> visited;
+    EXPECT_EQ(10, table.FindPure(100000, num_threads,
+                                 [&visited](const StrategyProfile& profile) {
+                                   visited.push_back(profile);
+                                   return visited.size() < 10;
+                                 }));
+    ASSERT_EQ(10u, visited.size());
+    for (size_t e = 0; e < visited.size(); ++e) {
+      EXPECT_EQ(expected[e].str(), visited[e].str());
+    }
+  }
+}
+
+TEST(BestResponseTableTest, ScanMatchesTable) {
+  std::srand(23);
+  Game game("outcomes");
+  const int num_strategies[] = {4, 3, 5};
+  for (int p = 0; p < 3; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  for (int o = 0; o < 6; ++o) {
+    game.AddOutcome(Outcome("o", {std::rand() % 3, std::rand() % 3,
+                                  std::rand() % 3}));
+  }
+  for (int64_t sp = 0; sp < game.num_strategy_profiles(); ++sp) {
+    game.SetPayoff(sp, std::rand() % 6);
+  }
+  vector<StrategyProfile> expected;
+  BestResponseTable(game, 1).FindPure(100000, 1, &expected);
+  ASSERT_LT(0u, expected.size());
+  Game packed = game;
+  packed.PackPayoffs();
+  Game mapped = game;
+  ASSERT_TRUE(mapped.FlattenPayoffs("/tmp/ash-best-response-table-test"));
+  ASSERT_TRUE(mapped.mapped());
+  const Game* games[] = {&packed, &mapped};
+  for (int g = 0; g < 2; ++g) {
+    const BestResponseTable table(*games[g], 2);
+    for (int num_threads = 1; num_threads <= 2; ++num_threads) {
+      vector<StrategyProfile> equilibria;
+      ASSERT_EQ(expected.size(), table.FindPure(100000, num_threads,
+                                                &equilibria));
+      for (size_t e = 0; e < equilibria.size(); ++e) {
+        EXPECT_EQ(expected[e].str(), equilibria[e].str());
+      }
+    }
+    EXPECT_EQ(1, table.FindPure(1, 1, ash::PureVisitor()));
+  }
+}
@@ -0,0 +1,142 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdlib>
+#include <vector>
+#include "../bimatrix-game.h"
+#include "../equilibria-finder.h"
+#include "../game.h"
+
+using ash::BimatrixGame;
+using ash::BimatrixSolver;
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::StrategyProfile;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a two-player game with given per-player payoffs in profile id
+// order.
+Game CreateGame(const int n, const int m, vector<vector<int> > payoffs) {
+  Game game("bimatrix");
+  const int dims[] = {n, m};
+  for (int p = 0; p < 2; ++p) {
+    Player player("p");
+    for (int s = 0; s < dims[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+TEST(BimatrixGameTest, Chicken) {
+  const Game game = CreateGame(2, 2, {{3, 4, 2, 1}, {3, 2, 4, 1}});
+  BimatrixGame<2, 2> bimatrix(game);
+  vector<StrategyProfile> pure;
+  EXPECT_EQ(2, bimatrix.FindPure(10, &pure));
+  EXPECT_EQ("(1 0)", pure[0].str());
+  EXPECT_EQ("(0 1)", pure[1].str());
+  EXPECT_EQ(1, bimatrix.FindPure(1, ash::PureVisitor()));
+  EXPECT_EQ(1, bimatrix.FindPure(10, [](const StrategyProfile& profile) {
+    return false;
+  }));
+  vector<MixedStrategyProfile> mixed;
+  EXPECT_EQ(3, bimatrix.FindMixed(10, &mixed));
+  EXPECT_FLOAT_EQ(0.5f, mixed[2].probability(0, 0));
+  EXPECT_FLOAT_EQ(0.5f, mixed[2].probability(1, 1));
+  mixed.clear();
+  EXPECT_EQ(1, bimatrix.FindMixed(1, &mixed));
+}
+
+TEST(BimatrixGameTest, RockPaperScissors) {
+  const Game game = CreateGame(3, 3, {{0, -1, 1, 1, 0, -1, -1, 1, 0},
+                                      {0, 1, -1, -1, 0, 1, 1, -1, 0}});
+  ASSERT_TRUE(BimatrixSolver::Supports(game));
+  EXPECT_EQ(0, BimatrixSolver::FindPure(game, 10, ash::PureVisitor()));
+  vector<MixedStrategyProfile> mixed;
+  ASSERT_EQ(1, BimatrixSolver::FindMixed(game, 10, &mixed));
+  for (int p = 0; p < 2; ++p) {
+    for (int s = 0; s < 3; ++s) {
+      EXPECT_NEAR(1.0 / 3, mixed[0].probability(p, s), 1e-6);
+    }
+  }
+}
+
+TEST(BimatrixGameTest, PureMatchesGenericFinder) {
+  srand(42);
+  for (int i = 0; i < 100; ++i) {
+    const int n = 2 + rand() % 7;
+    const int m = 2 + rand() % 7;
+    vector<vector<int> > payoffs(2, vector<int>(n * m));
+    for (int p = 0; p < 2; ++p) {
+      for (int sp = 0; sp < n * m; ++sp) {
+        payoffs[p][sp] = rand() % 4;
+      }
+    }
+    const Game game = CreateGame(n, m, payoffs);
+    EquilibriaFinder generic_finder(game);
+    generic_finder.specialized(false);
+    generic_finder.FindPure();
+    EquilibriaFinder finder(game);
+    finder.FindPure();
+    ASSERT_EQ(generic_finder.equilibria().size(), finder.equilibria().size());
+    for (size_t e = 0; e < finder.equilibria().size(); ++e) {
+      EXPECT_EQ(generic_finder.equilibria()[e].str(),
+                finder.equilibria()[e].str());
+    }
+  }
+}
+
+TEST(BimatrixGameTest, DegenerateMatchesGenericFinder) {
+  // The second player is indifferent against the first row, the equilibrium
+  // with the first row and mixed columns has unequal supports.
+  const Game game = CreateGame(3, 2, {{2, 0, 1, 0, 0, 3},
+                                      {2, 2, 2, 2, 3, 0}});
+  EXPECT_FALSE(BimatrixSolver::Nondegenerate(game));
+  EquilibriaFinder generic_finder(game);
+  generic_finder.specialized(false);
+  const int num_eq = generic_finder.FindMixed();
+  vector<MixedStrategyProfile> mixed;
+  EXPECT_GT(num_eq, BimatrixSolver::FindMixed(game, 100, &mixed));
+  EquilibriaFinder finder(game);
+  ASSERT_EQ(num_eq, finder.FindMixed());
+  for (int e = 0; e < num_eq; ++e) {
+    EXPECT_EQ(generic_finder.mixed_equilibria()[e].str(game),
+              finder.mixed_equilibria()[e].str(game));
+  }
+}
+
+TEST(BimatrixGameTest, Degenerate2x2) {
+  // The first player is indifferent against every strategy.
+  const Game game = CreateGame(2, 2, {{0, 0, 0, 0}, {1, 0, 0, 3}});
+  EXPECT_FALSE(BimatrixSolver::Nondegenerate(game));
+  BimatrixGame<2, 2> bimatrix(game);
+  vector<MixedStrategyProfile> mixed;
+  ASSERT_EQ(3, bimatrix.FindMixed(10, &mixed));
+  EXPECT_FLOAT_EQ(0.75f, mixed[2].probability(0, 0));
+  EXPECT_FLOAT_EQ(0.5f, mixed[2].probability(1, 0));
+}
+
+TEST(BimatrixGameTest, Nondegenerate) {
+  srand(9);
+  for (int i = 0; i < 20; ++i) {
+    const int n = 2 + rand() % 7;
+    const int m = 2 + rand() % 7;
+    vector<vector<int> > payoffs(2, vector<int>(n * m));
+    for (int p = 0; p < 2; ++p) {
+      for (int sp = 0; sp < n * m; ++sp) {
+        payoffs[p][sp] = rand() % 100000;
+      }
+    }
+    EXPECT_TRUE(BimatrixSolver::Nondegenerate(CreateGame(n, m, payoffs)));
+  }
+  EXPECT_TRUE(BimatrixSolver::Nondegenerate(
+      CreateGame(2, 2, {{3, 4, 2, 1}, {3, 2, 4, 1}})));
+}
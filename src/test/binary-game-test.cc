@@ -0,0 +1,134 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <vector>
+#include "../binary-game.h"
+#include "../game.h"
+
+using ash::BinaryGame;
+using ash::Game;
+using ash::Outcome;
+using ash::Player;
+
+using std::vector;
+using std::string;
+using std::ofstream;
+
+using ::testing::ElementsAre;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+struct BinaryGameTest : public ::testing::Test {
+  BinaryGameTest()
+      : game("Battle Of The Sexes + X") {}
+
+  void SetUp() {
+    Player p1("P1");
+    Player p2("P2");
+    p1.AddStrategy(game.AddStrategy("A"));
+    p1.AddStrategy(game.AddStrategy("B"));
+    p2.AddStrategy(game.AddStrategy("A"));
+    p2.AddStrategy(game.AddStrategy("B"));
+    p2.AddStrategy(game.AddStrategy("C"));
+    game.AddPlayer(p1);
+    game.AddPlayer(p2);
+    game.AddOutcome(Outcome("null", {0, 0}));
+    game.AddOutcome(Outcome("AA", {4, 2}));
+    game.AddOutcome(Outcome("BB", {2, 4}));
+    vector<int> outcome_ids = {1, 0, 0, 2, 0, 1};
+    game.SwapPayoffs(&outcome_ids);
+    path = "/tmp/ash-binary-game-test.ash";
+  }
+
+  void TearDown() {
+    // /tmp/* is cleared automatically on reboot.
+  }
+
+  Game game;
+  string path;
+};
+
+TEST_F(BinaryGameTest, RoundTrip) {
+  ASSERT_TRUE(BinaryGame::Write(game, path));
+  EXPECT_TRUE(BinaryGame::Detect(path));
+  BinaryGame binary_game(path);
+  Game loaded = binary_game.Load();
+  ASSERT_EQ("", binary_game.error());
+  EXPECT_EQ(game.name(), loaded.name());
+  ASSERT_EQ(2, loaded.num_players());
+  EXPECT_EQ("P2", loaded.player(1).name());
+  ASSERT_EQ(3, loaded.num_strategies(1));
+  EXPECT_EQ("C", loaded.strategy(loaded.player(1).strategy(2)));
+  ASSERT_EQ(3, loaded.num_outcomes());
+  EXPECT_EQ("BB", loaded.outcome(2).name());
+  EXPECT_FALSE(loaded.dense());
+  for (int sp = 0; sp < game.num_strategy_profiles(); ++sp) {
+    EXPECT_EQ(game.payoff_index(sp), loaded.payoff_index(sp));
+  }
+  EXPECT_THAT(loaded.payoff({1, 1}), ElementsAre(2, 4));
+}
+
+TEST_F(BinaryGameTest, RoundTripDense) {
+  Game dense("dense");
+  Player p1("p1");
+  p1.AddStrategy(dense.AddStrategy("a"));
+  p1.AddStrategy(dense.AddStrategy("b"));
+  dense.AddPlayer(p1);
+  dense.AddPlayer(p1);
+  vector<vector<int> > payoffs = {{1, -2, 3, -4}, {-1, 2, -3, 4}};
+  dense.SwapDensePayoffs(&payoffs);
+  ASSERT_TRUE(BinaryGame::Write(dense, path));
+  BinaryGame binary_game(path);
+  Game loaded = binary_game.Load();
+  ASSERT_EQ("", binary_game.error());
+  EXPECT_TRUE(loaded.dense());
+  EXPECT_TRUE(loaded.zero_sum());
+  EXPECT_EQ(0, loaded.num_outcomes());
+  EXPECT_THAT(loaded.payoff({1, 0}), ElementsAre(-2, 2));
+  EXPECT_THAT(loaded.payoff({1, 1}), ElementsAre(-4, 4));
+}
+
+TEST_F(BinaryGameTest, Malformed) {
+  ofstream stream(path.c_str());
+  stream << "NFG 1 R \"not binary\"";
+  stream.close();
+  EXPECT_FALSE(BinaryGame::Detect(path));
+  BinaryGame binary_game(path);
+  binary_game.Load();
+  EXPECT_NE("", binary_game.error());
+}
+
+// Overwrites the 32-bit value at given offset of the file at given path.
+void Patch(const string& path, const std::streamoff offset,
+           const int32_t value) {
+  std::fstream stream(path.c_str(), std::ios::in | std::ios::out |
+                                    std::ios::binary);
+  stream.seekp(offset, offset < 0 ? std::ios::end : std::ios::beg);
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST_F(BinaryGameTest, CorruptOutcomeIds) {
+  ASSERT_TRUE(BinaryGame::Write(game, path));
+  // The payoff section ends the file, its last entry is an outcome id.
+  Patch(path, -4, 3);
+  BinaryGame binary_game(path);
+  binary_game.Load();
+  EXPECT_EQ("Corrupt binary game outcome ids", binary_game.error());
+  Patch(path, -4, -1);
+  binary_game.Load();
+  EXPECT_EQ("Corrupt binary game outcome ids", binary_game.error());
+  Patch(path, -4, 2);
+  binary_game.Load();
+  EXPECT_EQ("", binary_game.error());
+}
+
+TEST_F(BinaryGameTest, CorruptNumPlayers) {
+  ASSERT_TRUE(BinaryGame::Write(game, path));
+  // The player count follows the magic, version, byte order and flags.
+  Patch(path, 20, -1);
+  BinaryGame binary_game(path);
+  binary_game.Load();
+  EXPECT_EQ("Corrupt binary game dimensions", binary_game.error());
+}
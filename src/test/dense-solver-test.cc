@@ -0,0 +1,151 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdlib>
+#include <vector>
+#include "../dense-solver.h"
+#include "../game.h"
+#include "../lcp.h"
+#include "../lcp-factory.h"
+#include "../lp-solver.h"
+
+using ash::DenseSolver;
+using ash::Game;
+using ash::Lcp;
+using ash::LcpFactory;
+using ash::LpSolver;
+using ash::Player;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given numbers of strategies and random payoffs from
+// given range.
+Game CreateRandomGame(const vector<int>& num_strategies, const int range) {
+  Game game("random");
+  for (size_t p = 0; p < num_strategies.size(); ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(num_strategies.size(),
+                               vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Solves the LCP of each support combination of given game with the dense
+// solver and the LP solver and compares the results. Returns the number of
+// solves the dense solver passed on to the LP solver.
+int ExpectSameSolutions(const Game& game) {
+  vector<vector<int> > compl_map;
+  vector<vector<int> > player_vars;
+  Lcp lcp = LcpFactory::Create(game, &compl_map, &player_vars);
+  DenseSolver solver(lcp);
+  const int num_players = game.num_players();
+  vector<uint32_t> supports(num_players, 1u);
+  int num_solved = 0;
+  int p = 0;
+  while (p < num_players) {
+    for (int q = 0; q < num_players; ++q) {
+      for (int s = 0; s < game.num_strategies(q); ++s) {
+        const bool supported = supports[q] & (1u << s);
+        lcp.SelectEquation(compl_map[q][s], !supported, supported);
+      }
+    }
+    LpSolver lp_solver(lcp);
+    const bool solved = lp_solver.Solve();
+    EXPECT_EQ(solved, solver.Solve());
+    if (solved) {
+      ++num_solved;
+      const vector<double>& expected = lp_solver.solution();
+      EXPECT_EQ(expected.size(), solver.solution().size());
+      for (size_t v = 0; v < solver.solution().size(); ++v) {
+        EXPECT_NEAR(expected[v], solver.solution()[v], 1e-6);
+      }
+    }
+    // Odometer over the non-empty supports.
+    for (p = 0; p < num_players; ++p) {
+      if (++supports[p] < (1u << game.num_strategies(p))) {
+        break;
+      }
+      supports[p] = 1u;
+    }
+  }
+  EXPECT_LT(0, num_solved);
+  return solver.num_fallbacks();
+}
+
+TEST(DenseSolverTest, MatchesLpSolver) {
+  std::srand(9);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({3 + i % 2, 4}, 10000);
+    ASSERT_FALSE(game.zero_sum());
+    EXPECT_EQ(0, ExpectSameSolutions(game));
+  }
+  const Game game = CreateRandomGame({2, 3, 2}, 100);
+  ASSERT_FALSE(game.zero_sum());
+  ExpectSameSolutions(game);
+}
+
+TEST(DenseSolverTest, Degenerate) {
+  // Payoff ties make many of the support systems singular.
+  std::srand(10);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({3, 3}, 2);
+    if (!game.zero_sum()) {
+      EXPECT_LT(0, ExpectSameSolutions(game));
+    }
+  }
+}
+
+TEST(DenseSolverTest, UpdatesGrayOrder) {
+  // The supports of equal sizes in Gray code order differ in few strategies,
+  // which switches few complementary pairs and updates the inverse.
+  std::srand(11);
+  const Game game = CreateRandomGame({4, 4}, 10000);
+  vector<vector<int> > compl_map;
+  vector<vector<int> > player_vars;
+  Lcp lcp = LcpFactory::Create(game, &compl_map, &player_vars);
+  DenseSolver solver(lcp);
+  int num_solves = 0;
+  int num_solved = 0;
+  for (uint32_t i = 1; i < (1u << 8); ++i) {
+    const uint32_t gray = i ^ (i >> 1);
+    const uint32_t supports[] = {gray & 15u, gray >> 4};
+    if (supports[0] == 0 ||
+        __builtin_popcount(supports[0]) != __builtin_popcount(supports[1])) {
+      continue;
+    }
+    for (int q = 0; q < 2; ++q) {
+      for (int s = 0; s < 4; ++s) {
+        const bool supported = supports[q] & (1u << s);
+        lcp.SelectEquation(compl_map[q][s], !supported, supported);
+      }
+    }
+    LpSolver lp_solver(lcp);
+    const bool solved = lp_solver.Solve();
+    EXPECT_EQ(solved, solver.Solve());
+    ++num_solves;
+    if (solved) {
+      ++num_solved;
+      const vector<double>& expected = lp_solver.solution();
+      for (size_t v = 0; v < solver.solution().size(); ++v) {
+        EXPECT_NEAR(expected[v], solver.solution()[v], 1e-6);
+      }
+    }
+  }
+  EXPECT_EQ(69, num_solves);
+  EXPECT_LT(0, num_solved);
+  EXPECT_EQ(0, solver.num_fallbacks());
+  EXPECT_GT(num_solves / 4, solver.num_rebuilds());
+}
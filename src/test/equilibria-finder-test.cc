@@ -0,0 +1,223 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "../equilibria-finder.h"
+#include "../game.h"
+
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::ProfileIterator;
+using ash::StrategyProfile;
+
+using std::set;
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given numbers of strategies and random payoffs from
+// given range.
+Game CreateRandomGame(const vector<int>& num_strategies, const int range) {
+  Game game("random");
+  for (size_t p = 0; p < num_strategies.size(); ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(num_strategies.size(),
+                               vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Returns the probabilities of given profile rounded to 6 digits, which
+// ignores the round-off errors of the LP solvers.
+vector<int> Rounded(const MixedStrategyProfile& profile, const Game& game) {
+  vector<int> probs;
+  for (int p = 0; p < game.num_players(); ++p) {
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      probs.push_back(std::round(profile.probability(p, s) * 1e6));
+    }
+  }
+  return probs;
+}
+
+// Returns the distinct mixed equilibria of given finder.
+set<vector<int> > MixedEquilibria(const EquilibriaFinder& finder) {
+  set<vector<int> > equilibria;
+  const vector<MixedStrategyProfile>& eqs = finder.mixed_equilibria();
+  for (auto it = eqs.begin(); it != eqs.end(); ++it) {
+    equilibria.insert(Rounded(*it, finder.game()));
+  }
+  return equilibria;
+}
+
+TEST(EquilibriaFinderTest, StreamAndCount) {
+  std::srand(4);
+  const Game game = CreateRandomGame({4, 3, 4, 3}, 2);
+  EquilibriaFinder finder(game);
+  const int num_eq = finder.FindPure();
+  ASSERT_LT(2, num_eq);
+  EXPECT_EQ(num_eq, finder.CountPure());
+  EXPECT_TRUE(finder.equilibria().empty());
+  vector<StrategyProfile> visited;
+  EXPECT_EQ(2, finder.FindPure([&visited](const StrategyProfile& profile) {
+    visited.push_back(profile);
+    return visited.size() < 2;
+  }));
+  finder.FindPure();
+  ASSERT_EQ(2u, visited.size());
+  EXPECT_EQ(finder.equilibria()[1].str(), visited[1].str());
+}
+
+TEST(EquilibriaFinderTest, ParallelMixedMatchesSerial) {
+  std::srand(8);
+  for (int i = 0; i < 3; ++i) {
+    // 256 support combinations, enough for several chunks.
+    const Game game = CreateRandomGame({4, 4}, 10);
+    EquilibriaFinder serial_finder(game);
+    serial_finder.specialized(false);
+    const int num_eq = serial_finder.FindMixed();
+    ASSERT_LT(0, num_eq);
+    EquilibriaFinder finder(game);
+    finder.specialized(false);
+    finder.num_threads(4);
+    ASSERT_EQ(num_eq, finder.FindMixed());
+    for (int e = 0; e < num_eq; ++e) {
+      EXPECT_EQ(serial_finder.mixed_equilibria()[e].str(game),
+                finder.mixed_equilibria()[e].str(game));
+    }
+    // Later ranges finishing first must not change the first equilibrium.
+    finder.max_num_equilibria(1);
+    for (int run = 0; run < 10; ++run) {
+      EXPECT_EQ(1, finder.FindMixed());
+      EXPECT_EQ(serial_finder.mixed_equilibria()[0].str(game),
+                finder.mixed_equilibria()[0].str(game));
+    }
+  }
+}
+
+TEST(EquilibriaFinderTest, PnsMatchesBimatrix) {
+  std::srand(11);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({4, 3 + i % 2}, 100);
+    EquilibriaFinder bimatrix_finder(game);
+    ASSERT_LT(0, bimatrix_finder.FindMixed());
+    const set<vector<int> > expected = MixedEquilibria(bimatrix_finder);
+    EquilibriaFinder finder(game);
+    finder.specialized(false);
+    finder.FindMixed();
+    EXPECT_EQ(expected, MixedEquilibria(finder));
+    finder.pns(true);
+    finder.FindMixed();
+    EXPECT_EQ(expected, MixedEquilibria(finder));
+    finder.max_num_equilibria(1);
+    ASSERT_EQ(1, finder.FindMixed());
+    EXPECT_EQ(1u, expected.count(Rounded(finder.mixed_equilibria()[0], game)));
+  }
+}
+
+TEST(EquilibriaFinderTest, SupportSizes) {
+  // Matching pennies has only the fully mixed equilibrium, coordination has
+  // the two pure equilibria in addition.
+  const Game game = CreateRandomGame({2, 2}, 1);
+  EquilibriaFinder finder(game);
+  finder.specialized(false);
+  finder.pns(true);
+  vector<vector<int> > payoffs = {{1, 0, 0, 1}, {1, 0, 0, 1}};
+  Game coordination = game;
+  coordination.SwapDensePayoffs(&payoffs);
+  EquilibriaFinder coordination_finder(coordination);
+  coordination_finder.pns(true);
+  EXPECT_EQ(3, coordination_finder.FindMixed());
+  coordination_finder.support_sizes(1, 1);
+  EXPECT_EQ(2, coordination_finder.FindMixed());
+  coordination_finder.support_sizes(2, 2);
+  ASSERT_EQ(1, coordination_finder.FindMixed());
+  EXPECT_FLOAT_EQ(0.5, coordination_finder.mixed_equilibria()[0]
+                       .probability(0, 0));
+}
+
+TEST(EquilibriaFinderTest, LemkeHowsonSubsetOfBimatrix) {
+  std::srand(13);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({4, 3 + i % 2}, 100);
+    EquilibriaFinder bimatrix_finder(game);
+    ASSERT_LT(0, bimatrix_finder.FindMixed());
+    const set<vector<int> > expected = MixedEquilibria(bimatrix_finder);
+    EquilibriaFinder finder(game);
+    finder.lemke_howson(true);
+    ASSERT_LT(0, finder.FindMixed());
+    const set<vector<int> > equilibria = MixedEquilibria(finder);
+    for (auto it = equilibria.begin(); it != equilibria.end(); ++it) {
+      EXPECT_EQ(1u, expected.count(*it));
+    }
+    finder.max_num_equilibria(1);
+    EXPECT_EQ(1, finder.FindMixed());
+  }
+}
+
+TEST(EquilibriaFinderTest, VertexEnumerationMatchesBimatrix) {
+  std::srand(15);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({4, 3 + i % 2}, 100);
+    EquilibriaFinder bimatrix_finder(game);
+    ASSERT_LT(0, bimatrix_finder.FindMixed());
+    EXPECT_TRUE(bimatrix_finder.cliques().empty());
+    EquilibriaFinder finder(game);
+    finder.vertex_enumeration(true);
+    const int num_eq = finder.FindMixed();
+    EXPECT_EQ(MixedEquilibria(bimatrix_finder), MixedEquilibria(finder));
+    EXPECT_EQ(num_eq, static_cast<int>(MixedEquilibria(finder).size()));
+    // Nondegenerate games have isolated equilibria.
+    EXPECT_EQ(num_eq, static_cast<int>(finder.cliques().size()));
+  }
+}
+
+TEST(EquilibriaFinderTest, SymmetricMixed) {
+  // Three-player rock-paper-scissors, a player wins if it alone plays the
+  // strategy beating those of both others. The six profiles of distinct
+  // strategies are equilibria besides the uniform one.
+  Game game = CreateRandomGame({3, 3, 3}, 1);
+  vector<vector<int> > payoffs(3, vector<int>(game.num_strategy_profiles()));
+  for (ProfileIterator it(game); !it.done(); it.Next()) {
+    const StrategyProfile& profile = it.profile();
+    for (int p = 0; p < 3; ++p) {
+      const int a = profile[(p + 1) % 3];
+      const int b = profile[(p + 2) % 3];
+      if (a == b && profile[p] == (a + 1) % 3) {
+        for (int q = 0; q < 3; ++q) {
+          payoffs[q][it.id()] = q == p ? 1 : -1;
+        }
+      }
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  EquilibriaFinder finder(game);
+  EXPECT_EQ(6, finder.FindPure());
+  EXPECT_EQ(7, finder.FindMixed());
+  finder.symmetric_mixed(true);
+  ASSERT_EQ(1, finder.FindMixed());
+  EXPECT_FLOAT_EQ(1.0f / 3, finder.mixed_equilibria()[0].probability(0, 0));
+}
+
+TEST(EquilibriaFinderTest, OversizedPolynomialSupports) {
+  // The support masks of three or more players hold 32 strategies each.
+  const Game game = CreateRandomGame({33, 2, 2}, 10);
+  EquilibriaFinder finder(game);
+  EXPECT_EQ(0, finder.FindMixed());
+  EXPECT_TRUE(finder.mixed_equilibria().empty());
+}
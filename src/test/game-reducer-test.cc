@@ -0,0 +1,107 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <limits>
+#include <vector>
+#include "../equilibria-finder.h"
+#include "../game.h"
+#include "../game-reducer.h"
+
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::GameReducer;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::StrategyProfile;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a two-player game with given per-player payoffs in profile id
+// order and strategies named by their index.
+Game CreateGame(const int n, const int m, vector<vector<int> > payoffs) {
+  Game game("reducible");
+  const int dims[] = {n, m};
+  for (int p = 0; p < 2; ++p) {
+    Player player(p ? "p2" : "p1");
+    for (int s = 0; s < dims[p]; ++s) {
+      player.AddStrategy(game.AddStrategy(std::string(1, 'a' + s)));
+    }
+    game.AddPlayer(player);
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+TEST(GameReducerTest, PureDominance) {
+  // Prisoner's dilemma, cooperation (a) is strictly dominated by defection.
+  const Game game = CreateGame(2, 2, {{3, 5, 0, 1}, {3, 0, 5, 1}});
+  GameReducer reducer(game);
+  EXPECT_EQ(2, reducer.Reduce());
+  EXPECT_EQ(1, reducer.num_strategies(0));
+  EXPECT_EQ(1, reducer.strategy(1, 0));
+  const Game reduced = reducer.ReducedGame();
+  EXPECT_EQ(1, reduced.num_strategy_profiles());
+  EXPECT_EQ(1, reduced.payoff(0, 0));
+  EXPECT_EQ("(1 1)", reducer.Expand(StrategyProfile({0, 0})).str());
+}
+
+TEST(GameReducerTest, ExtremeMixedDominance) {
+  // Row b is dominated by the even mix of rows a and c, whose payoffs span
+  // the whole integer range.
+  const int kMax = std::numeric_limits<int>::max();
+  const int kMin = std::numeric_limits<int>::min();
+  const int kLow = -(1 << 30);
+  const Game game = CreateGame(3, 2, {{kMax, kLow, kMin, kMin, kLow, kMax},
+                                      {0, 0, 0, 0, 0, 0}});
+  GameReducer reducer(game);
+  EXPECT_EQ(0, reducer.Reduce());
+  reducer.mixed(true);
+  EXPECT_EQ(1, reducer.Reduce());
+  EXPECT_EQ(2, reducer.num_strategies(0));
+  EXPECT_EQ(0, reducer.strategy(0, 0));
+  EXPECT_EQ(2, reducer.strategy(0, 1));
+}
+
+TEST(GameReducerTest, IteratedMixedDominance) {
+  // Column c is dominated by column a, after which row b is dominated only by
+  // the mix of rows a and c.
+  //      a     b     c
+  // a  3, 1  0, 1  0, 0
+  // b  1, 1  1, 1  5, 0
+  // c  0, 1  4, 1  0, 0
+  const Game game = CreateGame(3, 3, {{3, 1, 0, 0, 1, 4, 0, 5, 0},
+                                      {1, 1, 1, 1, 1, 1, 0, 0, 0}});
+  GameReducer reducer(game);
+  EXPECT_EQ(1, reducer.Reduce());
+  EXPECT_EQ(2, reducer.num_strategies(1));
+  EXPECT_EQ(3, reducer.num_strategies(0));
+  reducer.mixed(true);
+  EXPECT_EQ(1, reducer.Reduce());
+  EXPECT_EQ(2, reducer.num_eliminated());
+  EXPECT_EQ(0, reducer.strategy(0, 0));
+  EXPECT_EQ(2, reducer.strategy(0, 1));
+  const Game reduced = reducer.ReducedGame();
+  EXPECT_EQ(4, reduced.payoff(3, 0));
+  EXPECT_EQ("c", reduced.strategy(reduced.player(0).strategy(1)));
+
+  EquilibriaFinder finder(reduced);
+  EquilibriaFinder original_finder(game);
+  ASSERT_EQ(original_finder.FindPure(), finder.FindPure());
+  for (size_t e = 0; e < finder.equilibria().size(); ++e) {
+    EXPECT_EQ(original_finder.equilibria()[e].str(),
+              reducer.Expand(finder.equilibria()[e]).str());
+  }
+  MixedStrategyProfile mixed(2);
+  mixed.SetNumStrategies(0, 2);
+  mixed.SetNumStrategies(1, 2);
+  mixed.AddProbability(0, 1, 1.0f);
+  mixed.AddProbability(1, 0, 0.5f);
+  mixed.AddProbability(1, 1, 0.5f);
+  const MixedStrategyProfile expanded = reducer.Expand(mixed);
+  EXPECT_FLOAT_EQ(0.0f, expanded.probability(0, 1));
+  EXPECT_FLOAT_EQ(1.0f, expanded.probability(0, 2));
+  EXPECT_FLOAT_EQ(0.0f, expanded.probability(1, 2));
+}
@@ -3,14 +3,21 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <fstream>
+#include <limits>
 #include <vector>
 #include <set>
 #include "../game.h"
+#include "../game-factory.h"
+#include "../packed-array.h"
+#include "../parser.h"
 
 using ash::StrategyProfile;
 using ash::Player;
 using ash::Outcome;
 using ash::Game;
+using ash::GameFactory;
+using base::PackedArray;
+using ash::ProfileIterator;
 
 using std::vector;
 using std::set;
@@ -138,3 +145,202 @@ TEST_F(GameTest, StrategyProfile) {
   EXPECT_EQ(1, profile[1]);
   EXPECT_EQ(2, profile[2]);
 }
+
+TEST_F(GameTest, DensePayoffs) {
+  Game game("Matching Pennies");
+  Player p1("p1");
+  Player p2("p2");
+  p1.AddStrategy(game.AddStrategy("heads"));
+  p1.AddStrategy(game.AddStrategy("tails"));
+  p2.AddStrategy(game.AddStrategy("heads"));
+  p2.AddStrategy(game.AddStrategy("tails"));
+  game.AddPlayer(p1);
+  game.AddPlayer(p2);
+  ASSERT_EQ(4, game.num_strategy_profiles());
+  vector<vector<int> > payoffs = {{1, -1, -1, 1}, {-1, 1, 1, -1}};
+  game.SwapDensePayoffs(&payoffs);
+  EXPECT_TRUE(game.dense());
+  EXPECT_TRUE(game.zero_sum());
+  EXPECT_EQ(0, game.num_outcomes());
+  EXPECT_THAT(game.payoff({0, 0}), ElementsAre(1, -1));
+  EXPECT_THAT(game.payoff({1, 0}), ElementsAre(-1, 1));
+  EXPECT_THAT(game.payoff({0, 1}), ElementsAre(-1, 1));
+  EXPECT_EQ(1, game.payoff({1, 1}, 0));
+  EXPECT_EQ(-1, game.payoff(3, 1));
+}
+
+TEST_F(GameTest, ZeroSumOverflow) {
+  // The payoffs sum up to 2^32, which wraps around to 0 in 32 bits.
+  const int kMax = std::numeric_limits<int>::max();
+  Game game("Overflow");
+  for (int p = 0; p < 3; ++p) {
+    Player player("p");
+    player.AddStrategy(game.AddStrategy("s"));
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs = {{kMax}, {kMax}, {2}};
+  game.SwapDensePayoffs(&payoffs);
+  EXPECT_FALSE(game.zero_sum());
+  Game outcome_game("Overflow");
+  outcome_game.AddOutcome(Outcome("o", {kMax, kMax, 2}));
+  EXPECT_FALSE(outcome_game.zero_sum());
+}
+
+TEST_F(GameTest, FlattenPayoffs) {
+  Game game("Battle of the Sexes");
+  Player p1("p1");
+  Player p2("p2");
+  p1.AddStrategy(game.AddStrategy("ballet"));
+  p1.AddStrategy(game.AddStrategy("football"));
+  p2.AddStrategy(game.AddStrategy("ballet"));
+  p2.AddStrategy(game.AddStrategy("football"));
+  game.AddPlayer(p1);
+  game.AddPlayer(p2);
+  game.AddOutcome(Outcome("null", {0, 0}));
+  game.AddOutcome(Outcome("bb", {2, 1}));
+  game.AddOutcome(Outcome("ff", {1, 2}));
+  game.SetPayoff({0, 0}, 1);
+  game.SetPayoff({1, 0}, 0);
+  game.SetPayoff({0, 1}, 0);
+  game.SetPayoff({1, 1}, 2);
+  EXPECT_FALSE(game.dense());
+  game.FlattenPayoffs();
+  EXPECT_TRUE(game.dense());
+  EXPECT_EQ(3, game.num_outcomes());
+  EXPECT_EQ(2, game.payoff_index(3));
+  EXPECT_THAT(game.payoff({0, 0}), ElementsAre(2, 1));
+  EXPECT_THAT(game.payoff({1, 1}), ElementsAre(1, 2));
+  EXPECT_EQ(0, game.payoff(1, 0));
+  EXPECT_THAT(vector<int>(game.payoffs(1), game.payoffs(1) + 4),
+              ElementsAre(1, 0, 0, 2));
+  Game mapped_game = game;
+  ASSERT_TRUE(mapped_game.FlattenPayoffs("/tmp/ash-game-test-payoffs"));
+  EXPECT_FALSE(std::ifstream("/tmp/ash-game-test-payoffs").good());
+  EXPECT_FALSE(game.mapped());
+  EXPECT_TRUE(mapped_game.mapped());
+  EXPECT_THAT(mapped_game.payoff({0, 0}), ElementsAre(2, 1));
+  EXPECT_THAT(vector<int>(mapped_game.payoffs(0), mapped_game.payoffs(0) + 4),
+              ElementsAre(2, 0, 0, 1));
+}
+
+TEST_F(GameTest, LargeProfileIds) {
+  Game game("Large");
+  const int num_strategies = 1 << 11;
+  for (int p = 0; p < 3; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies; ++s) {
+      player.AddStrategy(s);
+    }
+    game.AddPlayer(player);
+  }
+  EXPECT_EQ(int64_t(1) << 33, game.num_strategy_profiles());
+  EXPECT_EQ(int64_t(1) << 22, game.stride(2));
+  const int64_t sp_id = game.num_strategy_profiles() - 2;
+  const StrategyProfile profile = game.CreateProfile(sp_id);
+  EXPECT_EQ(num_strategies - 2, profile[0]);
+  EXPECT_EQ(num_strategies - 1, profile[2]);
+  ProfileIterator it(game, 2, num_strategies - 1);
+  EXPECT_EQ(game.stride(2) * (num_strategies - 1), it.id());
+  EXPECT_EQ(it.id() + num_strategies - 1,
+            it.deviation(0, num_strategies - 1));
+}
+
+TEST_F(GameTest, ProfileIterator) {
+  Game game("3x2x2");
+  Player p1("p1");
+  Player p2("p2");
+  Player p3("p3");
+  for (int s = 0; s < 3; ++s) {
+    p1.AddStrategy(game.AddStrategy("s"));
+  }
+  for (int s = 0; s < 2; ++s) {
+    p2.AddStrategy(game.AddStrategy("s"));
+    p3.AddStrategy(game.AddStrategy("s"));
+  }
+  game.AddPlayer(p1);
+  game.AddPlayer(p2);
+  game.AddPlayer(p3);
+  EXPECT_EQ(1, game.stride(0));
+  EXPECT_EQ(3, game.stride(1));
+  EXPECT_EQ(6, game.stride(2));
+  int sp = 0;
+  for (ProfileIterator it(game); !it.done(); it.Next(), ++sp) {
+    EXPECT_EQ(sp, it.id());
+    EXPECT_EQ(game.CreateProfile(sp).str(), it.profile().str());
+  }
+  EXPECT_EQ(12, sp);
+  vector<int> ids;
+  for (ProfileIterator it(game, 1, 1); !it.done(); it.Next()) {
+    EXPECT_EQ(1, it.profile()[1]);
+    ids.push_back(it.id());
+  }
+  EXPECT_THAT(ids, ElementsAre(3, 4, 5, 9, 10, 11));
+  ProfileIterator it(game, 0, 2);
+  it.Next();
+  EXPECT_EQ(5, it.id());
+  EXPECT_EQ(3, it.deviation(0, 0));
+  EXPECT_EQ(2, it.deviation(1, 0));
+  EXPECT_EQ(11, it.deviation(2, 1));
+}
+
+TEST(PackedArrayTest, Widths) {
+  EXPECT_EQ(1, PackedArray::Width(1));
+  EXPECT_EQ(2, PackedArray::Width(2));
+  EXPECT_EQ(4, PackedArray::Width(15));
+  EXPECT_EQ(8, PackedArray::Width(16));
+  EXPECT_EQ(16, PackedArray::Width(65535));
+  EXPECT_EQ(32, PackedArray::Width(65536));
+  for (uint32_t max_value : {1u, 3u, 5u, 200u, 60000u, 0xffffffffu}) {
+    PackedArray array(1000, max_value);
+    for (size_t i = 0; i < array.size(); ++i) {
+      array.set(i, (i * 7919) % (uint64_t(max_value) + 1));
+    }
+    for (size_t i = 0; i < array.size(); ++i) {
+      ASSERT_EQ((i * 7919) % (uint64_t(max_value) + 1), array[i]);
+    }
+  }
+  EXPECT_EQ(128u, PackedArray(1000, 1).num_bytes());
+}
+
+TEST(GameFactoryTest, InternedPackedOutcomes) {
+  ash::parse::StrategicGame parsed_game;
+  parsed_game.name = "Matching Pennies";
+  parsed_game.players = {"p1", "p2"};
+  parsed_game.strategies = {{"heads", "tails"}, {"heads", "tails"}};
+  parsed_game.outcomes = {ash::parse::Outcome("hh", {1, -1}),
+                          ash::parse::Outcome("th", {-1, 1}),
+                          ash::parse::Outcome("ht", {-1, 1}),
+                          ash::parse::Outcome("tt", {1, -1})};
+  parsed_game.payoff_indices = {1, 2, 3, 4};
+  Game game = GameFactory::Create(parsed_game, GameFactory::kPacked);
+  EXPECT_TRUE(game.packed());
+  EXPECT_FALSE(game.dense());
+  EXPECT_EQ(3, game.num_outcomes());
+  EXPECT_EQ("hh", game.outcome(1).name());
+  EXPECT_EQ("th", game.outcome(2).name());
+  EXPECT_EQ(1, game.payoff_index(0));
+  EXPECT_EQ(2, game.payoff_index(2));
+  EXPECT_EQ(1, game.payoff_index(3));
+  EXPECT_THAT(game.payoff({0, 1}), ElementsAre(-1, 1));
+  EXPECT_EQ(1, game.payoff(3, 0));
+  game = GameFactory::Create(&parsed_game, GameFactory::kOutcomes);
+  EXPECT_FALSE(game.packed());
+  EXPECT_EQ(3, game.num_outcomes());
+  EXPECT_EQ(1, game.payoff_index(3));
+}
+
+TEST(GameFactoryTest, ZeroPayoffOutcome) {
+  ash::parse::StrategicGame parsed_game;
+  parsed_game.name = "Draws";
+  parsed_game.players = {"p1", "p2"};
+  parsed_game.strategies = {{"a", "b"}, {"a"}};
+  parsed_game.outcomes = {ash::parse::Outcome("draw", {0, 0}),
+                          ash::parse::Outcome("tie", {0, 0})};
+  parsed_game.payoff_indices = {0, 2};
+  Game game = GameFactory::Create(parsed_game, GameFactory::kOutcomes);
+  EXPECT_EQ(2, game.num_outcomes());
+  EXPECT_EQ("null", game.outcome(0).name());
+  EXPECT_EQ("draw", game.outcome(1).name());
+  EXPECT_EQ(0, game.payoff_index(0));
+  EXPECT_EQ(1, game.payoff_index(1));
+}
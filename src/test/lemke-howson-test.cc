@@ -0,0 +1,120 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "../game.h"
+#include "../lemke-howson.h"
+
+using ash::Game;
+using ash::LemkeHowson;
+using ash::MixedStrategyProfile;
+using ash::Player;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a two-player game with given numbers of strategies and random
+// payoffs from given range.
+Game CreateRandomGame(const int m, const int n, const int range) {
+  Game game("random");
+  const int num_strategies[] = {m, n};
+  for (int p = 0; p < 2; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(2, vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Returns true if the strategies in the support of each player are best
+// responses to the other player's strategy.
+bool IsEquilibrium(const Game& game, const MixedStrategyProfile& profile) {
+  const int m = game.num_strategies(0);
+  const int n = game.num_strategies(1);
+  for (int p = 0; p < 2; ++p) {
+    const int num_own = p == 0 ? m : n;
+    const int num_other = p == 0 ? n : m;
+    vector<double> expected(num_own, 0.0);
+    for (int s = 0; s < num_own; ++s) {
+      for (int o = 0; o < num_other; ++o) {
+        const int64_t id = p == 0 ? s + o * m : o + s * m;
+        expected[s] += profile.probability(1 - p, o) * game.payoff(id, p);
+      }
+    }
+    double best = expected[0];
+    double sum = 0.0;
+    for (int s = 0; s < num_own; ++s) {
+      best = std::max(best, expected[s]);
+      sum += profile.probability(p, s);
+    }
+    if (std::fabs(sum - 1.0) > 1e-4) {
+      return false;
+    }
+    for (int s = 0; s < num_own; ++s) {
+      if (profile.probability(p, s) > 0.0f && expected[s] < best - 1e-3) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(LemkeHowsonTest, AllLabels) {
+  std::srand(5);
+  for (int i = 0; i < 10; ++i) {
+    const Game game = CreateRandomGame(3 + i % 3, 4, 10);
+    LemkeHowson solver(game);
+    for (int label = 0; label < solver.num_labels(); ++label) {
+      MixedStrategyProfile equilibrium(2);
+      ASSERT_TRUE(solver.Solve(label, &equilibrium));
+      EXPECT_LT(0, solver.num_pivots());
+      EXPECT_TRUE(IsEquilibrium(game, equilibrium)) << equilibrium.str(game);
+    }
+    vector<MixedStrategyProfile> equilibria;
+    const int num_eq = solver.FindMixed(
+        1000, [&equilibria](const MixedStrategyProfile& profile) {
+          equilibria.push_back(profile);
+          return true;
+        });
+    EXPECT_LT(0, num_eq);
+    EXPECT_EQ(num_eq, static_cast<int>(equilibria.size()));
+    EXPECT_EQ(1, solver.FindMixed(1, ash::MixedVisitor()));
+  }
+}
+
+TEST(LemkeHowsonTest, Degenerate) {
+  // Constant payoffs make every profile an equilibrium, the lexicographic
+  // ratio test breaks all ties.
+  std::srand(6);
+  const Game game = CreateRandomGame(4, 4, 1);
+  LemkeHowson solver(game);
+  for (int label = 0; label < solver.num_labels(); ++label) {
+    MixedStrategyProfile equilibrium(2);
+    ASSERT_TRUE(solver.Solve(label, &equilibrium));
+    EXPECT_TRUE(IsEquilibrium(game, equilibrium));
+  }
+}
+
+TEST(LemkeHowsonTest, Large) {
+  std::srand(7);
+  const Game game = CreateRandomGame(20, 20, 1000);
+  LemkeHowson solver(game);
+  MixedStrategyProfile equilibrium(2);
+  ASSERT_TRUE(solver.Solve(0, &equilibrium));
+  EXPECT_TRUE(IsEquilibrium(game, equilibrium));
+  EXPECT_LT(0, solver.num_pivots());
+}
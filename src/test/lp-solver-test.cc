@@ -0,0 +1,77 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdlib>
+#include <vector>
+#include "../game.h"
+#include "../lcp.h"
+#include "../lcp-factory.h"
+#include "../lp-solver.h"
+
+using ash::Game;
+using ash::Lcp;
+using ash::LcpFactory;
+using ash::LpSolver;
+using ash::Player;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a two-player game with random payoffs from given range.
+Game CreateRandomGame(const int m, const int n, const int range) {
+  Game game("random");
+  const int num_strategies[] = {m, n};
+  for (int p = 0; p < 2; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(2, vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+TEST(LpSolverTest, PersistentModel) {
+  std::srand(12);
+  const Game game = CreateRandomGame(3, 4, 100);
+  ASSERT_FALSE(game.zero_sum());
+  vector<vector<int> > compl_map;
+  Lcp lcp = LcpFactory::Create(game, &compl_map, NULL);
+  LpSolver solver(lcp);
+  int num_solved = 0;
+  // Supports in Gray code order and back, each step switches one pair.
+  for (int i = 1; i < 2 * (1 << 7); ++i) {
+    const int index = i < (1 << 7) ? i : 2 * (1 << 7) - i;
+    const int gray = index ^ (index >> 1);
+    for (int s = 0; s < 7; ++s) {
+      const int p = s < 3 ? 0 : 1;
+      const bool supported = gray & (1 << s);
+      lcp.SelectEquation(compl_map[p][p == 0 ? s : s - 3], !supported,
+                         supported);
+    }
+    LpSolver fresh_solver(lcp);
+    const bool solved = fresh_solver.Solve();
+    ASSERT_EQ(solved, solver.Solve());
+    // Equal support sizes have unique solutions in nondegenerate games.
+    const bool balanced = __builtin_popcount(gray & 7) ==
+                          __builtin_popcount(gray & 120);
+    if (solved) {
+      ++num_solved;
+    }
+    if (solved && balanced) {
+      for (int v = 0; v < lcp.num_variables(); ++v) {
+        EXPECT_NEAR(fresh_solver.solution()[v], solver.solution()[v], 1e-6);
+      }
+    }
+  }
+  EXPECT_LT(0, num_solved);
+}
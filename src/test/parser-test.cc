@@ -3,13 +3,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <fstream>
+#include <limits>
 #include <vector>
 #include <set>
 #include "../parser.h"
+#include "../nfg-reader.h"
+#include "../numeral-tokenizer.h"
 
 using ash::parse::Outcome;
 using ash::parse::StrategicGame;
 using ash::parse::Parser;
+using ash::parse::NfgReader;
+using ash::parse::NumeralTokenizer;
 
 using std::vector;
 using std::set;
@@ -17,6 +22,7 @@ using std::string;
 using std::cout;
 using std::endl;
 using std::ofstream;
+using std::numeric_limits;
 
 using ::testing::ElementsAre;
 using ::testing::Contains;
@@ -203,3 +209,181 @@ TEST_F(ParserTest, ParseStrategicGame) {
   EXPECT_THAT(indices2, ElementsAre(0, 0, 0, 0, 1, 0, 2, 0, 0, 0));
   EXPECT_THAT(indices3, ElementsAre(2, 0, 3, 0, 1, 0, 0));
 }
+
+TEST_F(ParserTest, ParseStrategicGameMapped) {
+  Parser buffered_parser(nfg1_path);
+  StrategicGame expected = buffered_parser.ParseStrategicGame();
+  Parser parser(nfg1_path, Parser::kMapped);
+  StrategicGame game = parser.ParseStrategicGame();
+  ASSERT_EQ("", parser.error());
+  EXPECT_EQ(expected.name, game.name);
+  EXPECT_EQ(expected.players, game.players);
+  EXPECT_EQ(expected.strategies, game.strategies);
+  EXPECT_EQ(expected.comment, game.comment);
+  ASSERT_EQ(expected.outcomes.size(), game.outcomes.size());
+  for (size_t i = 0; i < game.outcomes.size(); ++i) {
+    EXPECT_EQ(expected.outcomes[i].name, game.outcomes[i].name);
+    EXPECT_EQ(expected.outcomes[i].payoffs, game.outcomes[i].payoffs);
+  }
+  EXPECT_EQ(expected.payoff_indices, game.payoff_indices);
+}
+
+TEST_F(ParserTest, ParseStrategicGameMappedMalformed) {
+  const string path = "/tmp/ash-parser-test-nfg1-truncated.nfg";
+  ofstream stream(path.c_str());
+  stream.write(nfg1.c_str(), nfg1.size() - 10);
+  stream.close();
+  Parser parser(path, Parser::kMapped);
+  parser.ParseStrategicGame();
+  EXPECT_EQ("Expected 27 payoff indices, found 22", parser.error());
+}
+
+TEST_F(ParserTest, ParseStrategicGamePayoffVersion) {
+  const string path = "/tmp/ash-parser-test-payoff.nfg";
+  const string nfg = string("NFG 1 R \"PD\" { \"p1\" \"p2\" } { 2 3 }\n") +
+    "\"comment\"\n1 1, 0 2, 2 0, 3 3 -1 -2 4 -5\n";
+  ofstream stream(path.c_str());
+  stream.write(nfg.c_str(), nfg.size());
+  stream.close();
+  const Parser::Mode modes[] = {Parser::kMapped, Parser::kBuffered};
+  for (int m = 0; m < 2; ++m) {
+    Parser parser(path, modes[m]);
+    StrategicGame game = parser.ParseStrategicGame();
+    ASSERT_EQ("", parser.error());
+    EXPECT_EQ("PD", game.name);
+    EXPECT_EQ("comment", game.comment);
+    ASSERT_EQ(2, game.strategies.size());
+    EXPECT_THAT(game.strategies[0], ElementsAre("1", "2"));
+    EXPECT_THAT(game.strategies[1], ElementsAre("1", "2", "3"));
+    EXPECT_EQ(0, game.outcomes.size());
+    EXPECT_EQ(0, game.payoff_indices.size());
+    ASSERT_EQ(2, game.payoffs.size());
+    EXPECT_THAT(game.payoffs[0], ElementsAre(1, 0, 2, 3, -1, 4));
+    EXPECT_THAT(game.payoffs[1], ElementsAre(1, 2, 0, 3, -2, -5));
+  }
+}
+
+TEST_F(ParserTest, ParseStrategicGameBufferedNamedPayoffVersion) {
+  // Strategy names like the outcome version, but payoffs instead of
+  // outcomes.
+  const string path = "/tmp/ash-parser-test-named-payoff.nfg";
+  const string nfg = string("NFG 1 R \"PD\" { \"p1\" \"p2\" }\n") +
+    "{ { \"c\" \"d\" }\n{ \"c\" \"d\" }\n}\n\"\"\n3 3 5 0 0 5 1 1\n";
+  ofstream stream(path.c_str());
+  stream.write(nfg.c_str(), nfg.size());
+  stream.close();
+  Parser parser(path, Parser::kBuffered);
+  StrategicGame game = parser.ParseStrategicGame();
+  ASSERT_EQ("", parser.error());
+  EXPECT_THAT(game.strategies[0], ElementsAre("c", "d"));
+  EXPECT_EQ(0, game.outcomes.size());
+  ASSERT_EQ(2, game.payoffs.size());
+  EXPECT_THAT(game.payoffs[0], ElementsAre(3, 5, 0, 1));
+  EXPECT_THAT(game.payoffs[1], ElementsAre(3, 0, 5, 1));
+}
+
+TEST_F(ParserTest, FeedInParts) {
+  // Feeding the game in parts of every possible size has to yield the same
+  // game as reading it at once.
+  StrategicGame expected;
+  NfgReader(&expected).Read(nfg1.data(), nfg1.data() + nfg1.size());
+  for (size_t part_size = 1; part_size < nfg1.size(); ++part_size) {
+    StrategicGame game;
+    NfgReader reader(&game);
+    string buffer;
+    for (size_t pos = 0; pos < nfg1.size(); pos += part_size) {
+      buffer += nfg1.substr(pos, part_size);
+      const bool last = pos + part_size >= nfg1.size();
+      const char* beg = buffer.data();
+      const char* consumed = reader.Feed(beg, beg + buffer.size(), last);
+      ASSERT_TRUE(consumed != NULL) << reader.error();
+      buffer.erase(0, consumed - beg);
+    }
+    ASSERT_TRUE(reader.Finish()) << reader.error();
+    EXPECT_EQ(expected.name, game.name);
+    EXPECT_EQ(expected.strategies, game.strategies);
+    EXPECT_EQ(expected.comment, game.comment);
+    ASSERT_EQ(expected.outcomes.size(), game.outcomes.size());
+    EXPECT_EQ(expected.outcomes[2].payoffs, game.outcomes[2].payoffs);
+    EXPECT_EQ(expected.payoff_indices, game.payoff_indices);
+  }
+}
+
+TEST_F(ParserTest, ParseStrategicGameStream) {
+  Parser parser(nfg1_path, Parser::kStream);
+  StrategicGame game = parser.ParseStrategicGame();
+  ASSERT_EQ("", parser.error());
+  EXPECT_EQ("3 Player RPS", game.name);
+  EXPECT_EQ(3, game.outcomes.size());
+  EXPECT_EQ(27, game.payoff_indices.size());
+}
+
+TEST_F(ParserTest, NumeralTokenizer) {
+  const string block = " 12 -3,4\n\t567  0 -89 1 2 3 4 5 6 7 8 9 10 11 12 13 ";
+  size_t count = 0;
+  ASSERT_TRUE(NumeralTokenizer::Count(block.data(),
+                                      block.data() + block.size(), &count));
+  EXPECT_EQ(19, count);
+  for (int num_threads = 1; num_threads < 8; ++num_threads) {
+    vector<int> numerals = {42};
+    ASSERT_TRUE(NumeralTokenizer::ConvertParallel(
+        block.data(), block.data() + block.size(), num_threads, &numerals));
+    EXPECT_THAT(numerals, ElementsAre(42, 12, -3, 4, 567, 0, -89, 1, 2, 3, 4,
+                                      5, 6, 7, 8, 9, 10, 11, 12, 13));
+  }
+  const string malformed = "1 2 3 4-5 6 7 8 9 10 11 12 13 14 15 16 17";
+  vector<int> numerals;
+  EXPECT_FALSE(NumeralTokenizer::ConvertParallel(
+      malformed.data(), malformed.data() + malformed.size(), 3, &numerals));
+  EXPECT_TRUE(numerals.empty());
+  const string other = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 }";
+  EXPECT_FALSE(NumeralTokenizer::Count(other.data(),
+                                       other.data() + other.size(), &count));
+}
+
+TEST_F(ParserTest, OversizedNumeral) {
+  const string header = string("NFG 1 R \"PD\" { \"p1\" \"p2\" } { 1 2 }\n") +
+    "\"\"\n";
+  const string versions[] = {
+    header + "1 2 3 2147483647\n",
+    header + "-2147483648 2 3 4\n",
+    header + "{ { \"o\" -2147483648 2 } }\n0 1\n",
+    header + "1 2 3 2147483648\n",
+    header + "1 2 3 -2147483649\n",
+    header + "1 2 3 -99999999999\n",
+    header + "{ { \"o\" 1 21474836470 } }\n0 1\n",
+    header + "{ { \"o\" 1 2 } }\n0 4294967297\n"
+  };
+  for (int v = 0; v < 8; ++v) {
+    StrategicGame game;
+    NfgReader reader(&game);
+    const string& nfg = versions[v];
+    const bool valid = reader.Read(nfg.data(), nfg.data() + nfg.size());
+    if (v == 0) {
+      ASSERT_TRUE(valid) << reader.error();
+      EXPECT_THAT(game.payoffs[1], ElementsAre(2, 2147483647));
+    } else if (v == 1) {
+      ASSERT_TRUE(valid) << reader.error();
+      EXPECT_THAT(game.payoffs[0], ElementsAre(numeric_limits<int>::min(), 3));
+    } else if (v == 2) {
+      ASSERT_TRUE(valid) << reader.error();
+      EXPECT_THAT(game.outcomes[0].payoffs,
+                  ElementsAre(numeric_limits<int>::min(), 2));
+    } else {
+      EXPECT_FALSE(valid);
+      EXPECT_EQ(0, reader.error().find("Numeral out of integer range"))
+          << reader.error();
+    }
+  }
+  const string minimal = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 -2147483648";
+  vector<int> numerals;
+  EXPECT_TRUE(NumeralTokenizer::ConvertParallel(
+      minimal.data(), minimal.data() + minimal.size(), 3, &numerals));
+  ASSERT_EQ(16, numerals.size());
+  EXPECT_EQ(numeric_limits<int>::min(), numerals.back());
+  numerals.clear();
+  const string oversized = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 3000000000";
+  EXPECT_FALSE(NumeralTokenizer::ConvertParallel(
+      oversized.data(), oversized.data() + oversized.size(), 3, &numerals));
+  EXPECT_TRUE(numerals.empty());
+}
@@ -0,0 +1,206 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../game.h"
+#include "../polymatrix-game.h"
+#include "../polymatrix-reader.h"
+
+using ash::MixedStrategyProfile;
+using ash::PolymatrixGame;
+using ash::StrategyProfile;
+using ash::parse::PolymatrixReader;
+
+using std::string;
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+const string kRing =  // NOLINT
+  "PMG 1 R \"Ring\" { \"P1\" \"P2\" \"P3\" \"P4\" }\n"
+  "{ { \"L\" \"R\" } 2 2 2 }\n"
+  "\"Comment\"\n"
+  "{\n"
+  "{ 1 2 { 2 0 0 1 } { 2 0 0 1 } }\n"
+  "{ 2 3 { 2 0 0 1 } { 2 0 0 1 } }\n"
+  "{ 3 4 { 1 0 0 1 } { 1 0 0 1 } }\n"
+  "{ 4 1 { 0 3 3 0 } { 1 0 0 1 } }\n"
+  "}\n";
+
+// Returns a random polymatrix game with an edge between each pair of players
+// with given probability in percent.
+PolymatrixGame CreateRandomGame(const int num_players,
+                                const int num_strategies,
+                                const int edge_percent) {
+  PolymatrixGame game("random");
+  for (int p = 0; p < num_players; ++p) {
+    game.AddPlayer("p", vector<string>(num_strategies, "s"));
+  }
+  for (int u = 0; u < num_players; ++u) {
+    for (int v = u + 1; v < num_players; ++v) {
+      if (std::rand() % 100 >= edge_percent) {
+        continue;
+      }
+      vector<int> u_payoffs(num_strategies * num_strategies);
+      vector<int> v_payoffs(u_payoffs.size());
+      for (size_t i = 0; i < u_payoffs.size(); ++i) {
+        u_payoffs[i] = std::rand() % 7 - 3;
+        v_payoffs[i] = std::rand() % 7 - 3;
+      }
+      game.AddEdge(u, v, u_payoffs, v_payoffs);
+    }
+  }
+  return game;
+}
+
+// Advances the profile to the next one, returns false after the last.
+bool NextProfile(const PolymatrixGame& game, StrategyProfile* profile) {
+  for (int p = 0; p < game.num_players(); ++p) {
+    if ((*profile)[p] + 1 < game.num_strategies(p)) {
+      profile->strategy(p, (*profile)[p] + 1);
+      return true;
+    }
+    profile->strategy(p, 0);
+  }
+  return false;
+}
+
+// Returns the pure equilibria by checking each profile.
+vector<StrategyProfile> BruteForcePure(const PolymatrixGame& game) {
+  vector<StrategyProfile> equilibria;
+  StrategyProfile profile(game.num_players(), 0);
+  do {
+    bool stable = true;
+    for (int p = 0; p < game.num_players() && stable; ++p) {
+      const vector<int> payoffs = game.payoffs(profile, p);
+      for (size_t s = 0; s < payoffs.size() && stable; ++s) {
+        stable = payoffs[s] <= payoffs[profile[p]];
+      }
+    }
+    if (stable) {
+      equilibria.push_back(profile);
+    }
+  } while (NextProfile(game, &profile));
+  return equilibria;
+}
+
+// Returns true if each played strategy is a best response in expectation.
+bool IsEquilibrium(const PolymatrixGame& game,
+                   const MixedStrategyProfile& mixed) {
+  const int num_players = game.num_players();
+  vector<vector<double> > expected(num_players);
+  for (int p = 0; p < num_players; ++p) {
+    expected[p].assign(game.num_strategies(p), 0.0);
+  }
+  StrategyProfile profile(num_players, 0);
+  do {
+    for (int p = 0; p < num_players; ++p) {
+      double prob = 1.0;
+      for (int o = 0; o < num_players; ++o) {
+        if (o != p) {
+          prob *= mixed.probability(o, profile[o]);
+        }
+      }
+      // Each opponent profile is visited once per own strategy.
+      if (profile[p] == 0) {
+        const vector<int> payoffs = game.payoffs(profile, p);
+        for (size_t s = 0; s < payoffs.size(); ++s) {
+          expected[p][s] += prob * payoffs[s];
+        }
+      }
+    }
+  } while (NextProfile(game, &profile));
+  for (int p = 0; p < num_players; ++p) {
+    double best = expected[p][0];
+    for (int s = 1; s < game.num_strategies(p); ++s) {
+      best = std::max(best, expected[p][s]);
+    }
+    double sum = 0.0;
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      sum += mixed.probability(p, s);
+      if (mixed.probability(p, s) > 1e-9 && expected[p][s] < best - 1e-6) {
+        return false;
+      }
+    }
+    if (sum < 1.0 - 1e-6 || sum > 1.0 + 1e-6) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(PolymatrixReaderTest, Ring) {
+  PolymatrixGame game("");
+  PolymatrixReader reader(&game);
+  ASSERT_TRUE(PolymatrixReader::Detect(kRing.data(),
+                                       kRing.data() + kRing.size()));
+  ASSERT_TRUE(reader.Read(kRing.data(), kRing.data() + kRing.size()))
+      << reader.error();
+  EXPECT_EQ("Ring", game.name());
+  EXPECT_EQ(4, game.num_players());
+  EXPECT_EQ(4, game.num_edges());
+  EXPECT_EQ("L", game.strategy(0, 0));
+  EXPECT_EQ("2", game.strategy(3, 1));
+  StrategyProfile profile(4, 0);
+  profile.strategy(3, 1);
+  EXPECT_EQ(2, game.payoff(profile, 0));
+  EXPECT_EQ(4, game.payoff(profile, 1));
+  EXPECT_EQ(2, game.payoff(profile, 2));
+  EXPECT_EQ(3, game.payoff(profile, 3));
+  vector<StrategyProfile> equilibria;
+  EXPECT_EQ(2, game.FindPure(10, &equilibria));
+  EXPECT_EQ("(0 0 0 1)", equilibria[0].str());
+  EXPECT_EQ("(1 1 1 0)", equilibria[1].str());
+  equilibria.clear();
+  EXPECT_EQ(1, game.FindPure(1, &equilibria));
+}
+
+TEST(PolymatrixReaderTest, Malformed) {
+  const string input = "PMG 1 R \"Bad\" { \"P1\" \"P2\" } { 2 2 }\n"
+                       "{ { 1 2 { 1 0 0 } { 1 0 0 1 } } }";
+  PolymatrixGame game("");
+  PolymatrixReader reader(&game);
+  EXPECT_FALSE(reader.Read(input.data(), input.data() + input.size()));
+  EXPECT_THAT(reader.error(),
+              testing::StartsWith("Expected 4 payoffs per player"));
+  EXPECT_FALSE(PolymatrixReader::Detect(kRing.data() + 4,
+                                        kRing.data() + kRing.size()));
+}
+
+TEST(PolymatrixGameTest, MatchingPennies) {
+  PolymatrixGame game("pennies");
+  game.AddPlayer("p1", {"H", "T"});
+  game.AddPlayer("p2", {"H", "T"});
+  game.AddEdge(0, 1, {1, -1, -1, 1}, {-1, 1, 1, -1});
+  vector<StrategyProfile> equilibria;
+  EXPECT_EQ(0, game.FindPure(10, &equilibria));
+  MixedStrategyProfile mixed(0);
+  ASSERT_TRUE(game.FindMixed(&mixed));
+  EXPECT_FLOAT_EQ(0.5f, mixed.probability(0, 0));
+  EXPECT_FLOAT_EQ(0.5f, mixed.probability(1, 1));
+}
+
+TEST(PolymatrixGameTest, RandomGames) {
+  std::srand(11);
+  for (int i = 0; i < 50; ++i) {
+    const PolymatrixGame game = CreateRandomGame(2 + i % 4, 2 + i % 3, 60);
+    vector<StrategyProfile> equilibria;
+    game.FindPure(1000, &equilibria);
+    const vector<StrategyProfile> expected = BruteForcePure(game);
+    ASSERT_EQ(expected.size(), equilibria.size());
+    vector<string> found;
+    vector<string> expected_str;
+    for (size_t e = 0; e < expected.size(); ++e) {
+      found.push_back(equilibria[e].str());
+      expected_str.push_back(expected[e].str());
+    }
+    EXPECT_THAT(found, testing::UnorderedElementsAreArray(expected_str));
+    MixedStrategyProfile mixed(0);
+    ASSERT_TRUE(game.FindMixed(&mixed));
+    EXPECT_TRUE(IsEquilibrium(game, mixed)) << game.str(mixed);
+  }
+}
@@ -0,0 +1,144 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "../equilibria-finder.h"
+#include "../game.h"
+#include "../polynomial-solver.h"
+#include "../support-enumerator.h"
+
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::PolynomialSolver;
+using ash::ProfileIterator;
+using ash::StrategyProfile;
+using ash::SupportEnumerator;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given numbers of strategies and no payoffs.
+Game CreateGame(const vector<int>& num_strategies) {
+  Game game("game");
+  for (size_t p = 0; p < num_strategies.size(); ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  return game;
+}
+
+// Returns a game with given numbers of strategies and random payoffs from
+// given range.
+Game CreateRandomGame(const vector<int>& num_strategies, const int range) {
+  Game game = CreateGame(num_strategies);
+  vector<vector<int> > payoffs(num_strategies.size(),
+                               vector<int>(game.num_strategy_profiles()));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Returns the maximum gain of a player by deviating from given profile to a
+// pure strategy, relative to the payoff range.
+double MaxGain(const MixedStrategyProfile& profile, const Game& game) {
+  double max_gain = 0.0;
+  double range = 1.0;
+  for (int p = 0; p < game.num_players(); ++p) {
+    vector<double> expected(game.num_strategies(p), 0.0);
+    for (ProfileIterator it(game); !it.done(); it.Next()) {
+      double weight = 1.0;
+      for (int q = 0; q < game.num_players(); ++q) {
+        weight *= q == p ? 1.0 : profile.probability(q, it.profile()[q]);
+      }
+      expected[it.profile()[p]] += weight * game.payoff(it.id(), p);
+      range = std::max(range, std::fabs(game.payoff(it.id(), p)));
+    }
+    double value = 0.0;
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      value += profile.probability(p, s) * expected[s];
+    }
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      max_gain = std::max(max_gain, expected[s] - value);
+    }
+  }
+  return max_gain / range;
+}
+
+TEST(PolynomialSolverTest, Equilibria) {
+  std::srand(25);
+  for (int i = 0; i < 5; ++i) {
+    const Game game = CreateRandomGame({2 + i % 2, 3, 2}, 100000);
+    PolynomialSolver solver(game);
+    int num_eq = 0;
+    for (SupportEnumerator it(game, 1, 3); it.Next();) {
+      vector<MixedStrategyProfile> equilibria;
+      const int num_solved = solver.Solve(it.supports(), &equilibria);
+      ASSERT_EQ(num_solved, static_cast<int>(equilibria.size()));
+      num_eq += num_solved;
+      for (auto jt = equilibria.begin(); jt != equilibria.end(); ++jt) {
+        EXPECT_GT(1e-5, MaxGain(*jt, game));
+        for (int p = 0; p < game.num_players(); ++p) {
+          for (int s = 0; s < game.num_strategies(p); ++s) {
+            const bool supported = it.supports()[p] & (1u << s);
+            EXPECT_EQ(supported, jt->probability(p, s) > 0.0f);
+          }
+        }
+      }
+    }
+    // Generic games have an odd number of equilibria.
+    EXPECT_EQ(1, num_eq % 2);
+    EXPECT_LT(0, solver.num_iterations());
+  }
+}
+
+TEST(PolynomialSolverTest, PureSupports) {
+  std::srand(7);
+  const Game game = CreateRandomGame({3, 3, 3}, 4);
+  EquilibriaFinder finder(game);
+  const int num_pure = finder.FindPure();
+  ASSERT_LT(0, num_pure);
+  PolynomialSolver solver(game);
+  vector<MixedStrategyProfile> equilibria;
+  for (SupportEnumerator it(game, 1, 1); it.Next();) {
+    solver.Solve(it.supports(), &equilibria);
+  }
+  EXPECT_EQ(num_pure, static_cast<int>(equilibria.size()));
+}
+
+TEST(PolynomialSolverTest, MatchingPennies) {
+  // Player 0 matches player 1, player 1 matches player 2 and player 2
+  // mismatches player 0, the only equilibrium is the uniform one.
+  Game game = CreateGame({2, 2, 2});
+  vector<vector<int> > payoffs(3, vector<int>(game.num_strategy_profiles()));
+  for (ProfileIterator it(game); !it.done(); it.Next()) {
+    const StrategyProfile& profile = it.profile();
+    payoffs[0][it.id()] = profile[0] == profile[1];
+    payoffs[1][it.id()] = profile[1] == profile[2];
+    payoffs[2][it.id()] = profile[2] != profile[0];
+  }
+  game.SwapDensePayoffs(&payoffs);
+  PolynomialSolver solver(game);
+  vector<MixedStrategyProfile> equilibria;
+  EXPECT_EQ(1, solver.Solve({3, 3, 3}, &equilibria));
+  ASSERT_EQ(1u, equilibria.size());
+  for (int p = 0; p < 3; ++p) {
+    EXPECT_FLOAT_EQ(0.5f, equilibria[0].probability(p, 0));
+  }
+  EXPECT_EQ(0, solver.Solve({1, 3, 3}, &equilibria));
+  EquilibriaFinder finder(game);
+  finder.specialized(false);
+  EXPECT_EQ(1, finder.FindMixed());
+}
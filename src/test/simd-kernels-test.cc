@@ -0,0 +1,63 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "../simd-kernels.h"
+
+using std::vector;
+
+namespace simd = ash::simd;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+TEST(SimdKernelsTest, LevelsMatchScalar) {
+  std::srand(3);
+  const simd::Level supported = simd::SupportedLevel();
+  // Odd sizes cover the scalar tails of the vector loops.
+  for (int n = 0; n < 70; n += 3) {
+    vector<int> in(n);
+    vector<int> out(n);
+    vector<int> best(n);
+    for (int i = 0; i < n; ++i) {
+      in[i] = std::rand() % 5 - 2;
+      out[i] = std::rand() % 5 - 2;
+      best[i] = std::rand() % 3;
+    }
+    vector<int> max_elements;
+    vector<vector<int> > maxima;
+    vector<vector<int32_t> > masks;
+    for (int l = simd::kScalar; l <= supported; ++l) {
+      simd::SetLevel(static_cast<simd::Level>(l));
+      EXPECT_EQ(l, simd::level());
+      vector<int> max = out;
+      simd::MaxInto(n ? &in[0] : NULL, n, n ? &max[0] : NULL);
+      vector<int32_t> mask(n, -1);
+      simd::ClearUnequal(n ? &best[0] : NULL, n ? &in[0] : NULL, n,
+                         n ? &mask[0] : NULL);
+      simd::ClearUnequal(n ? &out[0] : NULL, 0, n, n ? &mask[0] : NULL);
+      EXPECT_EQ(std::find_if(mask.begin(), mask.end(),
+                             [](const int32_t m) { return m; }) - mask.begin(),
+                simd::NextSet(n ? &mask[0] : NULL, n));
+      if (n) {
+        max_elements.push_back(simd::Max(&in[0], n));
+      }
+      maxima.push_back(max);
+      masks.push_back(mask);
+    }
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(std::max(in[i], out[i]), maxima[0][i]);
+      EXPECT_EQ(best[i] == in[i] && out[i] == 0 ? -1 : 0, masks[0][i]);
+    }
+    for (size_t l = 0; l < max_elements.size(); ++l) {
+      EXPECT_EQ(*std::max_element(in.begin(), in.end()), max_elements[l]);
+    }
+    for (size_t l = 1; l < maxima.size(); ++l) {
+      EXPECT_EQ(maxima[0], maxima[l]);
+      EXPECT_EQ(masks[0], masks[l]);
+    }
+  }
+  simd::SetLevel(supported);
+}
@@ -0,0 +1,79 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <set>
+#include <vector>
+#include "../game.h"
+#include "../support-enumerator.h"
+
+using ash::Game;
+using ash::Player;
+using ash::SupportEnumerator;
+
+using std::set;
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given numbers of strategies and given payoffs.
+Game CreateGame(const vector<int>& num_strategies,
+                vector<vector<int> >* payoffs) {
+  Game game("game");
+  for (size_t p = 0; p < num_strategies.size(); ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  game.SwapDensePayoffs(payoffs);
+  return game;
+}
+
+TEST(SupportEnumeratorTest, Order) {
+  vector<vector<int> > payoffs(2, vector<int>(12, 0));
+  const Game game = CreateGame({3, 4}, &payoffs);
+  set<vector<uint32_t> > visited;
+  vector<int> sizes;
+  for (SupportEnumerator it(game, 1, 4); it.Next();) {
+    EXPECT_TRUE(visited.insert(it.supports()).second);
+    sizes.push_back(__builtin_popcount(it.supports()[0]) * 10 +
+                    __builtin_popcount(it.supports()[1]));
+  }
+  EXPECT_EQ(7u * 15u, visited.size());
+  // Balanced size profiles first, smaller ones first.
+  EXPECT_EQ(11, sizes.front());
+  EXPECT_EQ(14, sizes.back());
+  for (size_t i = 1; i < sizes.size(); ++i) {
+    const int prev = std::abs(sizes[i - 1] / 10 - sizes[i - 1] % 10);
+    const int cur = std::abs(sizes[i] / 10 - sizes[i] % 10);
+    EXPECT_LE(prev, cur);
+  }
+  visited.clear();
+  for (SupportEnumerator it(game, 2, 2); it.Next();) {
+    visited.insert(it.supports());
+  }
+  EXPECT_EQ(3u * 6u, visited.size());
+  EXPECT_FALSE(SupportEnumerator(game, 4, 4).Next());
+}
+
+TEST(SupportEnumeratorTest, ConditionallyDominated) {
+  // Rows (3, 0), (1, 2) and (2, 5) against the two columns, the column
+  // player is indifferent.
+  vector<vector<int> > payoffs = {{3, 1, 2,  0, 2, 5},
+                                  {1, 1, 1,  1, 1, 1}};
+  const Game game = CreateGame({3, 2}, &payoffs);
+  int num_dominated = 0;
+  for (SupportEnumerator it(game, 1, 3); it.Next();) {
+    const uint32_t rows = it.supports()[0];
+    const uint32_t cols = it.supports()[1];
+    // Against column 0 row 0 dominates the others, against column 1 row 2
+    // and against both columns row 2 dominates row 1.
+    const bool dominated = cols == 1u ? rows != 1u :
+                           cols == 2u ? rows != 4u : (rows & 2u) != 0u;
+    EXPECT_EQ(dominated, it.ConditionallyDominated()) << rows << " " << cols;
+    num_dominated += dominated;
+  }
+  EXPECT_LT(0, num_dominated);
+}
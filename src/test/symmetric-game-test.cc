@@ -0,0 +1,171 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#include "../equilibria-finder.h"
+#include "../game.h"
+#include "../symmetric-game.h"
+
+using ash::EquilibriaFinder;
+using ash::Game;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::ProfileIterator;
+using ash::StrategyProfile;
+using ash::SymmetricGame;
+
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a game with given number of players and strategies, in which each
+// player's payoff is given by the symmetric game.
+Game CreateGame(const SymmetricGame& symmetric) {
+  const int num_players = symmetric.num_players();
+  const int num_strategies = symmetric.num_strategies();
+  Game game("symmetric");
+  for (int p = 0; p < num_players; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  vector<vector<int> > payoffs(num_players,
+                               vector<int>(game.num_strategy_profiles()));
+  for (ProfileIterator it(game); !it.done(); it.Next()) {
+    vector<int> counts(num_strategies, 0);
+    for (int p = 0; p < num_players; ++p) {
+      ++counts[it.profile()[p]];
+    }
+    for (int p = 0; p < num_players; ++p) {
+      const int s = it.profile()[p];
+      --counts[s];
+      payoffs[p][it.id()] = symmetric.payoff(s, counts);
+      ++counts[s];
+    }
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Returns a symmetric game with random payoffs.
+SymmetricGame CreateRandomGame(const int num_players,
+                               const int num_strategies) {
+  SymmetricGame symmetric(num_players, num_strategies);
+  for (int s = 0; s < num_strategies; ++s) {
+    vector<int> counts(num_strategies, 0);
+    counts.back() = num_players - 1;
+    do {
+      symmetric.SetPayoff(s, counts, std::rand() % 9 - 4);
+    } while (SymmetricGame::NextCounts(&counts));
+  }
+  return symmetric;
+}
+
+TEST(SymmetricGameTest, CountIds) {
+  const SymmetricGame symmetric(5, 3);
+  EXPECT_EQ(15, symmetric.num_counts());
+  vector<int> counts = {0, 0, 4};
+  int id = 0;
+  do {
+    EXPECT_EQ(id++, symmetric.CountId(counts));
+  } while (SymmetricGame::NextCounts(&counts));
+  EXPECT_EQ(15, id);
+  EXPECT_EQ(vector<int>({4, 0, 0}), counts);
+}
+
+TEST(SymmetricGameTest, Detection) {
+  std::srand(3);
+  const SymmetricGame symmetric = CreateRandomGame(3, 3);
+  SymmetricGame detected(0, 0);
+  ASSERT_TRUE(SymmetricGame::Create(CreateGame(symmetric), &detected));
+  EXPECT_EQ(3, detected.num_players());
+  EXPECT_EQ(symmetric.payoff(1, {1, 0, 1}), detected.payoff(1, {1, 0, 1}));
+  Game game = CreateGame(symmetric);
+  vector<vector<int> > payoffs(3, vector<int>(game.num_strategy_profiles()));
+  for (int p = 0; p < 3; ++p) {
+    for (int64_t sp = 0; sp < game.num_strategy_profiles(); ++sp) {
+      payoffs[p][sp] = game.payoff(sp, p);
+    }
+  }
+  // Player 0 profits more than the others from the first profile.
+  ++payoffs[0][0];
+  game.SwapDensePayoffs(&payoffs);
+  EXPECT_FALSE(SymmetricGame::Create(game, &detected));
+}
+
+TEST(SymmetricGameTest, PureMatchesGenericFinder) {
+  std::srand(7);
+  for (int i = 0; i < 20; ++i) {
+    const Game game = CreateGame(CreateRandomGame(3 + i % 3, 2 + i % 2));
+    EquilibriaFinder finder(game);
+    EquilibriaFinder generic_finder(game);
+    generic_finder.specialized(false);
+    ASSERT_EQ(generic_finder.FindPure(), finder.FindPure());
+    EXPECT_EQ(generic_finder.CountPure(), finder.CountPure());
+    for (size_t e = 0; e < finder.equilibria().size(); ++e) {
+      EXPECT_EQ(generic_finder.equilibria()[e].str(),
+                finder.equilibria()[e].str());
+    }
+    finder.max_num_equilibria(1);
+    EXPECT_EQ(finder.FindPure() > 0, generic_finder.FindPure() > 0);
+  }
+}
+
+TEST(SymmetricGameTest, StreamAndCount) {
+  const size_t kMaxNum = std::numeric_limits<size_t>::max();
+  // Constant payoffs, every one of the 3^30 profiles is an equilibrium.
+  const SymmetricGame symmetric(30, 3);
+  EXPECT_EQ(205891132094649, symmetric.FindPure(kMaxNum, ash::PureVisitor()));
+  EXPECT_EQ(1000, symmetric.FindPure(1000, ash::PureVisitor()));
+  vector<StrategyProfile> visited;
+  EXPECT_EQ(3, symmetric.FindPure(1000, [&visited](const StrategyProfile& p) {
+    visited.push_back(p);
+    return visited.size() < 3;
+  }));
+  ASSERT_EQ(3u, visited.size());
+  EXPECT_EQ(2, visited[2][0]);
+  EXPECT_EQ(0, visited[2][1]);
+  // Strategy 1 pays off only if exactly one other player chooses it, the
+  // equilibria are the 6 profiles with two players choosing it and the one
+  // without.
+  SymmetricGame pairs(4, 2);
+  for (int c = 0; c < 4; ++c) {
+    pairs.SetPayoff(0, {3 - c, c}, 1);
+    pairs.SetPayoff(1, {3 - c, c}, c == 1 ? 2 : 0);
+  }
+  vector<StrategyProfile> pure;
+  EXPECT_EQ(7, pairs.FindPure(kMaxNum, ash::PureVisitor()));
+  ASSERT_EQ(7, pairs.FindPure(100, &pure));
+  for (size_t e = 1; e < pure.size(); ++e) {
+    EXPECT_LT(pure[e - 1][3] * 8 + pure[e - 1][2] * 4 + pure[e - 1][1] * 2 +
+              pure[e - 1][0],
+              pure[e][3] * 8 + pure[e][2] * 4 + pure[e][1] * 2 + pure[e][0]);
+  }
+}
+
+TEST(SymmetricGameTest, SymmetricMixed) {
+  // Three-player volunteer's dilemma: volunteering costs 1, everyone gets 2
+  // if at least one volunteers. The symmetric equilibrium volunteers with
+  // probability 1 - (1/2)^(1/2).
+  SymmetricGame volunteer(3, 2);
+  for (int v = 0; v < 3; ++v) {
+    volunteer.SetPayoff(0, {v, 2 - v}, 1);
+    volunteer.SetPayoff(1, {v, 2 - v}, v ? 2 : 0);
+  }
+  vector<MixedStrategyProfile> equilibria;
+  EXPECT_EQ(1, volunteer.FindMixed(10, &equilibria));
+  EXPECT_NEAR(1.0 - std::sqrt(0.5), equilibria[0].probability(2, 0), 1e-6);
+  vector<double> expected;
+  volunteer.ExpectedPayoffs({1.0 - std::sqrt(0.5), std::sqrt(0.5)},
+                            &expected);
+  EXPECT_NEAR(expected[0], expected[1], 1e-9);
+  vector<StrategyProfile> pure;
+  EXPECT_EQ(3, volunteer.FindPure(10, &pure));
+  EXPECT_EQ("(1 1 0)", pure[0].str());
+}
@@ -0,0 +1,151 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "../bimatrix-game.h"
+#include "../game.h"
+#include "../vertex-enumerator.h"
+
+using ash::BimatrixSolver;
+using ash::Game;
+using ash::MixedStrategyProfile;
+using ash::Player;
+using ash::VertexEnumerator;
+
+using std::set;
+using std::vector;
+
+DEFINE_bool(verbose, false, "Verbose output");
+
+// Returns a two-player game with given numbers of strategies and payoffs per
+// player indexed by profile id.
+Game CreateGame(const int m, const int n, vector<vector<int> > payoffs) {
+  Game game("game");
+  const int num_strategies[] = {m, n};
+  for (int p = 0; p < 2; ++p) {
+    Player player("p");
+    for (int s = 0; s < num_strategies[p]; ++s) {
+      player.AddStrategy(game.AddStrategy("s"));
+    }
+    game.AddPlayer(player);
+  }
+  game.SwapDensePayoffs(&payoffs);
+  return game;
+}
+
+// Returns a two-player game with given numbers of strategies and random
+// payoffs from given range.
+Game CreateRandomGame(const int m, const int n, const int range) {
+  vector<vector<int> > payoffs(2, vector<int>(m * n));
+  for (auto it = payoffs.begin(); it != payoffs.end(); ++it) {
+    for (auto jt = it->begin(); jt != it->end(); ++jt) {
+      *jt = std::rand() % range;
+    }
+  }
+  return CreateGame(m, n, payoffs);
+}
+
+// Returns the probabilities of given profile rounded to 6 digits.
+vector<int> Rounded(const MixedStrategyProfile& profile, const Game& game) {
+  vector<int> probs;
+  for (int p = 0; p < game.num_players(); ++p) {
+    for (int s = 0; s < game.num_strategies(p); ++s) {
+      probs.push_back(std::round(profile.probability(p, s) * 1e6));
+    }
+  }
+  return probs;
+}
+
+// Returns the equilibria of given game found by the vertex enumeration,
+// expects each of them once.
+set<vector<int> > VertexEquilibria(const Game& game, const size_t max_num) {
+  set<vector<int> > equilibria;
+  VertexEnumerator enumerator(game);
+  const int64_t num_eq = enumerator.FindMixed(
+      max_num, [&game, &equilibria](const MixedStrategyProfile& profile) {
+        EXPECT_TRUE(equilibria.insert(Rounded(profile, game)).second);
+        return true;
+      });
+  EXPECT_EQ(int64_t(equilibria.size()), num_eq);
+  return equilibria;
+}
+
+TEST(VertexEnumeratorTest, MatchesBimatrix) {
+  // Random games are nondegenerate, the supports of equal sizes are all
+  // equilibria.
+  std::srand(14);
+  for (int i = 0; i < 10; ++i) {
+    const Game game = CreateRandomGame(3 + i % 4, 4 + i % 3, 100000);
+    vector<MixedStrategyProfile> profiles;
+    BimatrixSolver::FindMixed(game, 1000, &profiles);
+    set<vector<int> > expected;
+    for (auto it = profiles.begin(); it != profiles.end(); ++it) {
+      expected.insert(Rounded(*it, game));
+    }
+    ASSERT_LT(0u, expected.size());
+    EXPECT_EQ(expected, VertexEquilibria(game, 1000));
+    EXPECT_EQ(1u, VertexEquilibria(game, 1).size());
+  }
+}
+
+TEST(VertexEnumeratorTest, Cliques) {
+  // Player 1 is indifferent, each pure strategy of player 1 makes the same
+  // strategy of player 0 a best response and the uniform one makes both.
+  const Game game = CreateGame(2, 2, {{1, 0, 0, 1}, {0, 0, 0, 0}});
+  VertexEnumerator enumerator(game);
+  vector<MixedStrategyProfile> equilibria;
+  EXPECT_EQ(4, enumerator.FindMixed(
+      1000, [&equilibria](const MixedStrategyProfile& profile) {
+        equilibria.push_back(profile);
+        return true;
+      }));
+  // The pure strategies of player 0 each with the pure and uniform
+  // strategies of player 1 and both pure strategies of player 0 with the
+  // uniform strategy, connected by the uniform strategy.
+  const vector<VertexEnumerator::Clique>& cliques = enumerator.cliques();
+  ASSERT_EQ(3u, cliques.size());
+  EXPECT_EQ(1, enumerator.num_components());
+  int num_shared_x = 0;
+  for (auto it = cliques.begin(); it != cliques.end(); ++it) {
+    ASSERT_EQ(2u, it->equilibria.size());
+    EXPECT_EQ(0, it->component);
+    const MixedStrategyProfile& a = equilibria[it->equilibria[0]];
+    const MixedStrategyProfile& b = equilibria[it->equilibria[1]];
+    if (a.probability(0, 0) == b.probability(0, 0)) {
+      ++num_shared_x;
+      EXPECT_NE(a.probability(1, 0), b.probability(1, 0));
+    } else {
+      EXPECT_FLOAT_EQ(0.5f, a.probability(1, 0));
+      EXPECT_FLOAT_EQ(0.5f, b.probability(1, 0));
+    }
+  }
+  EXPECT_EQ(2, num_shared_x);
+}
+
+TEST(VertexEnumeratorTest, Components) {
+  // Battle of the sexes, three isolated equilibria.
+  const Game game = CreateGame(2, 2, {{2, 0, 0, 1}, {1, 0, 0, 2}});
+  VertexEnumerator enumerator(game);
+  EXPECT_EQ(3, enumerator.FindMixed(1000, ash::MixedVisitor()));
+  EXPECT_EQ(3u, enumerator.cliques().size());
+  EXPECT_EQ(3, enumerator.num_components());
+  for (auto it = enumerator.cliques().begin();
+       it != enumerator.cliques().end(); ++it) {
+    EXPECT_EQ(1u, it->equilibria.size());
+  }
+}
+
+TEST(VertexEnumeratorTest, Degenerate) {
+  // Constant payoffs make every profile an equilibrium, the extreme ones are
+  // the pure profiles, which form a single clique.
+  const Game game = CreateGame(3, 4, {vector<int>(12, 7), vector<int>(12, 7)});
+  VertexEnumerator enumerator(game);
+  EXPECT_EQ(12, enumerator.FindMixed(1000, ash::MixedVisitor()));
+  ASSERT_EQ(1u, enumerator.cliques().size());
+  EXPECT_EQ(12u, enumerator.cliques()[0].equilibria.size());
+  EXPECT_LT(12, enumerator.num_bases());
+}
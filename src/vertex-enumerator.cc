@@ -0,0 +1,369 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#include "./vertex-enumerator.h"
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+using std::vector;
+using std::set;
+using std::map;
+using std::pair;
+using std::numeric_limits;
+
+namespace ash {
+
+VertexEnumerator::VertexEnumerator(const Game& game)
+    : m_(game.num_strategies(0)),
+      n_(game.num_players() == 2 ? game.num_strategies(1) : 0),
+      payoffs_(2, vector<int64_t>(game.num_strategy_profiles())),
+      num_components_(0),
+      num_bases_(0) {
+  assert(game.num_players() == 2);
+  for (int p = 0; p < 2; ++p) {
+    // Positive payoffs keep the best response polytopes bounded.
+    int min_payoff = numeric_limits<int>::max();
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      min_payoff = std::min(min_payoff, game.payoff(id, p));
+    }
+    for (int64_t id = 0; id < game.num_strategy_profiles(); ++id) {
+      payoffs_[p][id] = int64_t(game.payoff(id, p)) - min_payoff + 1;
+    }
+  }
+}
+
+int64_t VertexEnumerator::FindMixed(const size_t max_num,
+                                    const MixedVisitor& visitor) {
+  num_bases_ = 0;
+  vector<Vertex> vertices[2];
+  EnumerateVertices(0, &vertices[0]);
+  EnumerateVertices(1, &vertices[1]);
+  const int num_words = vertices[0].empty() ? 0 :
+                        vertices[0].front().labels.size();
+  vector<uint64_t> all_labels(num_words, 0);
+  for (int label = 0; label < num_labels(); ++label) {
+    all_labels[label / 64] |= uint64_t(1) << (label % 64);
+  }
+  vector<pair<int, int> > equilibria;
+  bool stopped = false;
+  for (size_t i = 0; i < vertices[0].size() && !stopped; ++i) {
+    const vector<uint64_t>& x_labels = vertices[0][i].labels;
+    for (size_t j = 0; j < vertices[1].size() && !stopped; ++j) {
+      const vector<uint64_t>& y_labels = vertices[1][j].labels;
+      int w = 0;
+      while (w < num_words && (x_labels[w] | y_labels[w]) == all_labels[w]) {
+        ++w;
+      }
+      if (w < num_words) {
+        continue;
+      }
+      equilibria.push_back(std::make_pair(i, j));
+      stopped = (visitor && !visitor(Equilibrium(vertices[0][i],
+                                                 vertices[1][j]))) ||
+                equilibria.size() >= max_num;
+    }
+  }
+  ComputeCliques(equilibria);
+  return equilibria.size();
+}
+
+VertexEnumerator::Tableau VertexEnumerator::CreateTableau(
+    const int player) const {
+  const int num_cols = num_labels() + 1;
+  // Player 0: B^T x + s = 1, player 1: A y + r = 1.
+  const int num_rows = player == 0 ? n_ : m_;
+  const int num_strategies = player == 0 ? m_ : n_;
+  Tableau tableau;
+  tableau.rows.assign(num_rows, vector<mpz_class>(num_cols, 0));
+  tableau.basis.resize(num_rows);
+  tableau.denominator = 1;
+  for (int r = 0; r < num_rows; ++r) {
+    vector<mpz_class>& row = tableau.rows[r];
+    // The strategies of player 0 and the slacks of player 1 come first.
+    const int slack = player == 0 ? m_ + r : r;
+    const int first_strategy = player == 0 ? 0 : m_;
+    for (int s = 0; s < num_strategies; ++s) {
+      const int64_t id = player == 0 ? s + r * m_ : r + s * m_;
+      row[first_strategy + s] = payoffs_[1 - player][id];
+    }
+    row[slack] = 1;
+    row[num_cols - 1] = 1;
+    tableau.basis[r] = slack;
+  }
+  return tableau;
+}
+
+void VertexEnumerator::EnumerateVertices(const int player,
+                                         vector<Vertex>* vertices) {
+  // A step of the depth-first search, the pivot which reached the basis and
+  // the next pivot to try from it.
+  struct Step {
+    int row;
+    int leaving;
+    int next_label;
+    int next_row;
+  };
+  Tableau tableau = CreateTableau(player);
+  set<vector<int> > bases;
+  set<vector<mpz_class> > known;
+  vector<int> basis(tableau.basis);
+  std::sort(basis.begin(), basis.end());
+  bases.insert(basis);
+  vector<Step> steps(1, Step({-1, -1, 0, 0}));
+  vector<int> rows;
+  Vertex vertex;
+  while (!steps.empty()) {
+    Step& step = steps.back();
+    int pivot_row = -1;
+    for (; step.next_label < num_labels();
+         ++step.next_label, step.next_row = 0) {
+      const int label = step.next_label;
+      if (std::find(tableau.basis.begin(), tableau.basis.end(), label) !=
+          tableau.basis.end()) {
+        continue;
+      }
+      MinRatioRows(tableau, label, &rows);
+      for (; step.next_row < static_cast<int>(rows.size()); ++step.next_row) {
+        // Each basis is reached once, ties of the ratio test lead to
+        // different bases of the same degenerate vertex.
+        basis = tableau.basis;
+        basis[rows[step.next_row]] = label;
+        std::sort(basis.begin(), basis.end());
+        if (bases.insert(basis).second) {
+          pivot_row = rows[step.next_row++];
+          break;
+        }
+      }
+      if (pivot_row != -1) {
+        break;
+      }
+    }
+    if (pivot_row == -1) {
+      // Backtracks, pivoting back restores the previous tableau exactly.
+      if (step.row != -1) {
+        Pivot(step.row, step.leaving, &tableau);
+      }
+      steps.pop_back();
+      continue;
+    }
+    const int leaving = tableau.basis[pivot_row];
+    Pivot(pivot_row, step.next_label, &tableau);
+    steps.push_back(Step({pivot_row, leaving, 0, 0}));
+    if (CurrentVertex(tableau, player, &vertex) &&
+        known.insert(vertex.coordinates).second) {
+      vertices->push_back(vertex);
+    }
+  }
+  num_bases_ += bases.size();
+}
+
+bool VertexEnumerator::CurrentVertex(const Tableau& tableau, const int player,
+                                     Vertex* vertex) const {
+  const int rhs = num_labels();
+  const int first = player == 0 ? 0 : m_;
+  const int num = player == 0 ? m_ : n_;
+  vertex->coordinates.assign(num, 0);
+  // All labels are zero except the ones of the positive basic variables.
+  vertex->labels.assign((num_labels() + 63) / 64, 0);
+  for (int label = 0; label < num_labels(); ++label) {
+    vertex->labels[label / 64] |= uint64_t(1) << (label % 64);
+  }
+  mpz_class gcd = 0;
+  for (size_t r = 0; r < tableau.basis.size(); ++r) {
+    const int label = tableau.basis[r];
+    const mpz_class& value = tableau.rows[r][rhs];
+    if (value == 0) {
+      continue;
+    }
+    vertex->labels[label / 64] &= ~(uint64_t(1) << (label % 64));
+    if (label >= first && label < first + num) {
+      vertex->coordinates[label - first] = value;
+      mpz_gcd(gcd.get_mpz_t(), gcd.get_mpz_t(), value.get_mpz_t());
+    }
+  }
+  if (gcd == 0) {
+    return false;
+  }
+  for (auto it = vertex->coordinates.begin(); it != vertex->coordinates.end();
+       ++it) {
+    mpz_divexact(it->get_mpz_t(), it->get_mpz_t(), gcd.get_mpz_t());
+  }
+  return true;
+}
+
+void VertexEnumerator::MinRatioRows(const Tableau& tableau, const int label,
+                                    vector<int>* rows) const {
+  const int rhs = num_labels();
+  rows->clear();
+  for (int r = 0; r < static_cast<int>(tableau.rows.size()); ++r) {
+    const vector<mpz_class>& row = tableau.rows[r];
+    if (row[label] <= 0) {
+      continue;
+    }
+    if (rows->empty()) {
+      rows->push_back(r);
+      continue;
+    }
+    // Compares the ratios of the right-hand sides to the entering column.
+    const vector<mpz_class>& best = tableau.rows[rows->front()];
+    const int order = cmp(row[rhs] * best[label], best[rhs] * row[label]);
+    if (order < 0) {
+      rows->clear();
+    }
+    if (order <= 0) {
+      rows->push_back(r);
+    }
+  }
+  // The polytopes are bounded, each column has a positive entry.
+  assert(!rows->empty());
+}
+
+void VertexEnumerator::Pivot(const int row, const int label,
+                             Tableau* tableau) {
+  vector<vector<mpz_class> >& rows = tableau->rows;
+  const vector<mpz_class>& pivot_row = rows[row];
+  const mpz_class pivot = pivot_row[label];
+  const int num_cols = pivot_row.size();
+  mpz_class value;
+  for (int i = 0; i < static_cast<int>(rows.size()); ++i) {
+    if (i == row) {
+      continue;
+    }
+    const mpz_class factor = rows[i][label];
+    for (int j = 0; j < num_cols; ++j) {
+      // Exact division by the previous pivot (Bareiss), in place without
+      // temporaries. Zero entries stay zero in the zero columns of the pivot
+      // row.
+      const mpz_ptr entry = rows[i][j].get_mpz_t();
+      if (mpz_sgn(entry) == 0 && pivot_row[j] == 0) {
+        continue;
+      }
+      mpz_mul(value.get_mpz_t(), entry, pivot.get_mpz_t());
+      mpz_submul(value.get_mpz_t(), factor.get_mpz_t(),
+                 pivot_row[j].get_mpz_t());
+      mpz_divexact(entry, value.get_mpz_t(), tableau->denominator.get_mpz_t());
+    }
+  }
+  tableau->denominator = pivot;
+  tableau->basis[row] = label;
+}
+
+void VertexEnumerator::ComputeCliques(
+    const vector<pair<int, int> >& equilibria) {
+  cliques_.clear();
+  num_components_ = 0;
+  // The equilibrium vertices of player 1 of each vertex of player 0, sorted.
+  map<int, vector<int> > neighbours;
+  map<pair<int, int>, int> indices;
+  for (size_t e = 0; e < equilibria.size(); ++e) {
+    neighbours[equilibria[e].first].push_back(equilibria[e].second);
+    indices[equilibria[e]] = e;
+  }
+  // The vertex sets of player 1 of the maximal cliques are the non-empty
+  // intersections of neighbourhoods.
+  set<vector<int> > closed;
+  for (auto it = neighbours.begin(); it != neighbours.end(); ++it) {
+    vector<vector<int> > added(1, it->second);
+    for (auto jt = closed.begin(); jt != closed.end(); ++jt) {
+      vector<int> intersection;
+      std::set_intersection(jt->begin(), jt->end(), it->second.begin(),
+                            it->second.end(), std::back_inserter(intersection));
+      if (!intersection.empty()) {
+        added.push_back(intersection);
+      }
+    }
+    closed.insert(added.begin(), added.end());
+  }
+  for (auto it = closed.begin(); it != closed.end(); ++it) {
+    Clique clique;
+    for (auto jt = neighbours.begin(); jt != neighbours.end(); ++jt) {
+      if (std::includes(jt->second.begin(), jt->second.end(), it->begin(),
+                        it->end())) {
+        for (auto kt = it->begin(); kt != it->end(); ++kt) {
+          clique.equilibria.push_back(indices[std::make_pair(jt->first, *kt)]);
+        }
+      }
+    }
+    std::sort(clique.equilibria.begin(), clique.equilibria.end());
+    cliques_.push_back(clique);
+  }
+  std::sort(cliques_.begin(), cliques_.end(),
+            [](const Clique& a, const Clique& b) {
+              return a.equilibria < b.equilibria;
+            });
+  // Equilibria sharing a vertex are connected, the vertices of player 1
+  // follow the ones of player 0 in the union-find forest.
+  const int offset = neighbours.empty() ? 0 : neighbours.rbegin()->first + 1;
+  vector<int> parents;
+  for (size_t e = 0; e < equilibria.size(); ++e) {
+    const int vertices[] = {equilibria[e].first,
+                            offset + equilibria[e].second};
+    int roots[2];
+    for (int v = 0; v < 2; ++v) {
+      if (vertices[v] >= static_cast<int>(parents.size())) {
+        const int size = parents.size();
+        parents.resize(vertices[v] + 1);
+        for (int i = size; i <= vertices[v]; ++i) {
+          parents[i] = i;
+        }
+      }
+      roots[v] = vertices[v];
+      while (parents[roots[v]] != roots[v]) {
+        roots[v] = parents[roots[v]] = parents[parents[roots[v]]];
+      }
+    }
+    parents[roots[1]] = roots[0];
+  }
+  // The components are numbered in the order of their first clique.
+  map<int, int> components;
+  for (auto it = cliques_.begin(); it != cliques_.end(); ++it) {
+    int root = equilibria[it->equilibria.front()].first;
+    while (parents[root] != root) {
+      root = parents[root];
+    }
+    if (components.find(root) == components.end()) {
+      components[root] = num_components_++;
+    }
+    it->component = components[root];
+  }
+}
+
+MixedStrategyProfile VertexEnumerator::Equilibrium(const Vertex& x,
+                                                   const Vertex& y) const {
+  MixedStrategyProfile profile(2);
+  const Vertex* vertices[] = {&x, &y};
+  for (int p = 0; p < 2; ++p) {
+    const vector<mpz_class>& w = vertices[p]->coordinates;
+    profile.SetNumStrategies(p, w.size());
+    mpz_class sum = 0;
+    for (auto it = w.begin(); it != w.end(); ++it) {
+      sum += *it;
+    }
+    for (size_t s = 0; s < w.size(); ++s) {
+      profile.AddProbability(p, s, mpq_class(w[s], sum).get_d());
+    }
+  }
+  return profile;
+}
+
+const vector<VertexEnumerator::Clique>& VertexEnumerator::cliques() const {
+  return cliques_;
+}
+
+int VertexEnumerator::num_components() const {
+  return num_components_;
+}
+
+int64_t VertexEnumerator::num_bases() const {
+  return num_bases_;
+}
+
+int VertexEnumerator::num_labels() const {
+  return m_ + n_;
+}
+
+}  // namespace ash
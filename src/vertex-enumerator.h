@@ -0,0 +1,101 @@
+// Copyright 2012 Eugen Sawin <esawin@me73.com>
+#ifndef SRC_VERTEX_ENUMERATOR_H_
+#define SRC_VERTEX_ENUMERATOR_H_
+
+#include <gmpxx.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "./game.h"
+
+namespace ash {
+
+// Enumerates all extreme equilibria of two-player games on the vertices of the
+// best response polytopes P = {x >= 0 : B^T x <= 1} and Q = {y >= 0 : A y <= 1}
+// of the positively shifted payoffs. The vertices of each polytope are found by
+// a depth-first search over its feasible bases, which pivots exactly on
+// integer tableaux of arbitrary precision (Bareiss) and visits each basis once,
+// so degenerate vertices are reached as well. A pair of vertices is an extreme
+// equilibrium if it is completely labeled. Labels 0 to m - 1 are the
+// strategies of player 0 and labels m to m + n - 1 the strategies of player 1.
+//
+// The extreme equilibria are grouped into maximal cliques, pairs of vertex
+// sets of both players, in which each combination is an equilibrium. The
+// convex hull of each clique consists of equilibria and the cliques sharing
+// vertices form the connected components of the equilibria (Avis, Rosenberg,
+// Savani and von Stengel).
+class VertexEnumerator {
+ public:
+  // Maximal clique of the extreme equilibria, given by the indices of its
+  // equilibria in visiting order.
+  struct Clique {
+    std::vector<int> equilibria;
+    // The index of its connected component, in order of the first clique.
+    int component;
+  };
+
+  explicit VertexEnumerator(const Game& game);
+  // Enumerates the vertices of both polytopes and visits the extreme
+  // equilibria ordered by the vertices of player 0, until given number is
+  // reached or the visitor stops. Computes the cliques of the visited
+  // equilibria. Returns the number of visited equilibria.
+  int64_t FindMixed(const size_t max_num, const MixedVisitor& visitor);
+  // Returns the maximal cliques of the last call of FindMixed.
+  const std::vector<Clique>& cliques() const;
+  int num_components() const;
+  // Returns the number of visited bases of the last call of FindMixed.
+  int64_t num_bases() const;
+  int num_labels() const;
+
+ private:
+  // Tableau of the constraints of one player's best response polytope, with
+  // one column per label and the right-hand side in the last column.
+  struct Tableau {
+    std::vector<std::vector<mpz_class> > rows;
+    // The label of the basic variable of each row.
+    std::vector<int> basis;
+    // The previous pivot element, the common denominator of all entries.
+    mpz_class denominator;
+  };
+
+  // Vertex of a best response polytope.
+  struct Vertex {
+    // The coordinates reduced by their greatest common divisor.
+    std::vector<mpz_class> coordinates;
+    // Bit set of the labels, the zero variables.
+    std::vector<uint64_t> labels;
+  };
+
+  // Returns the tableau of the polytope of given player's strategies at its
+  // origin, the slacks are basic.
+  Tableau CreateTableau(const int player) const;
+  // Appends the vertices except the origin of the polytope of given player's
+  // strategies, in depth-first order.
+  void EnumerateVertices(const int player, std::vector<Vertex>* vertices);
+  // Sets the vertex of the current basis of given player's polytope. Returns
+  // false for the origin.
+  bool CurrentVertex(const Tableau& tableau, const int player,
+                     Vertex* vertex) const;
+  // Sets the rows of the minimum ratio test for given entering label.
+  void MinRatioRows(const Tableau& tableau, const int label,
+                    std::vector<int>* rows) const;
+  // Pivots the variable of given label into the basis at given row.
+  static void Pivot(const int row, const int label, Tableau* tableau);
+  // Computes the maximal cliques and their components of given equilibria,
+  // which are pairs of vertex indices.
+  void ComputeCliques(const std::vector<std::pair<int, int> >& equilibria);
+  // Returns the mixed strategy profile of given vertices.
+  MixedStrategyProfile Equilibrium(const Vertex& x, const Vertex& y) const;
+
+  // Numbers of strategies of player 0 and player 1.
+  int m_;
+  int n_;
+  // Payoffs per player indexed by profile id, shifted to be positive.
+  std::vector<std::vector<int64_t> > payoffs_;
+  std::vector<Clique> cliques_;
+  int num_components_;
+  int64_t num_bases_;
+};
+
+}  // namespace ash
+#endif  // SRC_VERTEX_ENUMERATOR_H_